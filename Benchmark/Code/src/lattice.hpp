@@ -0,0 +1,691 @@
+/// @file     lattice.hpp
+/// @brief    Procedural lattices for the headless benchmark.
+///
+/// @details  Each example is rebuilt on a structured lattice of arbitrary size, with the same
+/// kernel argument layout as its interactive version (layout index = argument index): no mesh
+/// file is needed, so the problem size can be scaled freely and every run is reproducible. The
+/// neighbour lists follow the Neutrino CSR convention: for the i-th node, its links are
+/// [offset[i - 1], offset[i]) in "nearest" (the neighbour), the central node being implicit; the
+/// neighbour indices are then packed as in the interactive examples (see topology.hpp). On request,
+/// the links are laid out as sliced ELLPACK instead (see sell.hpp), and CSR lattices can run the
+/// work-group tiled force kernel (see tiling.hpp). As in the examples, the node state is stored at
+/// the chosen precision (see nodestate.hpp) and position [1] is its float4 plotted copy.
+
+#ifndef lattice_hpp
+#define lattice_hpp
+
+// INCLUDES:
+#include "clhost.hpp"                                                                               // Raw OpenCL host context.
+#include "topology.hpp"                                                                             // Neighbour list encoding.
+#include "sell.hpp"                                                                                 // Sliced ELLPACK neighbour layout.
+#include "precision.hpp"                                                                            // Compile-time precision.
+#include "tiling.hpp"                                                                               // Regular grid tiling.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#define TILE_LOCAL 256                                                                              // Largest tiled local size [#].
+
+namespace ex
+{
+/// @class problem
+/// @brief Kernel arguments and kernel sources of one benchmark problem.
+class problem
+{
+public:
+  std::string                             name;                                                     ///< Problem name.
+  std::string                             topology;                                                 ///< Neighbour index encoding.
+  std::string                             layout;                                                   ///< Neighbour layout.
+  std::string                             tiling;                                                   ///< Force kernel tiling ("off" or grid size).
+  std::vector<std::vector<unsigned char> > argument;                                                ///< Kernel arguments (by layout index).
+  std::vector<std::vector<std::string> >   init;                                                    ///< Initialization kernels (source files).
+  std::vector<std::vector<std::string> >   step;                                                    ///< Step kernels (source files).
+  std::vector<bool>                        collision;                                               ///< Self-collision flag of each step kernel.
+  std::string                              options;                                                 ///< Step kernels build options.
+  std::string                              defines;                                                 ///< Layout build options (all kernels).
+  size_t                                   nodes;                                                   ///< Number of nodes (global size).
+  size_t                                   links;                                                   ///< Number of links.
+  size_t                                   slots;                                                   ///< Number of link slots (links and padding).
+  size_t                                   state;                                                   ///< Layout index of the position node state.
+  double                                   bytes_node;                                              ///< Memory traffic per node and step [B].
+  double                                   bytes_link;                                              ///< Memory traffic per link and step [B].
+
+  /// @brief **Argument adder.**
+  /// @details Appends a copy of loc_data as the next kernel argument.
+  template <class T>
+  void add (
+            const std::vector<T>& loc_data                                                          ///< Argument data.
+           )
+  {
+    std::vector<unsigned char> bytes (loc_data.size ()*sizeof (T));                                 // Argument bytes.
+
+    std::memcpy (bytes.data (), loc_data.data (), bytes.size ());                                   // Copying data...
+    argument.push_back (bytes);                                                                     // Adding argument...
+  }
+
+  /// @brief **Node state adder.**
+  /// @details Appends a copy of loc_data as the next kernel argument, stored as double4 if
+  /// loc_double and as float4 otherwise (see precision.hpp).
+  void add (
+            const std::vector<cl_float4>& loc_data,                                                 ///< Node state data.
+            bool                          loc_double                                                ///< Double storage flag.
+           )
+  {
+    if(loc_double)
+    {
+      add (precision::convert<cl_double> (loc_data));                                               // Adding double state...
+    }
+    else
+    {
+      add (loc_data);                                                                               // Adding float state...
+    }
+  }
+};
+
+/// @struct lattice
+/// @brief Structured lattice with its CSR neighbour lists.
+struct lattice
+{
+  std::vector<cl_float4> position;                                                                  ///< Node positions [m].
+  std::vector<cl_int>    nearest;                                                                   ///< Neighbour node of each link.
+  std::vector<cl_int>    offset;                                                                    ///< End of each node stride.
+  std::vector<cl_float>  resting;                                                                   ///< Resting length of each link [m].
+  std::vector<cl_int>    freedom;                                                                   ///< Freedom flag of each node.
+  std::vector<cl_int>    tile_node;                                                                 ///< Node of each grid cell (tiling).
+  std::vector<cl_int>    tile_code;                                                                 ///< Packed stencil codes (tiling).
+
+  /// @brief **Class constructor.**
+  /// @details Builds a nx*ny*nz lattice spanning [-1, 1] in each used direction, in which every
+  /// node is linked to all the nodes of its 3x3(x3) neighbourhood (8 links in 2D, 26 in 3D).
+  /// Triangle lattices (2D only) drop one diagonal of each square (6 links). Nodes on the outer
+  /// boundary are fixed (freedom = 0).
+  lattice (
+           size_t loc_nx,                                                                           ///< Number of nodes along "x".
+           size_t loc_ny,                                                                           ///< Number of nodes along "y".
+           size_t loc_nz,                                                                           ///< Number of nodes along "z" (1 = 2D).
+           bool   loc_triangles                                                                     ///< Triangle lattice flag.
+          );
+
+  /// @brief **Class constructor.**
+  /// @details Reads a Gmsh mesh (MSH 4.1 ASCII) and links the nodes along the edges of its
+  /// highest dimension elements (triangles, quadrangles, tetrahedra or hexahedra). The nodes are
+  /// numbered in file order and are all free. Exits with an error if the file cannot be read or
+  /// is not MSH 4.1 ASCII.
+  lattice (
+           std::string loc_file                                                                     ///< Mesh file.
+          );
+};
+
+inline lattice::lattice (
+                         size_t loc_nx,
+                         size_t loc_ny,
+                         size_t loc_nz,
+                         bool   loc_triangles
+                        )
+{
+  long  x, y, z;                                                                                    // Node indices.
+  long  a, b, c;                                                                                    // Neighbour offsets.
+  long  nx = loc_nx, ny = loc_ny, nz = loc_nz;                                                      // Lattice sizes.
+  float ds = 2.0f/(std::max (nx, std::max (ny, nz)) - 1);                                           // Lattice spacing [m].
+  bool  border;                                                                                     // Border flag.
+
+  for(z = 0; z < nz; z++)
+  {
+    for(y = 0; y < ny; y++)
+    {
+      for(x = 0; x < nx; x++)
+      {
+        position.push_back ({{-1.0f + x*ds, -1.0f + y*ds, (nz > 1) ? -1.0f + z*ds : 0.0f, 1.0f}});  // Setting position...
+        border = (x == 0) || (x == nx - 1) || (y == 0) || (y == ny - 1) ||
+                 ((nz > 1) && ((z == 0) || (z == nz - 1)));                                         // Checking border...
+        freedom.push_back (border ? 0 : 1);                                                         // Setting freedom flag...
+
+        for(c = -1; c <= 1; c++)
+        {
+          for(b = -1; b <= 1; b++)
+          {
+            for(a = -1; a <= 1; a++)
+            {
+              if(((a == 0) && (b == 0) && (c == 0)) ||
+                 (x + a < 0) || (x + a >= nx) || (y + b < 0) || (y + b >= ny) ||
+                 (z + c < 0) || (z + c >= nz) || (loc_triangles && (a*b == -1)))
+              {
+                continue;                                                                           // Skipping self, outside and cut diagonal...
+              }
+
+              nearest.push_back ((cl_int)(((z + c)*ny + (y + b))*nx + (x + a)));                    // Setting neighbour node...
+              resting.push_back (ds*std::sqrt (float (a*a + b*b + c*c)));                           // Setting resting length...
+            }
+          }
+        }
+
+        offset.push_back ((cl_int)nearest.size ());                                                 // Setting stride end...
+      }
+    }
+  }
+}
+
+inline lattice::lattice (
+                         std::string loc_file
+                        )
+{
+  std::ifstream                    input (loc_file);                                                // Mesh file.
+  std::string                      token;                                                           // File token.
+  std::map<size_t, cl_int>         index;                                                           // Node index of each node tag.
+  std::vector<std::vector<cl_int> > link;                                                           // Neighbours of each node.
+  std::vector<std::vector<cl_int> > element;                                                        // Nodes of each element.
+  std::vector<std::vector<int> >    edge;                                                           // Element edges (local node pairs).
+  double                           version = 0.0;                                                   // File format version.
+  int                              binary  = 1;                                                     // Binary file flag.
+  int                              top     = 0;                                                     // Highest element dimension.
+  size_t                           blocks, n, tag, k;                                               // Block sizes and node tag.
+  int                              dim, type, parametric, nodes;                                    // Block header.
+  float                            x[3], d;                                                         // Node coordinates [m].
+  double                           skip;                                                            // Parametric coordinate.
+
+  while((input >> token) && (token != "$MeshFormat"));                                              // Finding format section...
+  input >> version >> binary;                                                                       // Reading format...
+
+  if(!input || (version != 4.1) || (binary != 0))
+  {
+    std::cout << "Error: \"" << loc_file << "\" is not a MSH 4.1 ASCII mesh." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  // READING NODES:
+  while((input >> token) && (token != "$Nodes"));                                                   // Finding node section...
+  input >> blocks >> n >> tag >> tag;                                                               // Reading node section header...
+
+  for(size_t b = 0; input && (b < blocks); b++)
+  {
+    input >> dim >> tag >> parametric >> n;                                                         // Reading node block header...
+
+    for(size_t i = 0; i < n; i++)
+    {
+      input >> tag;                                                                                 // Reading node tag...
+      index[tag] = cl_int (position.size () + i);                                                   // Numbering node...
+    }
+
+    for(size_t i = 0; i < n; i++)
+    {
+      input >> x[0] >> x[1] >> x[2];                                                                // Reading node coordinates...
+      position.push_back ({{x[0], x[1], x[2], 1.0f}});                                              // Setting position...
+      freedom.push_back (1);                                                                        // Setting freedom flag...
+
+      for(int p = 0; p < parametric*dim; p++)
+      {
+        input >> skip;                                                                              // Skipping parametric coordinates...
+      }
+    }
+  }
+
+  // READING ELEMENTS (highest dimension only):
+  while((input >> token) && (token != "$Elements"));                                                // Finding element section...
+  input >> blocks >> n >> tag >> tag;                                                               // Reading element section header...
+
+  for(size_t b = 0; input && (b < blocks); b++)
+  {
+    input >> dim >> tag >> type >> n;                                                               // Reading element block header...
+
+    switch(type)
+    {
+      case 1:  nodes = 2; break;                                                                    // Line.
+      case 2:  nodes = 3; break;                                                                    // Triangle.
+      case 3:  nodes = 4; break;                                                                    // Quadrangle.
+      case 4:  nodes = 4; break;                                                                    // Tetrahedron.
+      case 5:  nodes = 8; break;                                                                    // Hexahedron.
+      case 15: nodes = 1; break;                                                                    // Point.
+      default:
+        std::cout << "Error: unsupported element type " << type << " in \"" << loc_file << "\"." << std::endl;
+        std::exit (EXIT_FAILURE);                                                                   // Exiting...
+    }
+
+    if((type >= 2) && (type <= 5) && (dim > top))
+    {
+      top = dim;                                                                                    // Setting highest dimension...
+      element.clear ();                                                                             // Dropping lower dimension elements...
+
+      switch(type)
+      {
+        case 2:  edge = {{0, 1}, {1, 2}, {2, 0}}; break;                                            // Triangle edges.
+        case 3:  edge = {{0, 1}, {1, 2}, {2, 3}, {3, 0}}; break;                                    // Quadrangle edges.
+        case 4:  edge = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}}; break;                    // Tetrahedron edges.
+        default: edge = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4},
+                         {0, 4}, {1, 5}, {2, 6}, {3, 7}}; break;                                    // Hexahedron edges.
+      }
+    }
+
+    for(size_t i = 0; i < n; i++)
+    {
+      input >> tag;                                                                                 // Reading element tag...
+      element.push_back (std::vector<cl_int> (nodes));                                              // Adding element...
+
+      for(int j = 0; j < nodes; j++)
+      {
+        input >> k;                                                                                 // Reading node tag...
+        element.back ()[j] = index.count (k) ? index[k] : -1;                                       // Setting node index...
+      }
+
+      if((type < 2) || (type > 5) || (dim != top))
+      {
+        element.pop_back ();                                                                        // Skipping lower dimension element...
+      }
+    }
+  }
+
+  if(!input || (top == 0))
+  {
+    std::cout << "Error: no triangle, quadrangle, tetrahedron or hexahedron in \"" << loc_file << "\"." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  // LINKING NODES (each edge once, in both directions):
+  link.resize (position.size ());                                                                   // Setting neighbour lists...
+
+  for(const std::vector<cl_int>& e : element)
+  {
+    for(const std::vector<int>& s : edge)
+    {
+      cl_int a = e[s[0]], b = e[s[1]];                                                              // Edge nodes.
+
+      if((a < 0) || (b < 0))
+      {
+        std::cout << "Error: element node not listed in \"" << loc_file << "\"." << std::endl;
+        std::exit (EXIT_FAILURE);                                                                   // Exiting...
+      }
+
+      if((a != b) && (std::find (link[a].begin (), link[a].end (), b) == link[a].end ()))
+      {
+        link[a].push_back (b);                                                                      // Linking a to b...
+        link[b].push_back (a);                                                                      // Linking b to a...
+      }
+    }
+  }
+
+  for(size_t i = 0; i < link.size (); i++)
+  {
+    std::sort (link[i].begin (), link[i].end ());                                                   // Sorting neighbours...
+
+    for(cl_int j : link[i])
+    {
+      d = 0.0f;                                                                                     // Resetting squared length...
+
+      for(int c = 0; c < 3; c++)
+      {
+        d += (position[j].s[c] - position[i].s[c])*(position[j].s[c] - position[i].s[c]);           // Accumulating squared length...
+      }
+
+      nearest.push_back (j);                                                                        // Setting neighbour node...
+      resting.push_back (std::sqrt (d));                                                            // Setting resting length...
+    }
+
+    offset.push_back ((cl_int)nearest.size ());                                                     // Setting stride end...
+  }
+}
+
+/// @brief **Neighbour layout.**
+/// @details Keeps the CSR layout (loc_slice = 0) or lays out the links as sliced ELLPACK, with
+/// slices of loc_slice nodes sorted by degree within windows of loc_sigma nodes: the nodes are
+/// then renumbered, and every kernel is built with "-DSELL=<loc_slice>" (see sell.hpp).
+inline void arrange (
+                     problem& loc_p,                                                                ///< Benchmark problem.
+                     lattice& loc_l,                                                                ///< Lattice.
+                     size_t   loc_slice,                                                            ///< Slice height (0 = CSR) [#].
+                     size_t   loc_sigma                                                             ///< Sorting window [#].
+                    )
+{
+  loc_p.layout = "csr";                                                                             // Setting CSR layout...
+  loc_p.slots  = loc_l.nearest.size ();                                                             // Setting link slots...
+
+  if(loc_slice > 0)
+  {
+    sell s (loc_slice, loc_sigma, loc_l.offset);                                                    // Sliced ELLPACK layout.
+
+    s.nodes (loc_l.position);                                                                       // Renumbering positions...
+    s.nodes (loc_l.freedom);                                                                        // Renumbering freedom flags...
+    s.edges (loc_l.resting);                                                                        // Laying out resting lengths...
+    s.relabel (loc_l.nearest);                                                                      // Laying out neighbours...
+    loc_l.offset  = s.offset;                                                                       // Setting slice table...
+    loc_p.layout  = s.name ();                                                                      // Setting layout name...
+    loc_p.slots   = s.slot.size ();                                                                 // Setting link slots...
+    loc_p.defines = " -DSELL=" + std::to_string (loc_slice);                                        // Setting layout defines...
+  }
+}
+
+/// @brief **Force kernel tiling.**
+/// @details With loc_tiling and the CSR layout, sets the grid cells and the packed stencil codes of
+/// the lattice (already in grid order) and the tiling defines of the force kernel, for positions
+/// of loc_bytes: each link then reads a 1-byte stencil code and a local position instead of a
+/// neighbour index (loc_index bytes) and a global position, while each node reads its cell and its
+/// share of the tile halo. Sets one-element placeholders otherwise.
+inline void tile (
+                  problem& loc_p,                                                                   ///< Benchmark problem.
+                  lattice& loc_l,                                                                   ///< Lattice (not encoded yet).
+                  bool     loc_tiling,                                                              ///< Tiling flag.
+                  size_t   loc_bytes,                                                               ///< Position size [B].
+                  size_t   loc_index                                                                ///< Neighbour index size [B].
+                 )
+{
+  loc_l.tile_node = {0};                                                                            // Setting cell placeholder...
+  loc_l.tile_code = {0};                                                                            // Setting stencil placeholder...
+  loc_p.tiling    = "off";                                                                          // Resetting tiling...
+
+  if(!loc_tiling || (loc_p.layout != "csr"))
+  {
+    return;
+  }
+
+  tiling g (loc_l.position, loc_l.nearest, loc_l.offset);                                           // Lattice grid.
+
+  if(!g.fits (TILE_LOCAL, loc_bytes))
+  {
+    return;
+  }
+
+  loc_l.tile_node   = g.node;                                                                       // Setting grid cells...
+  loc_l.tile_code   = g.pack ();                                                                    // Setting stencil codes...
+  loc_p.tiling      = std::to_string (g.nx) + "x" + std::to_string (g.ny) + "x" + std::to_string (g.nz);
+  loc_p.bytes_node += 4.0 + 2.0*g.halo*loc_bytes/TILE_LOCAL;                                        // Adding cell and halo traffic...
+  loc_p.bytes_link -= loc_bytes + loc_index - 1.0;                                                  // Replacing neighbour reads by a stencil code...
+  loc_p.defines    += " -DTILE=1 -DTILE_X=" + std::to_string (g.nx) + " -DTILE_Y=" + std::to_string (g.ny) +
+                      " -DTILE_HALO=" + std::to_string (g.halo) + " -DTILE_LOCAL=" +
+                      std::to_string (TILE_LOCAL) + " -DTILE_SPAN=" + std::to_string (g.span (TILE_LOCAL)) +
+                      " -DTILE_CELLS=" + std::to_string (loc_p.nodes);                              // Setting tiling defines...
+}
+
+/// @brief **Sinusoid problem.**
+/// @details Position-only sine sheet (sine_kernel.cl), initialized by init_kernel.cl, with the
+/// position stored with the precision of loc_fp (see precision.hpp).
+inline problem sinusoid (
+                         size_t      loc_nx,                                                        ///< Number of nodes along "x".
+                         size_t      loc_ny,                                                        ///< Number of nodes along "y".
+                         std::string loc_home,                                                      ///< Kernel directory.
+                         precision&  loc_fp                                                         ///< Precision.
+                        )
+{
+  problem p;                                                                                        // Problem.
+  float   dx = (loc_nx > 1) ? 2.0f/(loc_nx - 1) : 0.0f;                                             // "x" spacing [m].
+  float   dy = (loc_ny > 1) ? 2.0f/(loc_ny - 1) : 0.0f;                                             // "y" spacing [m].
+
+  p.name       = "sinusoid";                                                                        // Setting name...
+  p.nodes      = loc_nx*loc_ny;                                                                     // Setting number of nodes...
+  p.links      = 0;                                                                                 // Setting number of links...
+  p.slots      = 0;                                                                                 // Setting link slots...
+  p.layout     = "none";                                                                            // Setting neighbour layout (no links)...
+  p.bytes_node = loc_fp.position ? 80.0 : 48.0;                                                     // Setting node traffic (position, plotted copy)...
+  p.bytes_link = 0.0;                                                                               // Setting link traffic (no links)...
+  p.defines    = loc_fp.defines ();                                                                 // Setting precision defines...
+  p.add (std::vector<cl_float4> (p.nodes));                                                         // [0] Color.
+  p.add (std::vector<cl_float4> (p.nodes));                                                         // [1] Position (plotted copy).
+  p.add (std::vector<cl_float> {0.0f, 0.0f});                                                       // [2] Time (high and low parts).
+  p.add (std::vector<cl_float> {-1.0f, -1.0f, dx, dy});                                             // [3] Grid.
+  p.add (std::vector<cl_int> {cl_int (loc_nx), 0});                                                 // [4] Grid index (nodes_x, seed).
+  p.add (std::vector<cl_float4> (p.nodes), loc_fp.position);                                        // [5] Position (node state).
+  p.state     = 5;                                                                                  // Setting position node state...
+  p.init      = {{loc_home + "precision.cl", loc_home + "init_kernel.cl"}};                         // Setting initialization kernel...
+  p.step      = {{loc_home + "precision.cl", loc_home + "sine_kernel.cl"}};                         // Setting step kernel...
+  p.collision = {false};                                                                            // Setting self-collision flag...
+
+  return p;
+}
+
+/// @brief **Float build option value.**
+inline std::string literal (
+                            float loc_value                                                         ///< Value.
+                           )
+{
+  char text[32];                                                                                    // Literal text.
+
+  std::snprintf (text, sizeof (text), "%.9gf", loc_value);                                          // Printing literal...
+
+  return text;
+}
+
+/// @brief **Cloth problem.**
+/// @details Square cloth with fixed border and the default parameters of the Cloth example. With
+/// self-collision, the spatial hash and collision kernels run between the two step kernels, as in
+/// the Cloth example with "--collision". The node state is stored and integrated with the precision
+/// of loc_fp (see precision.hpp). With loc_materials, the stiffness and mass are read from a
+/// one-row material table through 8-bit ids instead of per-link and per-node arrays (see
+/// materials.hpp).
+inline problem cloth (
+                      size_t      loc_nx,                                                           ///< Number of nodes along "x".
+                      size_t      loc_ny,                                                           ///< Number of nodes along "y".
+                      std::string loc_home,                                                         ///< Kernel directory.
+                      bool        loc_collision,                                                    ///< Self-collision flag.
+                      std::string loc_topology,                                                     ///< Neighbour index encoding.
+                      size_t      loc_slice,                                                        ///< SELL slice height (0 = CSR) [#].
+                      size_t      loc_sigma,                                                        ///< SELL sorting window [#].
+                      precision&  loc_fp,                                                           ///< Precision.
+                      bool        loc_materials,                                                    ///< Material table flag.
+                      bool        loc_tiling                                                        ///< Tiling flag.
+                     )
+{
+  problem  p;                                                                                       // Problem.
+  lattice  l (loc_nx, loc_ny, 1, false);                                                            // Lattice.
+  topology t (l.nearest, l.offset, (loc_slice > 0) ? "wide" : loc_topology);                        // Neighbour list encoding.
+  size_t   cells;                                                                                   // Hash cells (one per node).
+  size_t   blocks;                                                                                  // Hash blocks.
+  float    ds = 2.0f/(std::max (loc_nx, loc_ny) - 1);                                               // Lattice spacing [m].
+  float    m  = 1000.0f*0.01f*ds*ds;                                                                // Node mass [kg].
+  float    K  = 10000.0f*0.01f;                                                                     // Elastic constant [kg/s^2].
+  float    B  = 1000.0f*0.01f*ds*ds;                                                                // Damping [kg*s*m].
+  float    dt = 0.5f*std::sqrt (m/K);                                                               // Simulation time step [s].
+
+  p.name       = "cloth";                                                                           // Setting name...
+  p.nodes      = l.position.size ();                                                                // Setting number of nodes...
+  p.links      = l.nearest.size ();                                                                 // Setting number of links...
+  arrange (p, l, loc_slice, loc_sigma);                                                             // Laying out links...
+  p.topology   = t.name ();                                                                         // Setting neighbour index encoding...
+  p.bytes_node = 228.0;                                                                             // Setting node traffic (state, plotted copy, mass, flags, offset)...
+  p.bytes_link = (t.mode == WIDE) ? 60.0 : 58.0;                                                    // Setting link traffic (neighbour, lengths, color)...
+  p.bytes_node += (loc_fp.position ? 64.0 : 0.0) + (loc_fp.state ? 128.0 : 0.0);                    // Adding double state traffic...
+  p.bytes_link += loc_fp.position ? 16.0 : 0.0;                                                     // Adding double neighbour position traffic...
+  p.defines    += loc_fp.defines ();                                                                // Setting precision defines...
+
+  if(loc_materials)
+  {
+    p.bytes_node -= 3.0;                                                                            // Replacing mass by a material id...
+    p.bytes_link -= 3.0;                                                                            // Replacing stiffness by a material id...
+    p.defines    += " -DMATERIALS=1";                                                               // Setting material table define...
+  }
+
+  tile (p, l, loc_tiling, loc_fp.position ? 32 : 16, (t.mode == WIDE) ? 4 : 2);                     // Tiling force kernel...
+  t.encode (l.nearest, l.offset);                                                                   // Encoding neighbour indices...
+  p.add (std::vector<cl_float4> (p.slots));                                                         // [0] Color.
+  p.add (l.position);                                                                               // [1] Position (plotted copy).
+  p.add (std::vector<cl_float4> (p.nodes), loc_fp.state);                                           // [2] Velocity.
+  p.add (std::vector<cl_float4> (p.nodes), loc_fp.state);                                           // [3] Acceleration.
+  p.add (std::vector<cl_float4> (p.nodes), loc_fp.position);                                        // [4] Position (intermediate).
+  p.add (std::vector<cl_float4> (p.nodes), loc_fp.state);                                           // [5] Velocity (intermediate).
+  p.add (std::vector<cl_float4> {{{0.0f, 0.0f, -9.81f, 1.0f}}});                                    // [6] Gravity.
+  p.add (std::vector<cl_float> (loc_materials ? 1 : p.slots));                                      // [7] Stiffness (1 = material table).
+  p.add (l.resting);                                                                                // [8] Resting.
+  p.add (std::vector<cl_float> {B});                                                                // [9] Friction.
+  p.add (std::vector<cl_float> (loc_materials ? 1 : p.nodes));                                      // [10] Mass (1 = material table).
+  p.add (std::vector<cl_int> {t.mode});                                                             // [11] Neighbour index encoding.
+  p.add (l.nearest);                                                                                // [12] Nearest.
+  p.add (l.offset);                                                                                 // [13] Offset.
+  p.add (l.freedom);                                                                                // [14] Freedom.
+  p.add (std::vector<cl_float> {dt});                                                               // [15] Time step.
+  p.add (std::vector<cl_float> {m, K, 1.2f*ds});                                                    // [16] Initialization parameters.
+  cells  = loc_collision ? p.nodes : 1;                                                             // Getting hash cells...
+  blocks = (cells + 255)/256;                                                                       // Getting hash blocks...
+  p.add (std::vector<cl_int> (cells));                                                              // [17] Hash cell.
+  p.add (std::vector<cl_int> (cells));                                                              // [18] Hash cell count.
+  p.add (std::vector<cl_int> (cells));                                                              // [19] Hash cell start.
+  p.add (std::vector<cl_int> (cells));                                                              // [20] Sorted nodes.
+  p.add (std::vector<cl_int> (blocks));                                                             // [21] Hash block sums.
+  p.add (std::vector<cl_float4> (cells));                                                           // [22] Collision force.
+  p.add (std::vector<cl_int> {0});                                                                  // [23] Tearing rank (placeholder).
+  p.add (std::vector<cl_int> {0});                                                                  // [24] Tearing block sums (placeholder).
+  p.add (std::vector<cl_float4> (1));                                                               // [25] Tearing spare (placeholder).
+  p.add (std::vector<cl_int> {0, cl_int (p.slots), 0});                                             // [26] Tearing counters (no tearing).
+  p.add (std::vector<cl_float4> {{{m, K, B, 0.0f}}});                                               // [27] Material table (one material).
+  p.add (std::vector<cl_int> (loc_materials ? (p.slots + 3)/4 : 1));                                // [28] Link material ids (all 0).
+  p.add (std::vector<cl_int> (loc_materials ? (p.nodes + 3)/4 : 1));                                // [29] Node material ids (all 0).
+  p.add (l.tile_node);                                                                              // [30] Tile nodes.
+  p.add (l.tile_code);                                                                              // [31] Tile stencil codes.
+  p.add (l.position, loc_fp.position);                                                              // [32] Position (node state).
+  p.state     = 32;                                                                                 // Setting position node state...
+  p.init      = {{loc_home + "utilities.cl", loc_home + "init_material.cl"},
+                 {loc_home + "precision.cl", loc_home + "utilities.cl", loc_home + "init_state.cl"}}; // Setting initialization kernels...
+  p.step      = {{loc_home + "precision.cl", loc_home + "utilities.cl",
+                  loc_home + "thekernel_1.cl"}};                                                    // Setting step kernels...
+  p.collision = {false};                                                                            // Setting self-collision flags...
+
+  if(loc_collision)
+  {
+    for(std::string file : {"hash_clear.cl", "hash_count.cl", "hash_scan_1.cl", "hash_scan_2.cl",
+                            "hash_scan_3.cl", "hash_sort.cl", "collision.cl"})
+    {
+      p.step.push_back ({loc_home + "precision.cl", loc_home + "utilities.cl", loc_home + "hash.cl",
+                         loc_home + file});                                                         // Adding self-collision kernel...
+      p.collision.push_back (true);                                                                 // Flagging self-collision kernel...
+    }
+
+    p.options = " -DCOLLISION=1 -DHASH_CELLS=" + std::to_string (cells) + " -DHASH_BLOCK=256 -DHASH_BLOCKS=" +
+                std::to_string (blocks) + " -DHASH_CELL=" + literal (0.5f*ds) + " -DCONTACT_RADIUS=" +
+                literal (0.5f*ds);                                                                  // Setting self-collision defines...
+  }
+
+  p.step.push_back ({loc_home + "precision.cl", loc_home + "utilities.cl",
+                     loc_home + "thekernel_2.cl"});                                                 // Adding step kernel...
+  p.collision.push_back (false);                                                                    // Flagging step kernel...
+
+  return p;
+}
+
+/// @brief **Gravity problem.**
+/// @details Cubic lattice with fixed boundary and the default parameters of the Gravity example.
+/// The node state is stored and integrated with the precision of loc_fp (see precision.hpp). With
+/// loc_materials, the stiffness and mass are read from a one-row material table (see materials.hpp).
+inline problem gravity (
+                        size_t      loc_n,                                                          ///< Number of nodes along each side.
+                        std::string loc_home,                                                       ///< Kernel directory.
+                        std::string loc_topology,                                                   ///< Neighbour index encoding.
+                        size_t      loc_slice,                                                      ///< SELL slice height (0 = CSR) [#].
+                        size_t      loc_sigma,                                                      ///< SELL sorting window [#].
+                        precision&  loc_fp,                                                         ///< Precision.
+                        bool        loc_materials,                                                  ///< Material table flag.
+                        bool        loc_tiling                                                      ///< Tiling flag.
+                       )
+{
+  problem  p;                                                                                       // Problem.
+  lattice  l (loc_n, loc_n, loc_n, false);                                                          // Lattice.
+  topology t (l.nearest, l.offset, (loc_slice > 0) ? "wide" : loc_topology);                        // Neighbour list encoding.
+  float    ds = 2.0f/(loc_n - 1);                                                                   // Lattice spacing [m].
+  float    m  = 20.0f;                                                                              // Node mass [kg].
+  float    K  = 100.0f;                                                                             // Elastic constant [kg/s^2].
+  float    B  = 100.0f;                                                                             // Damping [kg*s*m].
+  float    dt = 0.1f*std::sqrt (m/K);                                                               // Simulation time step [s].
+
+  p.name       = "gravity";                                                                         // Setting name...
+  p.nodes      = l.position.size ();                                                                // Setting number of nodes...
+  p.links      = l.nearest.size ();                                                                 // Setting number of links...
+  arrange (p, l, loc_slice, loc_sigma);                                                             // Laying out links...
+  p.topology   = t.name ();                                                                         // Setting neighbour index encoding...
+  p.bytes_node = 228.0;                                                                             // Setting node traffic (state, plotted copy, mass, flags, offset)...
+  p.bytes_link = (t.mode == WIDE) ? 60.0 : 58.0;                                                    // Setting link traffic (neighbour, lengths, color)...
+  p.bytes_node += (loc_fp.position ? 64.0 : 0.0) + (loc_fp.state ? 128.0 : 0.0);                    // Adding double state traffic...
+  p.bytes_link += loc_fp.position ? 16.0 : 0.0;                                                     // Adding double neighbour position traffic...
+  p.defines    += loc_fp.defines ();                                                                // Setting precision defines...
+
+  if(loc_materials)
+  {
+    p.bytes_node -= 3.0;                                                                            // Replacing mass by a material id...
+    p.bytes_link -= 3.0;                                                                            // Replacing stiffness by a material id...
+    p.defines    += " -DMATERIALS=1";                                                               // Setting material table define...
+  }
+
+  tile (p, l, loc_tiling, loc_fp.position ? 32 : 16, (t.mode == WIDE) ? 4 : 2);                     // Tiling force kernel...
+  t.encode (l.nearest, l.offset);                                                                   // Encoding neighbour indices...
+  p.add (std::vector<cl_float4> (p.slots));                                                         // [0] Color.
+  p.add (l.position);                                                                               // [1] Position (plotted copy).
+  p.add (std::vector<cl_float4> (p.nodes), loc_fp.state);                                           // [2] Velocity.
+  p.add (std::vector<cl_float4> (p.nodes), loc_fp.state);                                           // [3] Acceleration.
+  p.add (std::vector<cl_float4> (p.nodes), loc_fp.position);                                        // [4] Position (intermediate).
+  p.add (std::vector<cl_float4> (p.nodes), loc_fp.state);                                           // [5] Velocity (intermediate).
+  p.add (std::vector<cl_float> {0.3f});                                                             // [6] Nucleus radius.
+  p.add (std::vector<cl_float> (loc_materials ? 1 : p.slots));                                      // [7] Stiffness (1 = material table).
+  p.add (l.resting);                                                                                // [8] Resting.
+  p.add (std::vector<cl_float> {B});                                                                // [9] Friction.
+  p.add (std::vector<cl_float> (loc_materials ? 1 : p.nodes));                                      // [10] Mass (1 = material table).
+  p.add (std::vector<cl_int> {t.mode});                                                             // [11] Neighbour index encoding.
+  p.add (l.nearest);                                                                                // [12] Nearest.
+  p.add (l.offset);                                                                                 // [13] Offset.
+  p.add (l.freedom);                                                                                // [14] Freedom.
+  p.add (std::vector<cl_float> {dt});                                                               // [15] Time step.
+  p.add (std::vector<cl_float> {m, K, 1.1f*ds});                                                    // [16] Initialization parameters.
+  p.add (std::vector<cl_int> {0});                                                                  // [17] Multirate level (global stepping).
+  p.add (std::vector<cl_int> {0});                                                                  // [18] Sorted nodes (global stepping).
+  p.add (std::vector<cl_int> {0});                                                                  // [19] Multirate schedule (global stepping).
+  p.add (std::vector<cl_int> {0});                                                                  // [20] Render list (not drawn).
+  p.add (std::vector<cl_float4> {{{m, K, B, 0.0f}}});                                               // [21] Material table (one material).
+  p.add (std::vector<cl_int> (loc_materials ? (p.slots + 3)/4 : 1));                                // [22] Link material ids (all 0).
+  p.add (std::vector<cl_int> (loc_materials ? (p.nodes + 3)/4 : 1));                                // [23] Node material ids (all 0).
+  p.add (l.tile_node);                                                                              // [24] Tile nodes.
+  p.add (l.tile_code);                                                                              // [25] Tile stencil codes.
+  p.add (l.position, loc_fp.position);                                                              // [26] Position (node state).
+  p.state     = 26;                                                                                 // Setting position node state...
+  p.init      = {{loc_home + "utilities.cl", loc_home + "init_material.cl"},
+                 {loc_home + "precision.cl", loc_home + "utilities.cl", loc_home + "init_state.cl"}}; // Setting initialization kernels...
+  p.step      = {{loc_home + "precision.cl", loc_home + "utilities.cl", loc_home + "thekernel1.cl"},
+                 {loc_home + "precision.cl", loc_home + "utilities.cl", loc_home + "thekernel2.cl"}}; // Setting step kernels...
+  p.collision = {false, false};                                                                     // Setting self-collision flags...
+
+  return p;
+}
+
+/// @brief **Mesh problem.**
+/// @details Triangle lattice colored by link length (mesh_kernel.cl), as in the Mesh example. With
+/// loc_file, the lattice is read from a Gmsh mesh instead (any element type, see lattice). The
+/// positions are stored with the precision of loc_fp (see precision.hpp).
+inline problem mesh (
+                     size_t      loc_nx,                                                            ///< Number of nodes along "x".
+                     size_t      loc_ny,                                                            ///< Number of nodes along "y".
+                     std::string loc_home,                                                          ///< Kernel directory.
+                     std::string loc_topology,                                                      ///< Neighbour index encoding.
+                     size_t      loc_slice,                                                         ///< SELL slice height (0 = CSR) [#].
+                     size_t      loc_sigma,                                                         ///< SELL sorting window [#].
+                     std::string loc_file,                                                          ///< Mesh file ("" = triangle lattice).
+                     precision&  loc_fp                                                             ///< Precision.
+                    )
+{
+  problem  p;                                                                                       // Problem.
+  lattice  l = (loc_file == "") ? lattice (loc_nx, loc_ny, 1, true) : lattice (loc_file);           // Lattice.
+  topology t (l.nearest, l.offset, (loc_slice > 0) ? "wide" : loc_topology);                        // Neighbour list encoding.
+
+  p.name       = "mesh";                                                                            // Setting name...
+  p.nodes      = l.position.size ();                                                                // Setting number of nodes...
+  p.links      = l.nearest.size ();                                                                 // Setting number of links...
+  arrange (p, l, loc_slice, loc_sigma);                                                             // Laying out links...
+  p.topology   = t.name ();                                                                         // Setting neighbour index encoding...
+  p.bytes_node = 36.0;                                                                              // Setting node traffic (position, plotted copy, offset)...
+  p.bytes_link = (t.mode == WIDE) ? 36.0 : 34.0;                                                    // Setting link traffic (neighbour, its position, color)...
+  p.bytes_node += loc_fp.position ? 16.0 : 0.0;                                                     // Adding double position traffic...
+  p.bytes_link += loc_fp.position ? 16.0 : 0.0;                                                     // Adding double neighbour position traffic...
+  p.defines    += loc_fp.defines ();                                                                // Setting precision defines...
+  t.encode (l.nearest, l.offset);                                                                   // Encoding neighbour indices...
+  p.add (std::vector<cl_float4> (p.slots));                                                         // [0] Color.
+  p.add (l.position);                                                                               // [1] Position (plotted copy).
+  p.add (std::vector<cl_int> {t.mode});                                                             // [2] Neighbour index encoding.
+  p.add (l.nearest);                                                                                // [3] Neighbour.
+  p.add (l.offset);                                                                                 // [4] Offset.
+  p.add (l.position, loc_fp.position);                                                              // [5] Position (node state).
+  p.state     = 5;                                                                                  // Setting position node state...
+  p.step      = {{loc_home + "precision.cl", loc_home + "utilities.cl",
+                  loc_home + "mesh_kernel.cl"}};                                                    // Setting step kernel...
+  p.collision = {false};                                                                            // Setting self-collision flag...
+
+  return p;
+}
+}
+
+#endif
@@ -0,0 +1,593 @@
+/// @file     main.cpp
+/// @brief    Headless benchmark of the example kernels.
+///
+/// @details  It runs the Sinusoid, Cloth, Gravity and Mesh kernels on procedural lattices through raw
+/// OpenCL, without any window, e.g.:
+/// `benchmark --example cloth --nodes_x 201 --steps 1000 --platform Portable --type cpu`
+
+#ifdef __linux__
+  #define SINUSOID_HOME "../../Sinusoid/Code/kernel/"                                               // Linux Sinusoid kernels directory.
+  #define CLOTH_HOME    "../../Cloth/Code/kernel/"                                                  // Linux Cloth kernels directory.
+  #define GRAVITY_HOME  "../../Gravity/Code/kernel/"                                                // Linux Gravity kernels directory.
+  #define MESH_HOME     "../../Mesh/Code/kernel/"                                                   // Linux Mesh kernels directory.
+#endif
+
+#ifdef WIN32
+  #define SINUSOID_HOME "..\\..\\Sinusoid\\Code\\kernel\\"                                          // Windows Sinusoid kernels directory.
+  #define CLOTH_HOME    "..\\..\\Cloth\\Code\\kernel\\"                                             // Windows Cloth kernels directory.
+  #define GRAVITY_HOME  "..\\..\\Gravity\\Code\\kernel\\"                                           // Windows Gravity kernels directory.
+  #define MESH_HOME     "..\\..\\Mesh\\Code\\kernel\\"                                              // Windows Mesh kernels directory.
+#endif
+
+#define CACHE_NAME      "neutrino_cache"                                                            // Program cache directory name.
+
+// INCLUDES:
+#include "clhost.hpp"                                                                               // Raw OpenCL host context.
+#include "program_cache.hpp"                                                                        // Program binary cache.
+#include "autotune.hpp"                                                                             // Work-group size autotuner.
+#include "options.hpp"                                                                              // Command line options.
+#include "lattice.hpp"                                                                              // Procedural lattices.
+#include "report.hpp"                                                                               // JSON report.
+#include "trajectory.hpp"                                                                           // Trajectory output.
+#include "precision.hpp"                                                                            // Compile-time precision.
+#include <chrono>                                                                                   // Benchmark timing.
+#include <fstream>                                                                                  // Reference positions.
+#include <sstream>                                                                                  // Option lists.
+
+/// @brief **Elapsed time [ms].**
+static double elapsed (
+                       std::chrono::steady_clock::time_point loc_start                              ///< Start time.
+                      )
+{
+  return std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - loc_start).count ();
+}
+
+/// @brief **Data initialization.**
+/// @details Uploads the initial arguments and runs the initialization kernels.
+static void initialize (
+                        ex::clhost*             loc_cl,                                             ///< OpenCL host context.
+                        ex::problem&            loc_p,                                              ///< Benchmark problem.
+                        std::vector<cl_mem>&    loc_buffer,                                         ///< OpenCL buffers.
+                        std::vector<cl_kernel>& loc_K_init                                          ///< OpenCL kernels (initialization).
+                       )
+{
+  for(size_t a = 0; a < loc_buffer.size (); a++)
+  {
+    ex::check (clEnqueueWriteBuffer (loc_cl->queue, loc_buffer[a], CL_FALSE, 0, loc_p.argument[a].size (),
+                                     loc_p.argument[a].data (), 0, nullptr, nullptr),
+               "clEnqueueWriteBuffer");                                                             // Uploading argument...
+  }
+
+  for(cl_kernel k : loc_K_init)
+  {
+    ex::check (clEnqueueNDRangeKernel (loc_cl->queue, k, 1, nullptr, &loc_p.nodes, nullptr, 0, nullptr,
+                                       nullptr), "clEnqueueNDRangeKernel");                         // Initializing data...
+  }
+
+  ex::check (clFinish (loc_cl->queue), "clFinish");                                                 // Waiting for initialization...
+}
+
+/// @brief **Step enqueuer.**
+/// @details Enqueues the step kernels of one step, with or without the self-collision kernels.
+static void step (
+                  ex::clhost*             loc_cl,                                                   ///< OpenCL host context.
+                  ex::problem&            loc_p,                                                    ///< Benchmark problem.
+                  std::vector<cl_kernel>& loc_K_step,                                               ///< OpenCL kernels (step).
+                  std::vector<size_t>&    loc_local,                                                ///< Local sizes (0 = driver default).
+                  bool                    loc_collision                                             ///< Self-collision flag.
+                 )
+{
+  for(size_t k = 0; k < loc_K_step.size (); k++)
+  {
+    size_t global = ex::autotune::global (loc_p.nodes, loc_local[k]);                               // Global size (padded).
+
+    if(loc_p.collision[k] && !loc_collision)
+    {
+      continue;                                                                                     // Skipping self-collision kernel...
+    }
+
+    ex::check (clEnqueueNDRangeKernel (loc_cl->queue, loc_K_step[k], 1, nullptr, &global,
+                                       (loc_local[k] == 0) ? nullptr : &loc_local[k], 0, nullptr, nullptr),
+               "clEnqueueNDRangeKernel");                                                           // Running step kernel...
+  }
+}
+
+int main (int argc, char** argv)
+{
+  // OPTIONS:
+  ex::options*            opt       = new ex::options (argc, argv);                                 // Command line options.
+  std::string             example   = opt->get ("example", std::string ("cloth"));                  // Example ("sinusoid", "cloth", "gravity" or "mesh").
+  size_t                  nodes_x   = opt->get ("nodes_x", size_t ((example == "gravity") ? 31 : 101)); // Number of nodes along "x" [#].
+  size_t                  nodes_y   = opt->get ("nodes_y", nodes_x);                                // Number of nodes along "y" [#].
+  size_t                  steps     = opt->get ("steps", size_t (1000));                            // Number of steps [#].
+  std::string             platform  = opt->get ("platform", std::string (""));                      // Platform name filter ("" = any).
+  size_t                  device    = opt->get ("device", size_t (0));                              // Device index [#].
+  std::string             type      = opt->get ("type", std::string ("all"));                       // Device type ("gpu", "cpu" or "all").
+  std::string             directory = opt->get ("cache", (std::filesystem::temp_directory_path ()/
+                                                          CACHE_NAME).string ());                   // Program cache directory.
+  bool                    tune      = !opt->flag ("no-tune");                                       // Work-group size tuning flag.
+  bool                    retune    = opt->flag ("retune");                                         // Work-group size retuning flag.
+  size_t                  repeats   = opt->get ("repeats", size_t (10));                            // Tuning runs per candidate [#].
+  size_t                  runs      = opt->get ("runs", size_t (1));                                // Timed runs (best is reported) [#].
+  std::string             json      = opt->get ("json", std::string (""));                          // JSON report file ("" = none).
+  std::string             baseline  = opt->get ("baseline", std::string (""));                      // JSON baseline file ("" = none).
+  float                   tolerance = opt->get ("tolerance", 0.1f);                                 // Regression tolerance [].
+  std::string             path      = opt->get ("trajectory", std::string (""));                    // Trajectory file ("" = none).
+  std::string             every     = opt->get ("every", std::string ("100,10,1"));                 // Trajectory output periods [steps].
+  bool                    velocity  = opt->flag ("velocity");                                       // Trajectory velocity flag.
+  float                   quantum   = opt->get ("quantum", 1e-6f);                                  // Trajectory quantum [m, m/s].
+  bool                    collision = opt->flag ("collision");                                      // Cloth self-collision flag.
+  std::string             coding    = opt->get ("topology", std::string ("auto"));                  // Neighbour index encoding ("auto", "wide" or "delta").
+  std::string             layout    = opt->get ("layout", std::string ("csr"));                     // Neighbour layout ("csr" or "sell").
+  size_t                  slice     = opt->get ("slice", size_t (32));                              // SELL slice height [#].
+  size_t                  sigma     = opt->get ("sigma", size_t (128));                             // SELL sorting window [#].
+  ex::precision*          fp        = new ex::precision (opt->get ("precision", std::string ("single")),
+                                                         true);                                     // Precision ("single", "mixed" or "double").
+  std::string             reference = opt->get ("reference", std::string (""));                     // Reference positions file ("" = none).
+  bool                    table     = opt->flag ("materials");                                      // Material table flag (stiffness and mass ids).
+  std::string             tiles     = opt->get ("tiling", std::string ("auto"));                    // Force kernel tiling ("auto" or "off").
+  std::string             file      = opt->get ("mesh", std::string (""));                          // Gmsh mesh file ("" = lattice).
+  int                     status    = 0;                                                            // Exit status.
+
+  // PROBLEM:
+  ex::problem             p;                                                                        // Benchmark problem.
+
+  // OPENCL:
+  ex::clhost*             cl;                                                                       // OpenCL host context.
+  ex::program_cache*      cache;                                                                    // Program cache.
+  std::vector<cl_program> program;                                                                  // OpenCL programs.
+  std::vector<cl_kernel>  K_init;                                                                   // OpenCL kernels (initialization).
+  std::vector<cl_kernel>  K_step;                                                                   // OpenCL kernels (step).
+  std::vector<cl_mem>     buffer;                                                                   // OpenCL buffers (by layout index).
+  std::string             options;                                                                  // OpenCL build options (step).
+  std::vector<size_t>     local;                                                                    // Local sizes (step, 0 = driver default).
+  ex::autotune*           tuner;                                                                    // Work-group size autotuner.
+  cl_int                  error;                                                                    // OpenCL error code.
+
+  // TIMING:
+  auto                    start     = std::chrono::steady_clock::now ();                            // Start time.
+  double                  t_context;                                                                // Context creation time [ms].
+  double                  t_data;                                                                   // Data upload and initialization time [ms].
+  double                  t_startup;                                                                // Startup time [ms].
+  double                  t_run     = 0.0;                                                          // Stepping time (best run) [ms].
+  double                  t;                                                                        // Stepping time (current run) [ms].
+  double                  t_base    = 0.0;                                                          // Stepping time without self-collision (best run) [ms].
+
+  // REPORT:
+  ex::report              result;                                                                   // Benchmark result.
+  ex::report              base;                                                                     // Benchmark baseline.
+  double                  rate;                                                                     // Steps per second [1/s].
+  double                  error_max = -1.0;                                                         // Maximum position error [m] (< 0 = not measured).
+  double                  error_rms = -1.0;                                                         // RMS position error [m] (< 0 = not measured).
+
+  if(opt->flag ("no-cache"))
+  {
+    directory = "";                                                                                 // Disabling program cache...
+  }
+
+  if((layout != "csr") && (layout != "sell"))
+  {
+    std::cout << "Error: unknown layout \"" << layout << "\"." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  slice = (layout == "sell") ? slice : 0;                                                           // Setting slice height (0 = CSR)...
+
+  if((tiles != "auto") && (tiles != "off"))
+  {
+    std::cout << "Error: unknown tiling \"" << tiles << "\" (auto or off)." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  if((file != "") && (example != "mesh"))
+  {
+    std::cout << "Error: the mesh file applies to the mesh example only." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  if(table && (example != "cloth") && (example != "gravity"))
+  {
+    std::cout << "Error: the material table applies to the cloth and gravity examples only." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  if(fp->state && velocity && (path != ""))
+  {
+    std::cout << "Error: trajectory velocity output needs single precision kinematics." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////// PROBLEM ////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  if(example == "sinusoid")
+  {
+    p = ex::sinusoid (nodes_x, nodes_y, SINUSOID_HOME, *fp);                                        // Building Sinusoid problem...
+  }
+  else if(example == "cloth")
+  {
+    p = ex::cloth (nodes_x, nodes_y, CLOTH_HOME, collision, coding, slice, sigma, *fp, table,
+                   tiles == "auto");                                                                // Building Cloth problem...
+  }
+  else if(example == "gravity")
+  {
+    p = ex::gravity (nodes_x, GRAVITY_HOME, coding, slice, sigma, *fp, table,
+                     tiles == "auto");                                                              // Building Gravity problem...
+  }
+  else if(example == "mesh")
+  {
+    p = ex::mesh (nodes_x, nodes_y, MESH_HOME, coding, slice, sigma, file, *fp);                    // Building Mesh problem...
+  }
+  else
+  {
+    std::cout << "Error: unknown example \"" << example << "\"." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////// STARTUP ////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  start     = std::chrono::steady_clock::now ();                                                    // Starting startup timer...
+  cl        = new ex::clhost (platform, device, type);                                              // Creating OpenCL context...
+  t_context = elapsed (start);                                                                      // Getting context creation time...
+  fp->check (cl->device_info (CL_DEVICE_EXTENSIONS));                                               // Checking double precision support...
+  cache     = new ex::program_cache (directory);                                                    // Creating program cache...
+
+  for(std::vector<std::string> files : p.init)
+  {
+    program.push_back (cache->build (cl, files, p.defines));                                        // Building program...
+    K_init.push_back (clCreateKernel (program.back (), "thekernel", &error));                       // Creating kernel...
+    ex::check (error, "clCreateKernel");
+  }
+
+  options = "-DNODES=" + std::to_string (p.nodes) + p.options + p.defines;                          // Setting padding guard and defines...
+
+  for(std::vector<std::string> files : p.step)
+  {
+    program.push_back (cache->build (cl, files, options));                                          // Building program...
+    K_step.push_back (clCreateKernel (program.back (), "thekernel", &error));                       // Creating kernel...
+    ex::check (error, "clCreateKernel");
+  }
+
+  start = std::chrono::steady_clock::now ();                                                        // Starting data timer...
+
+  for(std::vector<unsigned char>& a : p.argument)
+  {
+    buffer.push_back (clCreateBuffer (cl->context, CL_MEM_READ_WRITE, a.size (), nullptr, &error)); // Creating buffer...
+    ex::check (error, "clCreateBuffer");
+  }
+
+  for(std::vector<cl_kernel>* list : {&K_init, &K_step})
+  {
+    for(cl_kernel k : *list)
+    {
+      for(cl_uint a = 0; a < buffer.size (); a++)
+      {
+        ex::check (clSetKernelArg (k, a, sizeof (cl_mem), &buffer[a]), "clSetKernelArg");           // Setting kernel argument...
+      }
+    }
+  }
+
+  initialize (cl, p, buffer, K_init);                                                               // Initializing data...
+  t_data    = elapsed (start);                                                                      // Getting data time...
+  t_startup = t_context + cache->time + t_data;                                                     // Getting startup time...
+
+  std::cout << "device   = " << cl->name () << std::endl;
+  std::cout << "problem  = " << p.name << " (" << p.nodes << " nodes, " << p.links << " links"
+            << ((p.links == 0) ? "" : ", topology = " + p.topology + ", layout = " + p.layout) << ")" << std::endl;
+  std::cout << "state    = " << fp->name () << " precision (" << (fp->position ? "double" : "float")
+            << " positions, " << (fp->state ? "double" : "float") << " kinematics)" << std::endl;
+
+  if(table)
+  {
+    std::cout << "material = table (8-bit stiffness and mass ids)" << std::endl;
+  }
+
+  if((p.tiling != "") && (p.tiling != "off"))
+  {
+    std::cout << "tiling   = " << p.tiling << " grid (tiled force kernel up to " << TILE_LOCAL << " work-items)" << std::endl;
+  }
+
+  if(p.slots > p.links)
+  {
+    std::cout << "padding  = " << p.slots - p.links << " link slots (" << 100.0*(p.slots - p.links)/p.links
+              << "%)" << std::endl;
+  }
+
+  std::cout << "cache    = " << ((directory == "") ? "disabled" : directory) << std::endl;
+  std::cout << "startup  = " << t_startup << " ms (" << cache->state () << "): context = " << t_context
+            << " ms, programs = " << cache->time << " ms (" << cache->hits << " cached, " << cache->misses
+            << " built), data = " << t_data << " ms" << std::endl;
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////// TUNING /////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  tuner = new ex::autotune (directory, retune, repeats);                                            // Creating autotuner...
+  local.assign (K_step.size (), 0);                                                                 // Setting driver default...
+
+  if(tune)
+  {
+    for(size_t k = 0; k < K_step.size (); k++)
+    {
+      local[k] = tuner->local (cl, K_step[k], "kernel " + std::to_string (k + 1),
+                               ex::source (p.step[k]) + options, p.nodes);                          // Getting local size...
+    }
+
+    initialize (cl, p, buffer, K_init);                                                             // Restoring data...
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////// STEPPING ///////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  for(size_t r = 0; r < std::max (runs, size_t (1)); r++)
+  {
+    start = std::chrono::steady_clock::now ();                                                      // Starting stepping timer...
+
+    for(size_t s = 0; s < steps; s++)
+    {
+      step (cl, p, K_step, local, true);                                                            // Running step...
+    }
+
+    ex::check (clFinish (cl->queue), "clFinish");                                                   // Waiting for steps...
+    t     = elapsed (start);                                                                        // Getting stepping time...
+    t_run = ((r == 0) || (t < t_run)) ? t : t_run;                                                  // Keeping best run...
+  }
+
+  rate = 1000.0*steps/t_run;                                                                        // Computing steps/s...
+
+  std::cout << "stepping = " << steps << " steps in " << t_run << " ms (" << rate << " steps/s, "
+            << 1e-6*rate*p.nodes << " Mnodes/s)" << std::endl;
+
+  // TIMING SELF-COLLISION (same steps without the hash and collision kernels):
+  if(collision && (p.name == "cloth"))
+  {
+    for(size_t r = 0; r < std::max (runs, size_t (1)); r++)
+    {
+      start = std::chrono::steady_clock::now ();                                                    // Starting stepping timer...
+
+      for(size_t s = 0; s < steps; s++)
+      {
+        step (cl, p, K_step, local, false);                                                         // Running step without self-collision...
+      }
+
+      ex::check (clFinish (cl->queue), "clFinish");                                                 // Waiting for steps...
+      t      = elapsed (start);                                                                     // Getting stepping time...
+      t_base = ((r == 0) || (t < t_base)) ? t : t_base;                                             // Keeping best run...
+    }
+
+    std::cout << "collide  = " << 1e6*(t_run - t_base)/(steps*p.nodes) << " ns/node per step ("
+              << 100.0*(t_run - t_base)/t_run << "% of the step)" << std::endl;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////////////////// ACCURACY ////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  if(reference != "")
+  {
+    std::vector<unsigned char> bytes (p.argument[p.state].size ());                                 // Final position (node state storage).
+    std::vector<double>        xyz;                                                                 // Final position [m].
+    std::vector<double>        xyz_ref;                                                             // Reference position [m].
+    std::ifstream              in (reference, std::ios::binary);                                    // Reference file.
+    double                     d;                                                                   // Node position error [m].
+
+    initialize (cl, p, buffer, K_init);                                                             // Restoring data...
+
+    for(size_t s = 0; s < steps; s++)
+    {
+      step (cl, p, K_step, local, true);                                                            // Running step...
+    }
+
+    ex::check (clEnqueueReadBuffer (cl->queue, buffer[p.state], CL_TRUE, 0, bytes.size (), bytes.data (), 0,
+                                    nullptr, nullptr), "clEnqueueReadBuffer");                      // Reading final position...
+    xyz = fp->unpack (bytes);                                                                       // Widening final position...
+
+    if(!in)
+    {
+      std::ofstream out;                                                                            // Reference file.
+
+      if(std::filesystem::path (reference).has_parent_path ())
+      {
+        std::filesystem::create_directories (std::filesystem::path (reference).parent_path ());     // Creating directory...
+      }
+
+      out.open (reference, std::ios::binary);                                                       // Opening reference...
+      out.write ((const char*)xyz.data (), xyz.size ()*sizeof (double));                            // Storing reference...
+      std::cout << "accuracy = reference stored (" << reference << ")" << std::endl;
+    }
+    else
+    {
+      xyz_ref.resize (xyz.size ());                                                                 // Sizing reference...
+      in.read ((char*)xyz_ref.data (), xyz_ref.size ()*sizeof (double));                            // Reading reference...
+
+      if((size_t (in.gcount ()) != xyz_ref.size ()*sizeof (double)) || (in.peek () != EOF))
+      {
+        std::cout << "accuracy = skipped (" << reference << " is for another problem)" << std::endl;
+      }
+      else
+      {
+        error_max = 0.0;                                                                            // Resetting maximum error...
+        error_rms = 0.0;                                                                            // Resetting RMS error...
+
+        for(size_t i = 0; i < xyz.size (); i += 3)
+        {
+          d         = std::sqrt ((xyz[i] - xyz_ref[i])*(xyz[i] - xyz_ref[i]) +
+                                 (xyz[i + 1] - xyz_ref[i + 1])*(xyz[i + 1] - xyz_ref[i + 1]) +
+                                 (xyz[i + 2] - xyz_ref[i + 2])*(xyz[i + 2] - xyz_ref[i + 2]));      // Computing node error...
+          error_max = std::max (error_max, d);                                                      // Getting maximum error...
+          error_rms += d*d;                                                                         // Summing squared error...
+        }
+
+        error_rms = std::sqrt (error_rms/p.nodes);                                                  // Computing RMS error...
+
+        std::cout << "accuracy = max error = " << error_max << " m, rms error = " << error_rms << " m after "
+                  << steps << " steps (against " << reference << ")" << std::endl;
+      }
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////// REPORT /////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  result.set ("example", p.name);                                                                   // Setting example...
+  result.set ("device", cl->name ());                                                               // Setting device...
+  result.set ("nodes", double (p.nodes));                                                           // Setting number of nodes...
+  result.set ("edges", double (p.links));                                                           // Setting number of links...
+  result.set ("topology", (p.links == 0) ? std::string ("none") : p.topology);                      // Setting neighbour index encoding...
+  result.set ("layout", p.layout);                                                                  // Setting neighbour layout...
+  result.set ("precision", fp->name ());                                                            // Setting precision...
+  result.set ("material", std::string (table ? "table" : "arrays"));                                // Setting material storage...
+  result.set ("tiling", (p.tiling == "") ? std::string ("off") : p.tiling);                         // Setting force kernel tiling...
+  result.set ("padding", (p.links == 0) ? 0.0 : double (p.slots - p.links)/p.links);                // Setting layout padding...
+  result.set ("steps", double (steps));                                                             // Setting number of steps...
+  result.set ("startup_ms", t_startup);                                                             // Setting startup time...
+  result.set ("startup", cache->state ());                                                          // Setting startup state...
+  result.set ("steps_per_s", rate);                                                                 // Setting steps/s...
+  result.set ("ns_per_node", 1e9/(rate*p.nodes));                                                   // Setting time per node...
+  result.set ("ns_per_edge", (p.links == 0) ? 0.0 : 1e9/(rate*p.links));                            // Setting time per link...
+  result.set ("bandwidth_gb_s", 1e-9*rate*(p.bytes_node*p.nodes + p.bytes_link*p.links));          // Setting effective bandwidth...
+
+  if(t_base > 0.0)
+  {
+    result.set ("collision_ns_per_node", 1e6*(t_run - t_base)/(steps*p.nodes));                    // Setting self-collision time per node...
+  }
+
+  if(error_max >= 0.0)
+  {
+    result.set ("error_max_m", error_max);                                                          // Setting maximum position error...
+    result.set ("error_rms_m", error_rms);                                                          // Setting RMS position error...
+  }
+
+  std::cout << "per node = " << result.get ("ns_per_node") << " ns, per edge = " << result.get ("ns_per_edge")
+            << " ns, bandwidth = " << result.get ("bandwidth_gb_s") << " GB/s (estimated)" << std::endl;
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////// TRAJECTORY ///////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  if(path != "")
+  {
+    std::vector<cl_mem> output  = {buffer[1]};                                                      // Trajectory arrays (plotted position copy).
+    std::vector<float>  quanta  = {quantum};                                                        // Trajectory quanta.
+    std::istringstream  periods (every);                                                            // Output periods.
+    std::string         period;                                                                     // Output period.
+    ex::trajectory*     out;                                                                        // Trajectory writer.
+    double              r;                                                                          // Steps per second with output [1/s].
+
+    if(velocity && (p.name != "sinusoid"))
+    {
+      output.push_back (buffer[2]);                                                                 // Adding velocity...
+      quanta.push_back (quantum);                                                                   // Adding velocity quantum...
+    }
+
+    while(std::getline (periods, period, ','))
+    {
+      size_t k = std::strtoull (period.c_str (), nullptr, 10);                                      // Output period [steps].
+
+      initialize (cl, p, buffer, K_init);                                                           // Restoring data...
+      out   = new ex::trajectory (cl, path, output, quanta, p.nodes, k);                            // Creating trajectory writer...
+      start = std::chrono::steady_clock::now ();                                                    // Starting stepping timer...
+
+      for(size_t s = 0; s < steps; s++)
+      {
+        step (cl, p, K_step, local, true);                                                          // Running step...
+        out->step (s + 1);                                                                          // Writing trajectory...
+      }
+
+      ex::check (clFinish (cl->queue), "clFinish");                                                 // Waiting for steps...
+      t = elapsed (start);                                                                          // Getting stepping time...
+      out->close ();                                                                                // Draining trajectory...
+      r = 1000.0*steps/t;                                                                           // Computing steps/s...
+
+      std::cout << "output   = every " << k << " steps: " << r << " steps/s (" << 100.0*(rate/r - 1.0)
+                << "% overhead), " << out->frames << " frames, " << out->stalls << " stalls, "
+                << 1e-6*out->bytes << " MB (" << double (out->raw)/std::max (out->bytes, size_t (1))
+                << "x compression)" << std::endl;
+
+      result.set ("output_" + period + "_steps_per_s", r);                                          // Setting steps/s with output...
+      result.set ("output_" + period + "_overhead", rate/r - 1.0);                                  // Setting output overhead...
+      result.set ("output_" + period + "_compression",
+                  double (out->raw)/std::max (out->bytes, size_t (1)));                             // Setting compression ratio...
+      delete out;                                                                                   // Deleting trajectory writer...
+    }
+
+    // CHECKING RANDOM ACCESS (last frame against the final device state):
+    ex::trajectory_reader in (path);                                                                // Trajectory reader.
+    std::vector<float>    frame;                                                                    // Decoded frame.
+    std::vector<float>    state (4*p.nodes);                                                        // Device position.
+    float                 deviation = 0.0f;                                                         // Maximum quantization error [m].
+
+    if((in.size () > 0) && (in.step (in.size () - 1) == steps))
+    {
+      start = std::chrono::steady_clock::now ();                                                    // Starting seek timer...
+      frame = in.read (in.size () - 1);                                                             // Seeking last frame...
+      t     = elapsed (start);                                                                      // Getting seek time...
+      ex::check (clEnqueueReadBuffer (cl->queue, buffer[1], CL_TRUE, 0, state.size ()*sizeof (float),
+                                      state.data (), 0, nullptr, nullptr), "clEnqueueReadBuffer");
+
+      for(size_t i = 0; i < state.size (); i++)
+      {
+        deviation = std::max (deviation, std::fabs (frame[i] - state[i]));                         // Getting maximum error...
+      }
+
+      std::cout << "seek     = frame " << in.size () - 1 << " (step " << steps << ") in " << t << " ms, max error = "
+                << deviation << " m (quantum = " << quantum << " m)" << std::endl;
+    }
+  }
+
+  if(json != "")
+  {
+    result.write (json);                                                                            // Writing JSON report...
+    std::cout << "report   = " << json << std::endl;
+  }
+
+  if(baseline != "")
+  {
+    if(!base.read (baseline))
+    {
+      std::cout << "baseline = none (" << baseline << " not found: store one first)" << std::endl;
+    }
+    else if((base.get ("device") != result.get ("device")) || (base.get ("nodes") != result.get ("nodes")) ||
+            (base.get ("steps") != result.get ("steps")))
+    {
+      std::cout << "baseline = skipped (" << baseline << " is for another device or problem)" << std::endl;
+    }
+    else if(rate < (1.0 - tolerance)*std::atof (base.get ("steps_per_s").c_str ()))
+    {
+      std::cout << "baseline = REGRESSION: " << rate << " steps/s < " << base.get ("steps_per_s")
+                << " steps/s - " << 100.0f*tolerance << "%" << std::endl;
+      status = EXIT_FAILURE;                                                                        // Failing...
+    }
+    else
+    {
+      std::cout << "baseline = ok (" << base.get ("steps_per_s") << " steps/s)" << std::endl;
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////// CLEANUP ////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  for(cl_mem b : buffer)
+  {
+    clReleaseMemObject (b);                                                                         // Releasing buffer...
+  }
+
+  for(std::vector<cl_kernel>* list : {&K_init, &K_step})
+  {
+    for(cl_kernel k : *list)
+    {
+      clReleaseKernel (k);                                                                          // Releasing kernel...
+    }
+  }
+
+  for(cl_program q : program)
+  {
+    clReleaseProgram (q);                                                                           // Releasing program...
+  }
+
+  delete tuner;                                                                                     // Deleting autotuner...
+  delete cache;                                                                                     // Deleting program cache...
+  delete cl;                                                                                        // Deleting OpenCL context...
+  delete fp;                                                                                        // Deleting precision...
+  delete opt;                                                                                       // Deleting command line options...
+
+  return status;
+}
@@ -0,0 +1,177 @@
+/// @file     report.hpp
+/// @brief    JSON benchmark report and baseline comparison.
+///
+/// @details  A report is a flat JSON object of strings and numbers. A stored report is used as the
+/// baseline of later runs on the same device: a run regresses when its steps/s fall below the
+/// baseline steps/s by more than the given tolerance.
+
+#ifndef report_hpp
+#define report_hpp
+
+// INCLUDES:
+#include "clhost.hpp"                                                                               // Raw OpenCL host context.
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex
+{
+/// @class report
+/// @brief Benchmark report.
+class report
+{
+private:
+  std::vector<std::pair<std::string, std::string> > field;                                          ///< Fields (name, JSON value).
+
+  static std::string quote (
+                            std::string loc_text                                                    ///< Text.
+                           );
+
+public:
+  /// @brief **String field.**
+  void        set (
+                   std::string loc_name,                                                            ///< Field name.
+                   std::string loc_value                                                            ///< Value.
+                  );
+
+  /// @brief **Number field.**
+  void        set (
+                   std::string loc_name,                                                            ///< Field name.
+                   double      loc_value                                                            ///< Value.
+                  );
+
+  /// @brief **Field getter.**
+  /// @details Returns the JSON value of a field ("" if missing); strings keep their quotes.
+  std::string get (
+                   std::string loc_name                                                             ///< Field name.
+                  );
+
+  /// @brief **Report writer.**
+  /// @details Writes the report as JSON, creating the parent directory if needed.
+  void        write (
+                     std::string loc_path                                                           ///< JSON file path.
+                    );
+
+  /// @brief **Report reader.**
+  /// @details Reads a report written by write (); returns "false" if the file does not exist.
+  bool        read (
+                    std::string loc_path                                                            ///< JSON file path.
+                   );
+};
+
+inline std::string report::quote (
+                                  std::string loc_text
+                                 )
+{
+  std::string text = "\"";                                                                          // Quoted text.
+
+  for(char c : loc_text)
+  {
+    if((c == '"') || (c == '\\'))
+    {
+      text += '\\';                                                                                 // Escaping character...
+    }
+
+    text += c;                                                                                      // Appending character...
+  }
+
+  return text + "\"";
+}
+
+inline void report::set (
+                         std::string loc_name,
+                         std::string loc_value
+                        )
+{
+  field.push_back ({loc_name, quote (loc_value)});                                                  // Adding string field...
+}
+
+inline void report::set (
+                         std::string loc_name,
+                         double      loc_value
+                        )
+{
+  std::ostringstream number;                                                                        // Number text.
+
+  number.precision (9);                                                                             // Setting precision...
+  number << loc_value;                                                                              // Printing number...
+  field.push_back ({loc_name, number.str ()});                                                      // Adding number field...
+}
+
+inline std::string report::get (
+                                std::string loc_name
+                               )
+{
+  for(const auto& f : field)
+  {
+    if(f.first == loc_name)
+    {
+      return f.second;
+    }
+  }
+
+  return "";
+}
+
+inline void report::write (
+                           std::string loc_path
+                          )
+{
+  std::filesystem::path path (loc_path);                                                            // Report path.
+  std::ofstream         file;                                                                       // Report file.
+
+  if(path.has_parent_path ())
+  {
+    std::filesystem::create_directories (path.parent_path ());                                      // Creating directory...
+  }
+
+  file.open (loc_path);                                                                             // Opening file...
+  file << "{" << std::endl;
+
+  for(size_t i = 0; i < field.size (); i++)
+  {
+    file << "  " << quote (field[i].first) << ": " << field[i].second
+         << ((i + 1 < field.size ()) ? "," : "") << std::endl;                                      // Writing field...
+  }
+
+  file << "}" << std::endl;
+}
+
+inline bool report::read (
+                          std::string loc_path
+                         )
+{
+  std::ifstream file (loc_path);                                                                    // Report file.
+  std::string   line;                                                                               // Report line.
+  size_t        colon;                                                                              // Name/value separator.
+
+  if(!file)
+  {
+    return false;
+  }
+
+  field.clear ();                                                                                   // Clearing fields...
+
+  while(std::getline (file, line))
+  {
+    colon = line.find ("\": ");                                                                     // Finding separator...
+
+    if(colon == std::string::npos)
+    {
+      continue;                                                                                     // Skipping braces...
+    }
+
+    line = line.substr (0, line.find_last_not_of (",") + 1);                                        // Removing trailing comma...
+    field.push_back ({line.substr (line.find ('"') + 1, colon - line.find ('"') - 1),
+                      line.substr (colon + 3)});                                                    // Adding field...
+  }
+
+  return true;
+}
+}
+
+#endif
@@ -0,0 +1,134 @@
+/// @file
+
+// ENSEMBLE (MEMBER_NODES = nodes per member, see ensemble.hpp; single member otherwise):
+#ifdef MEMBER_NODES
+  #define MEMBER (i/MEMBER_NODES)                                               // Ensemble member of node "i".
+#else
+  #define MEMBER 0                                                              // Ensemble member (single member).
+#endif
+
+/// @brief **Collision kernel.**
+/// @details It finds the contacts of each node in its hash cell and in the 26 cells around it,
+/// and sets its collision force: a penalty force, with the stiffness of the cloth links, pushing
+/// apart any two nodes closer than CONTACT_RADIUS that are not linked by a spring.
+__kernel void thekernel(__global float4*    color,                              // Color.
+                        __global float4*    position_gl,                        // Position (plotted copy).
+                        __global STATE4*    velocity,                           // Velocity.
+                        __global STATE4*    acceleration,                       // Acceleration.
+                        __global POSITION4* position_int,                       // Position (intermediate).
+                        __global STATE4*    velocity_int,                       // Velocity (intermediate).
+                        __global float4*    gravity,                            // Gravity.
+                        __global float*     stiffness,                          // Stiffness.
+                        __global float*     resting,                            // Resting distance.
+                        __global float*     friction,                           // Friction.
+                        __global float*     mass,                               // Mass.
+                        __global int*       encoding,                           // Neighbour index encoding.
+                        __global int*       nearest,                            // Neighbour.
+                        __global int*       offset,                             // Offset.
+                        __global int*       freedom,                            // Freedom flag.
+                        __global float*     dt_simulation,                      // Simulation time step.
+                        __global float*     parameter,                          // Initialization parameters.
+                        __global int*       cell,                               // Hash cell of each node.
+                        __global int*       count,                              // Nodes in each hash cell.
+                        __global int*       start,                              // First sorted node of each hash cell.
+                        __global int*       sorted,                             // Nodes sorted by hash cell.
+                        __global int*       block,                              // Hash cell block sums.
+                        __global float4*    collision,                          // Collision force.
+                        __global int*       tear_rank,                          // Tearing kept link rank.
+                        __global int*       tear_block,                         // Tearing link block sums.
+                        __global float4*    tear_spare,                         // Tearing compaction scratch.
+                        __global int*       tear,                               // Tearing counters.
+                        __constant float4*  material,                           // Material table (m, K, B).
+                        __global uchar*     link_material,                      // Link material id.
+                        __global uchar*     node_material,                      // Node material id.
+                        __global int*       tile_node,                          // Node of each grid cell (tiling).
+                        __global uchar*     tile_link,                          // Stencil code of each link (tiling).
+                        __global POSITION4* position)                           // Position (node state).
+{
+  // PADDING (global size rounded up to a multiple of the local size, see autotune.hpp):
+  #ifdef NODES
+  if (get_global_id(0) >= NODES)
+  {
+    return;                                                                     // Skipping padding work-item...
+  }
+  #endif
+
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int i     = get_global_id(0);                                        // Global index [#].
+  unsigned int j     = 0;                                                       // Neighbour stride index.
+  unsigned int j_min = STRIDE_MIN(i);                                           // Neighbour stride minimun index.
+  unsigned int j_max = STRIDE_MAX(i);                                           // Neighbour stride maximum index.
+  int          s     = 0;                                                       // Sorted slot index.
+  int          s_min = 0;                                                       // Sorted slot minimum index.
+  int          s_max = 0;                                                       // Sorted slot maximum index.
+  int          k     = 0;                                                       // Contact node index.
+  int          q     = 0;                                                       // Visited cell index.
+  int          n     = 0;                                                       // Visited cells [#].
+  int          key[27];                                                         // Visited cell keys.
+  bool         linked;                                                          // Spring link flag.
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////// CELL VARIABLES //////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  float4       p     = convert_float4(position_int[i]);                         // Central node position (intermediate).
+  int3         c     = hash_cell(p);                                            // Central node hash cell.
+  int3         d     = (int3)(0, 0, 0);                                         // Hash cell offset.
+  float4       link  = (float4)(0.0f, 0.0f, 0.0f, 0.0f);                        // Contact link.
+  float        L     = 0.0f;                                                    // Contact link length.
+  float        K     = parameter[3*MEMBER + 1];                                 // Contact stiffness (link stiffness).
+  float4       Fc    = (float4)(0.0f, 0.0f, 0.0f, 0.0f);                        // Central node collision force.
+
+  // VISITING 27-CELL NEIGHBOURHOOD:
+  for (d.z = -1; d.z <= 1; d.z++)
+  {
+    for (d.y = -1; d.y <= 1; d.y++)
+    {
+      for (d.x = -1; d.x <= 1; d.x++)
+      {
+        key[n] = hash_key(c + d);                                               // Computing cell key...
+
+        // SKIPPING CELLS HASHED TO AN ALREADY VISITED KEY:
+        for (q = 0; q < n; q++)
+        {
+          if (key[q] == key[n]) break;
+        }
+
+        if (q < n) continue;
+
+        s_min = max(start[key[n]], 0);                                          // Getting first node of the cell...
+        s_max = min(start[key[n]] + count[key[n]], HASH_CELLS);                 // Getting end of the cell...
+        n++;                                                                    // Counting visited cell...
+
+        for (s = s_min; s < s_max; s++)
+        {
+          k    = sorted[s];                                                     // Getting candidate node...
+          link = p - convert_float4(position_int[k]);                           // Getting contact link...
+          link.w = 0.0f;                                                        // Adjusting projective space...
+          L    = length(link);                                                  // Computing contact link length...
+
+          if ((k == i) || (L >= CONTACT_RADIUS) || (L == 0.0f))
+          {
+            continue;                                                           // Skipping self and far nodes...
+          }
+
+          // SKIPPING SPRING NEIGHBOURS:
+          linked = false;
+
+          for (j = j_min; j < j_max; j += LINK_STEP)
+          {
+            linked = linked || (neighbour_index(nearest, encoding[0], j, i) == k);
+          }
+
+          if (!linked)
+          {
+            Fc += K*(CONTACT_RADIUS - L)*link/L;                                // Building up collision force...
+          }
+        }
+      }
+    }
+  }
+
+  collision[i] = Fc;                                                            // Storing collision force...
+}
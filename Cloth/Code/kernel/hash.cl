@@ -0,0 +1,26 @@
+/// @file     hash.cl
+/// @brief    Uniform spatial hash grid for the self-collision broad phase.
+/// @details  Space is divided into cubic cells of side HASH_CELL, not smaller than the contact
+/// radius, so that all the contacts of a node lie in its own cell or in one of the 26 around it.
+/// Cells are hashed into a table of HASH_CELLS entries (one per node). Every step the table is
+/// rebuilt on the device by a counting sort of the nodes by cell key: clear, count (atomic),
+/// exclusive scan of the counts (block sums, block offsets, cell offsets) and scatter (atomic).
+/// The cost of each pass is linear in the number of nodes. The host defines HASH_CELL,
+/// HASH_CELLS, HASH_BLOCKS and CONTACT_RADIUS, see the "--collision" option.
+
+#ifndef HASH_BLOCK
+  #define HASH_BLOCK 256                                                        // Hash cells per scan block.
+#endif
+
+/// @brief **Hash cell of a position.**
+int3 hash_cell (float4 p)
+{
+  return convert_int3(floor(p.xyz/HASH_CELL));
+}
+
+/// @brief **Hash key of a cell.**
+/// @details Large primes XOR hash, in [0, HASH_CELLS).
+int hash_key (int3 c)
+{
+  return (int)((((uint)c.x)*73856093u ^ ((uint)c.y)*19349663u ^ ((uint)c.z)*83492791u)%HASH_CELLS);
+}
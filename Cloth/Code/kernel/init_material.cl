@@ -0,0 +1,71 @@
+/// @file
+
+// ENSEMBLE (MEMBER_NODES = nodes per member, see ensemble.hpp; single member otherwise):
+#ifdef MEMBER_NODES
+  #define MEMBER (i/MEMBER_NODES)                                               // Ensemble member of node "i".
+#else
+  #define MEMBER 0                                                              // Ensemble member (single member).
+#endif
+
+/// @brief **Material kernel.**
+/// @details It sets the mass of each node to parameter[0] and the stiffness of its links to
+/// parameter[1], directly on the device. In an ensemble, each member has its own {m, K, L_max}
+/// triple at parameter[3*member]. With MATERIALS, both are read from the material table (see
+/// materials.hpp) and nothing is set.
+__kernel void thekernel(__global float4*    color,                              // Color.
+                        __global float4*    position_gl,                        // Position (plotted copy).
+                        __global float4*    velocity,                           // Velocity.
+                        __global float4*    acceleration,                       // Acceleration.
+                        __global float4*    position_int,                       // Position (intermediate).
+                        __global float4*    velocity_int,                       // Velocity (intermediate).
+                        __global float4*    gravity,                            // Gravity.
+                        __global float*     stiffness,                          // Stiffness.
+                        __global float*     resting,                            // Resting distance.
+                        __global float*     friction,                           // Friction.
+                        __global float*     mass,                               // Mass.
+                        __global int*       encoding,                           // Neighbour index encoding.
+                        __global int*       nearest,                            // Neighbour.
+                        __global int*       offset,                             // Offset.
+                        __global int*       freedom,                            // Freedom flag.
+                        __global float*     dt_simulation,                      // Simulation time step.
+                        __global float*     parameter,                          // Initialization parameters.
+                        __global int*       cell,                               // Hash cell of each node.
+                        __global int*       count,                              // Nodes in each hash cell.
+                        __global int*       start,                              // First sorted node of each hash cell.
+                        __global int*       sorted,                             // Nodes sorted by hash cell.
+                        __global int*       block,                              // Hash cell block sums.
+                        __global float4*    collision,                          // Collision force.
+                        __global int*       tear_rank,                          // Tearing kept link rank.
+                        __global int*       tear_block,                         // Tearing link block sums.
+                        __global float4*    tear_spare,                         // Tearing compaction scratch.
+                        __global int*       tear,                               // Tearing counters.
+                        __constant float4*  material,                           // Material table (m, K, B).
+                        __global uchar*     link_material,                      // Link material id.
+                        __global uchar*     node_material,                      // Node material id.
+                        __global int*       tile_node,                          // Node of each grid cell (tiling).
+                        __global uchar*     tile_link,                          // Stencil code of each link (tiling).
+                        __global float4*    position)                           // Position (node state).
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int i = get_global_id(0);                                            // Global index [#].
+  unsigned int j = 0;                                                           // Neighbour stride index.
+  unsigned int j_min = 0;                                                       // Neighbour stride minimun index.
+  unsigned int j_max = STRIDE_MAX(i);                                           // Neighbour stride maximum index.
+  float        m     = parameter[3*MEMBER + 0];                                 // Node mass [kg].
+  float        K     = parameter[3*MEMBER + 1];                                 // Link stiffness [kg/s^2].
+
+  // COMPUTING STRIDE MINIMUM INDEX:
+  j_min = STRIDE_MIN(i);                                                        // Setting stride minimum...
+
+  // SETTING MATERIAL (per-link and per-node arrays only):
+#ifndef MATERIALS
+  mass[i] = m;                                                                  // Setting mass...
+
+  for (j = j_min; j < j_max; j += LINK_STEP)
+  {
+    stiffness[j] = K;                                                           // Setting link stiffness...
+  }
+#endif
+}
@@ -0,0 +1,22 @@
+/// @file     tear.cl
+/// @brief    Cloth tearing with on-device compaction of the neighbour lists.
+/// @details  A link breaks when its strain exceeds TEAR times its resting length: thekernel_2
+/// releases it (no elastic force) and hides it (color alpha = 0) in place, counting it in tear[0].
+/// Once TEAR_COMPACT links have broken, the neighbour lists are compacted on the device by a
+/// stream compaction of the kept links: block sums, block offsets (exclusive scan), packing into
+/// the spare array with the inclusive rank of each link, and unpacking with the node offsets
+/// remapped through the ranks. The number of live links is kept in tear[1], tear[2] flags a
+/// compaction in progress. The host never reads the lists back: it reads the counters once per
+/// frame and draws tear[1] links only, so the links past the live total are never invoked. The
+/// geometry shader still skips the broken links not compacted yet. The host defines TEAR, TEAR_COMPACT, TEAR_BLOCK, TEAR_BLOCKS and LINKS, see the "--tear" option.
+
+#ifndef TEAR_BLOCK
+  #define TEAR_BLOCK 64                                                         // Links per scan block.
+#endif
+
+/// @brief **Kept link test.**
+/// @details Broken links (and the tail left by a compaction) have a transparent color.
+bool tear_kept (float4 c)
+{
+  return c.w != 0.0f;
+}
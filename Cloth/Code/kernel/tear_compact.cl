@@ -0,0 +1,86 @@
+/// @file
+
+/// @brief **Tear compaction kernel.**
+/// @details It remaps the offset of each node through the link ranks (the new end of a stride is
+/// the number of kept links before it) and unpacks the links of a block from the spare array. The
+/// links past the live total are cleared (transparent, no stiffness).
+__kernel void thekernel(__global float4*    color,                              // Color.
+                        __global float4*    position_gl,                        // Position (plotted copy).
+                        __global float4*    velocity,                           // Velocity.
+                        __global float4*    acceleration,                       // Acceleration.
+                        __global float4*    position_int,                       // Position (intermediate).
+                        __global float4*    velocity_int,                       // Velocity (intermediate).
+                        __global float4*    gravity,                            // Gravity.
+                        __global float*     stiffness,                          // Stiffness.
+                        __global float*     resting,                            // Resting distance.
+                        __global float*     friction,                           // Friction.
+                        __global float*     mass,                               // Mass.
+                        __global int*       encoding,                           // Neighbour index encoding.
+                        __global int*       nearest,                            // Neighbour.
+                        __global int*       offset,                             // Offset.
+                        __global int*       freedom,                            // Freedom flag.
+                        __global float*     dt_simulation,                      // Simulation time step.
+                        __global float*     parameter,                          // Initialization parameters.
+                        __global int*       cell,                               // Hash cell of each node.
+                        __global int*       count,                              // Nodes in each hash cell.
+                        __global int*       start,                              // First sorted node of each hash cell.
+                        __global int*       sorted,                             // Nodes sorted by hash cell.
+                        __global int*       block,                              // Hash cell block sums.
+                        __global float4*    collision,                          // Collision force.
+                        __global int*       tear_rank,                          // Tearing kept link rank.
+                        __global int*       tear_block,                         // Tearing link block sums.
+                        __global float4*    tear_spare,                         // Tearing compaction scratch.
+                        __global int*       tear,                               // Tearing counters.
+                        __constant float4*  material,                           // Material table (m, K, B).
+                        __global uchar*     link_material,                      // Link material id.
+                        __global uchar*     node_material,                      // Node material id.
+                        __global int*       tile_node,                          // Node of each grid cell (tiling).
+                        __global uchar*     tile_link,                          // Stencil code of each link (tiling).
+                        __global float4*    position)                           // Position (node state).
+{
+  // PADDING (global size rounded up to a multiple of the local size, see autotune.hpp):
+  #ifdef NODES
+  if (get_global_id(0) >= NODES)
+  {
+    return;                                                                     // Skipping padding work-item...
+  }
+  #endif
+
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int i   = get_global_id(0);                                          // Global index [#].
+  unsigned int j   = 0;                                                         // Link index [#].
+  int          o   = offset[i];                                                 // Node stride end (before compaction) [#].
+  int          n   = tear[1];                                                   // Live links [#].
+
+  if (tear[2] == 0)
+  {
+    return;                                                                     // Skipping work-item (no compaction)...
+  }
+
+  // REMAPPING NODE OFFSET:
+  offset[i] = (o == 0) ? 0 : tear_rank[o - 1];                                  // Setting stride end...
+
+  if (i >= TEAR_BLOCKS)
+  {
+    return;                                                                     // Skipping work-item without block...
+  }
+
+  // UNPACKING LINKS:
+  for (j = i*TEAR_BLOCK; j < min((i + 1)*TEAR_BLOCK, (unsigned int)LINKS); j++)
+  {
+    if (j < n)
+    {
+      nearest[j]   = as_int(tear_spare[2*j + 0].x);                             // Unpacking neighbour...
+      resting[j]   = tear_spare[2*j + 0].y;                                     // Unpacking resting length...
+      stiffness[j] = tear_spare[2*j + 0].z;                                     // Unpacking stiffness...
+      color[j]     = tear_spare[2*j + 1];                                       // Unpacking color...
+    }
+    else
+    {
+      stiffness[j] = 0.0f;                                                      // Clearing tail stiffness...
+      color[j]     = (float4)(0.0f, 0.0f, 0.0f, 0.0f);                          // Clearing tail color...
+    }
+  }
+}
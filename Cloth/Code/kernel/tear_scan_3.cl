@@ -0,0 +1,75 @@
+/// @file
+
+/// @brief **Tear scan kernel (packing).**
+/// @details It packs the kept links of a block into the spare array from the block offset
+/// (neighbour, resting length and stiffness, then color) and stores the inclusive rank of each
+/// link, used by the compaction kernel to remap the node offsets.
+__kernel void thekernel(__global float4*    color,                              // Color.
+                        __global float4*    position_gl,                        // Position (plotted copy).
+                        __global float4*    velocity,                           // Velocity.
+                        __global float4*    acceleration,                       // Acceleration.
+                        __global float4*    position_int,                       // Position (intermediate).
+                        __global float4*    velocity_int,                       // Velocity (intermediate).
+                        __global float4*    gravity,                            // Gravity.
+                        __global float*     stiffness,                          // Stiffness.
+                        __global float*     resting,                            // Resting distance.
+                        __global float*     friction,                           // Friction.
+                        __global float*     mass,                               // Mass.
+                        __global int*       encoding,                           // Neighbour index encoding.
+                        __global int*       nearest,                            // Neighbour.
+                        __global int*       offset,                             // Offset.
+                        __global int*       freedom,                            // Freedom flag.
+                        __global float*     dt_simulation,                      // Simulation time step.
+                        __global float*     parameter,                          // Initialization parameters.
+                        __global int*       cell,                               // Hash cell of each node.
+                        __global int*       count,                              // Nodes in each hash cell.
+                        __global int*       start,                              // First sorted node of each hash cell.
+                        __global int*       sorted,                             // Nodes sorted by hash cell.
+                        __global int*       block,                              // Hash cell block sums.
+                        __global float4*    collision,                          // Collision force.
+                        __global int*       tear_rank,                          // Tearing kept link rank.
+                        __global int*       tear_block,                         // Tearing link block sums.
+                        __global float4*    tear_spare,                         // Tearing compaction scratch.
+                        __global int*       tear,                               // Tearing counters.
+                        __constant float4*  material,                           // Material table (m, K, B).
+                        __global uchar*     link_material,                      // Link material id.
+                        __global uchar*     node_material,                      // Node material id.
+                        __global int*       tile_node,                          // Node of each grid cell (tiling).
+                        __global uchar*     tile_link,                          // Stencil code of each link (tiling).
+                        __global float4*    position)                           // Position (node state).
+{
+  // PADDING (global size rounded up to a multiple of the local size, see autotune.hpp):
+  #ifdef NODES
+  if (get_global_id(0) >= NODES)
+  {
+    return;                                                                     // Skipping padding work-item...
+  }
+  #endif
+
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int i   = get_global_id(0);                                          // Global index [#].
+  unsigned int j   = 0;                                                         // Link index [#].
+  int          r   = 0;                                                         // Kept link rank [#].
+
+  if ((i >= TEAR_BLOCKS) || (tear[2] == 0))
+  {
+    return;                                                                     // Skipping work-item without block (or compaction)...
+  }
+
+  r = tear_block[i];                                                            // Getting block offset...
+
+  // PACKING KEPT LINKS:
+  for (j = i*TEAR_BLOCK; j < min((i + 1)*TEAR_BLOCK, (unsigned int)LINKS); j++)
+  {
+    if (tear_kept(color[j]))
+    {
+      tear_spare[2*r + 0] = (float4)(as_float(nearest[j]), resting[j], stiffness[j], 0.0f);  // Packing link...
+      tear_spare[2*r + 1] = color[j];                                           // Packing link color...
+      r++;                                                                      // Advancing rank...
+    }
+
+    tear_rank[j] = r;                                                           // Setting inclusive rank...
+  }
+}
@@ -1,22 +1,59 @@
 /// @file
 
+// ENSEMBLE (MEMBER_NODES = nodes per member, see ensemble.hpp; single member otherwise):
+#ifdef MEMBER_NODES
+  #define MEMBER (i/MEMBER_NODES)                                               // Ensemble member of node "i".
+#else
+  #define MEMBER 0                                                              // Ensemble member (single member).
+#endif
+
+// SPECIALIZATION (values injected at build time, see specialization.hpp; runtime otherwise):
+#ifndef DT_SIMULATION
+  #define DT_SIMULATION dt_simulation[MEMBER]                                   // Simulation time step (runtime).
+#endif
+
 __kernel void thekernel(__global float4*    color,                              // Color.
-                        __global float4*    position,                           // Position.
-                        __global float4*    position_int,                       // Position (intermediate).
-                        __global float4*    velocity,                           // Velocity.
-                        __global float4*    velocity_int,                       // Velocity (intermediate).
-                        __global float4*    acceleration,                       // Acceleration.
+                        __global float4*    position_gl,                        // Position (plotted copy).
+                        __global STATE4*    velocity,                           // Velocity.
+                        __global STATE4*    acceleration,                       // Acceleration.
+                        __global POSITION4* position_int,                       // Position (intermediate).
+                        __global STATE4*    velocity_int,                       // Velocity (intermediate).
                         __global float4*    gravity,                            // Gravity.
                         __global float*     stiffness,                          // Stiffness.
                         __global float*     resting,                            // Resting distance.
                         __global float*     friction,                           // Friction.
                         __global float*     mass,                               // Mass.
-                        __global int*       central,                            // Node.
+                        __global int*       encoding,                           // Neighbour index encoding.
                         __global int*       nearest,                            // Neighbour.
                         __global int*       offset,                             // Offset.
                         __global int*       freedom,                            // Freedom flag.
-                        __global float*     dt_simulation)                      // Simulation time step.
+                        __global float*     dt_simulation,                      // Simulation time step.
+                        __global float*     parameter,                          // Initialization parameters.
+                        __global int*       cell,                               // Hash cell of each node.
+                        __global int*       count,                              // Nodes in each hash cell.
+                        __global int*       start,                              // First sorted node of each hash cell.
+                        __global int*       sorted,                             // Nodes sorted by hash cell.
+                        __global int*       block,                              // Hash cell block sums.
+                        __global float4*    collision,                          // Collision force.
+                        __global int*       tear_rank,                          // Tearing kept link rank.
+                        __global int*       tear_block,                         // Tearing link block sums.
+                        __global float4*    tear_spare,                         // Tearing compaction scratch.
+                        __global int*       tear,                               // Tearing counters.
+                        __constant float4*  material,                           // Material table (m, K, B).
+                        __global uchar*     link_material,                      // Link material id.
+                        __global uchar*     node_material,                      // Node material id.
+                        __global int*       tile_node,                          // Node of each grid cell (tiling).
+                        __global uchar*     tile_link,                          // Stencil code of each link (tiling).
+                        __global POSITION4* position)                           // Position (node state).
 {
+  // PADDING (global size rounded up to a multiple of the local size, see autotune.hpp):
+  #ifdef NODES
+  if (get_global_id(0) >= NODES)
+  {
+    return;                                                                     // Skipping padding work-item...
+  }
+  #endif
+
   ////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// INDEXES ///////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////
@@ -25,26 +62,26 @@ __kernel void thekernel(__global float4*    color,
   ////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////// CELL VARIABLES //////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////
-  float4        p                 = position[i];                                // Central node position.
-  float4        v                 = velocity[i];                                // Central node velocity.
-  float4        a                 = acceleration[i];                            // Central node acceleration.
-  float4        p_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node position. 
+  ACC4          p                 = TO_ACC4(position[i]);                       // Central node position.
+  REAL4         v                 = TO_REAL4(velocity[i]);                      // Central node velocity.
+  REAL4         a                 = TO_REAL4(acceleration[i]);                  // Central node acceleration.
+  ACC4          p_new             = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Central node position.
   float         fr                = freedom[i];                                 // Central node freedom flag.
-  float         dt                = dt_simulation[0];                           // Simulation time step [s].
+  REAL          dt                = DT_SIMULATION;                              // Simulation time step [s].
 
   // APPLYING FREEDOM CONSTRAINTS:
   if (fr == 0)
   {
-    v = (float4)(0.0f, 0.0f, 0.0f, 1.0f);                                       // Constraining velocity...
-    a = (float4)(0.0f, 0.0f, 0.0f, 1.0f);                                       // Constraining acceleration...
+    v = (REAL4)(0.0f, 0.0f, 0.0f, 1.0f);                                        // Constraining velocity...
+    a = (REAL4)(0.0f, 0.0f, 0.0f, 1.0f);                                        // Constraining acceleration...
   }
   
   // COMPUTING NEW POSITION:
-  p_new = p + v*dt + 0.5f*a*dt*dt;                                              // Computing Taylor's approximation...
+  p_new = p + TO_ACC4(v*dt + 0.5f*a*dt*dt);                                     // Computing Taylor's approximation...
   
   // UPDATING INTERMEDIATE POSITION:
-  position_int[i] = p_new;                                                      // Updating intermediate position...
-  velocity_int[i] = v + a*dt;                                                   // Updating intermediate velocity...
+  position_int[i] = TO_POSITION4(p_new);                                        // Updating intermediate position...
+  velocity_int[i] = TO_STATE4(v + a*dt);                                        // Updating intermediate velocity...
 
   // FIXING PROJECTIVE SPACE:
   position_int[i].w = 1.0f;                                                     // Adjusting projective space...
@@ -0,0 +1,387 @@
+/// @file     cloth_cpu.hpp
+/// @brief    CPU backend of the Cloth kernels (thekernel_1.cl, thekernel_2.cl).
+///
+/// @details  Same physics over the same Neutrino arrays: kernel_1 () and kernel_2 () are
+/// line-by-line ports of the two OpenCL kernels for global index "i"; kernel_1_lanes () and
+/// kernel_2_lanes () run the same operations, in the same order, on four consecutive nodes across
+/// the SIMD lanes (see cpu_backend.hpp).
+
+#ifndef cloth_cpu_hpp
+#define cloth_cpu_hpp
+
+// INCLUDES:
+#include "nu.hpp"                                                                                   // Neutrino header file.
+#include "colormap.hpp"                                                                             // Turbo colormap.
+#include "cpu_backend.hpp"                                                                          // CPU backend.
+
+namespace ex
+{
+/// @class cloth_cpu
+/// @brief Cloth simulation on the CPU backend.
+class cloth_cpu
+{
+private:
+  nu::float4* color;                                                                                ///< Color.
+  nu::float4* position;                                                                             ///< Position.
+  nu::float4* velocity;                                                                             ///< Velocity.
+  nu::float4* acceleration;                                                                         ///< Acceleration.
+  nu::float4* position_int;                                                                         ///< Position (intermediate).
+  nu::float4* velocity_int;                                                                         ///< Velocity (intermediate).
+  nu::float4* gravity;                                                                              ///< Gravity.
+  nu::float1* stiffness;                                                                            ///< Stiffness.
+  nu::float1* resting;                                                                              ///< Resting distance.
+  nu::float1* friction;                                                                             ///< Friction.
+  nu::float1* mass;                                                                                 ///< Mass.
+  nu::int1*   encoding;                                                                             ///< Neighbour index encoding (32-bit indices only).
+  nu::int1*   nearest;                                                                              ///< Neighbour.
+  nu::int1*   offset;                                                                               ///< Offset.
+  nu::int1*   freedom;                                                                              ///< Freedom flag.
+  nu::float1* dt_simulation;                                                                        ///< Simulation time step.
+
+public:
+  std::vector<std::vector<nu_float4_structure>*> state;                                             ///< Kinematic state arrays.
+
+  /// @brief **Class constructor.**
+  /// @details Takes the same data objects as the OpenCL kernels, in the same order.
+  cloth_cpu (
+             nu::float4* loc_color,                                                                 ///< Color.
+             nu::float4* loc_position,                                                              ///< Position.
+             nu::float4* loc_velocity,                                                              ///< Velocity.
+             nu::float4* loc_acceleration,                                                          ///< Acceleration.
+             nu::float4* loc_position_int,                                                          ///< Position (intermediate).
+             nu::float4* loc_velocity_int,                                                          ///< Velocity (intermediate).
+             nu::float4* loc_gravity,                                                               ///< Gravity.
+             nu::float1* loc_stiffness,                                                             ///< Stiffness.
+             nu::float1* loc_resting,                                                               ///< Resting distance.
+             nu::float1* loc_friction,                                                              ///< Friction.
+             nu::float1* loc_mass,                                                                  ///< Mass.
+             nu::int1*   loc_encoding,                                                              ///< Neighbour index encoding (32-bit indices only).
+             nu::int1*   loc_nearest,                                                               ///< Neighbour.
+             nu::int1*   loc_offset,                                                                ///< Offset.
+             nu::int1*   loc_freedom,                                                               ///< Freedom flag.
+             nu::float1* loc_dt_simulation                                                          ///< Simulation time step.
+            );
+
+  /// @brief **Predictor (thekernel_1.cl).**
+  void kernel_1 (
+                 size_t loc_i                                                                       ///< Global index.
+                );
+
+  /// @brief **Corrector (thekernel_2.cl).**
+  void kernel_2 (
+                 size_t loc_i                                                                       ///< Global index.
+                );
+
+  /// @brief **Predictor on four nodes (thekernel_1.cl).**
+  void kernel_1_lanes (
+                       size_t loc_i                                                                 ///< First global index.
+                      );
+
+  /// @brief **Corrector on four nodes (thekernel_2.cl).**
+  void kernel_2_lanes (
+                       size_t loc_i                                                                 ///< First global index.
+                      );
+
+  /// @brief **Simulation step.**
+  /// @details Runs kernel_1 and then kernel_2 over all nodes on the thread pool, four nodes at a
+  /// time and the remainder of each chunk one node at a time.
+  void step (
+             cpu_backend* loc_cpu                                                                   ///< CPU backend.
+            );
+};
+
+inline cloth_cpu::cloth_cpu (
+                             nu::float4* loc_color,
+                             nu::float4* loc_position,
+                             nu::float4* loc_velocity,
+                             nu::float4* loc_acceleration,
+                             nu::float4* loc_position_int,
+                             nu::float4* loc_velocity_int,
+                             nu::float4* loc_gravity,
+                             nu::float1* loc_stiffness,
+                             nu::float1* loc_resting,
+                             nu::float1* loc_friction,
+                             nu::float1* loc_mass,
+                             nu::int1*   loc_encoding,
+                             nu::int1*   loc_nearest,
+                             nu::int1*   loc_offset,
+                             nu::int1*   loc_freedom,
+                             nu::float1* loc_dt_simulation
+                            )
+{
+  color         = loc_color;                                                                        // Setting color...
+  position      = loc_position;                                                                     // Setting position...
+  velocity      = loc_velocity;                                                                     // Setting velocity...
+  acceleration  = loc_acceleration;                                                                 // Setting acceleration...
+  position_int  = loc_position_int;                                                                 // Setting intermediate position...
+  velocity_int  = loc_velocity_int;                                                                 // Setting intermediate velocity...
+  gravity       = loc_gravity;                                                                      // Setting gravity...
+  stiffness     = loc_stiffness;                                                                    // Setting stiffness...
+  resting       = loc_resting;                                                                      // Setting resting distance...
+  friction      = loc_friction;                                                                     // Setting friction...
+  mass          = loc_mass;                                                                         // Setting mass...
+  encoding      = loc_encoding;                                                                     // Setting neighbour index encoding...
+  nearest       = loc_nearest;                                                                      // Setting neighbours...
+  offset        = loc_offset;                                                                       // Setting offsets...
+  freedom       = loc_freedom;                                                                      // Setting freedom flags...
+  dt_simulation = loc_dt_simulation;                                                                // Setting time step...
+  state         = {&position->data, &velocity->data, &acceleration->data, &position_int->data,
+                   &velocity_int->data};                                                            // Setting kinematic state...
+}
+
+inline void cloth_cpu::kernel_1 (
+                                 size_t loc_i
+                                )
+{
+  vec4  p  = position->data[loc_i];                                                                 // Central node position.
+  vec4  v  = velocity->data[loc_i];                                                                 // Central node velocity.
+  vec4  a  = acceleration->data[loc_i];                                                             // Central node acceleration.
+  float dt = dt_simulation->data[0];                                                                // Simulation time step [s].
+
+  // APPLYING FREEDOM CONSTRAINTS:
+  if(freedom->data[loc_i] == 0)
+  {
+    v = vec4 (0.0f, 0.0f, 0.0f, 1.0f);                                                              // Constraining velocity...
+    a = vec4 (0.0f, 0.0f, 0.0f, 1.0f);                                                              // Constraining acceleration...
+  }
+
+  // UPDATING INTERMEDIATE POSITION AND VELOCITY:
+  (p + v*dt + 0.5f*a*dt*dt).with_w (1.0f).store (position_int->data[loc_i]);                        // Computing Taylor's approximation...
+  (v + a*dt).with_w (1.0f).store (velocity_int->data[loc_i]);                                       // Updating intermediate velocity...
+}
+
+inline void cloth_cpu::kernel_1_lanes (
+                                       size_t loc_i
+                                      )
+{
+  std::vector<nu_float4_structure>& P = position->data;                                             // Position.
+  std::vector<nu_float4_structure>& V = velocity->data;                                             // Velocity.
+  std::vector<nu_float4_structure>& A = acceleration->data;                                         // Acceleration.
+  std::vector<nu_float4_structure>& Q = position_int->data;                                         // Position (intermediate).
+  std::vector<nu_float4_structure>& U = velocity_int->data;                                         // Velocity (intermediate).
+  size_t                            n = loc_i;                                                      // First node index.
+  soa4                              p (P[n], P[n + 1], P[n + 2], P[n + 3]);                         // Central node positions.
+  soa4                              v (V[n], V[n + 1], V[n + 2], V[n + 3]);                         // Central node velocities.
+  soa4                              a (A[n], A[n + 1], A[n + 2], A[n + 3]);                         // Central node accelerations.
+  soa4                              rest (0.0f, 0.0f, 0.0f, 1.0f);                                  // Constrained kinematics.
+  lane4                             dt   = dt_simulation->data[0];                                  // Simulation time step [s].
+  lane4                             free (float (freedom->data[n]), float (freedom->data[n + 1]),
+                                          float (freedom->data[n + 2]), float (freedom->data[n + 3])); // Freedom flags.
+
+  // APPLYING FREEDOM CONSTRAINTS:
+  v = select (free, v, rest);                                                                       // Constraining velocity...
+  a = select (free, a, rest);                                                                       // Constraining acceleration...
+
+  // UPDATING INTERMEDIATE POSITION AND VELOCITY:
+  (p + v*dt + 0.5f*a*dt*dt).with_w (1.0f).store (Q[n], Q[n + 1], Q[n + 2], Q[n + 3]);               // Computing Taylor's approximation...
+  (v + a*dt).with_w (1.0f).store (U[n], U[n + 1], U[n + 2], U[n + 3]);                              // Updating intermediate velocity...
+}
+
+inline void cloth_cpu::kernel_2 (
+                                 size_t loc_i
+                                )
+{
+  size_t j;                                                                                         // Neighbour stride index.
+  size_t j_min = (loc_i == 0) ? 0 : offset->data[loc_i - 1];                                        // Neighbour stride minimum index.
+  size_t j_max = offset->data[loc_i];                                                               // Neighbour stride maximum index.
+  size_t n     = loc_i;                                                                             // Node index (implicit central node).
+  vec4   v     = velocity->data[n];                                                                 // Central node velocity.
+  vec4   a     = acceleration->data[n];                                                             // Central node acceleration.
+  vec4   p_int = position_int->data[n];                                                             // Central node position (intermediate).
+  vec4   v_int = velocity_int->data[n];                                                             // Central node velocity (intermediate).
+  vec4   g     = gravity->data[0];                                                                  // Gravity field.
+  float  m     = mass->data[n];                                                                     // Central node mass.
+  float  B     = friction->data[0];                                                                 // Friction.
+  float  dt    = dt_simulation->data[0];                                                            // Simulation time step [s].
+  vec4   Fe    = vec4 (0.0f, 0.0f, 0.0f, 1.0f);                                                     // Elastic force.
+  vec4   Fg;                                                                                        // Gravitational force.
+  vec4   a_est;                                                                                     // Acceleration (estimation).
+  vec4   v_est;                                                                                     // Velocity (estimation).
+  vec4   a_new;                                                                                     // Acceleration (new).
+  vec4   v_new;                                                                                     // Velocity (new).
+  vec4   link;                                                                                      // Neighbour link.
+  float  R;                                                                                         // Neighbour link resting length.
+  float  L;                                                                                         // Neighbour link length.
+  float  S;                                                                                         // Neighbour link strain.
+
+  // COMPUTING ELASTIC FORCE:
+  for(j = j_min; j < j_max; j++)
+  {
+    link = vec4 (position_int->data[nearest->data[j]]) - p_int;                                     // Getting neighbour link vector...
+    R    = resting->data[j];                                                                        // Getting neighbour link resting length...
+    L    = link.length3 ();                                                                         // Computing neighbour link length...
+    S    = L - R;                                                                                   // Computing neighbour link strain...
+
+    if(L > 0.0f)
+    {
+      Fe += (stiffness->data[j]*S/L)*link;                                                          // Building up elastic force on central node...
+    }
+
+    if(color->data[j].w != 0.1f)
+    {
+      colormap (0.7f*(1.0f + S/R), color->data[j]);                                                 // Setting color...
+    }
+  }
+
+  // COMPUTING TOTAL FORCE AND NEW ACCELERATION ESTIMATION:
+  Fg    = m*g;                                                                                      // Computing node gravitational force...
+  a_est = (Fg + Fe - B*v_int)/m;                                                                    // Computing acceleration...
+  v_est = v + 0.5f*(a + a_est)*dt;                                                                  // Computing velocity...
+  a_new = (Fg + Fe - B*v_est)/m;                                                                    // Computing acceleration...
+
+  // APPLYING FREEDOM CONSTRAINTS:
+  if(freedom->data[n] == 0)
+  {
+    a_new = vec4 (0.0f, 0.0f, 0.0f, 1.0f);                                                          // Constraining acceleration...
+  }
+
+  v_new = v + 0.5f*(a + a_new)*dt;                                                                  // Computing velocity...
+
+  // APPLYING FREEDOM CONSTRAINTS:
+  if(freedom->data[n] == 0)
+  {
+    v_new = vec4 (0.0f, 0.0f, 0.0f, 1.0f);                                                          // Constraining velocity...
+  }
+
+  // UPDATING KINEMATICS:
+  p_int.store (position->data[n]);                                                                  // Updating position [m]...
+  v_new.with_w (1.0f).store (velocity->data[n]);                                                    // Updating velocity [m/s]...
+  a_new.with_w (1.0f).store (acceleration->data[n]);                                                // Updating acceleration [m/s^2]...
+}
+
+inline void cloth_cpu::kernel_2_lanes (
+                                       size_t loc_i
+                                      )
+{
+  std::vector<nu_float4_structure>& P     = position->data;                                         // Position.
+  std::vector<nu_float4_structure>& V     = velocity->data;                                         // Velocity.
+  std::vector<nu_float4_structure>& A     = acceleration->data;                                     // Acceleration.
+  std::vector<nu_float4_structure>& Q     = position_int->data;                                     // Position (intermediate).
+  std::vector<nu_float4_structure>& U     = velocity_int->data;                                     // Velocity (intermediate).
+  size_t                            n     = loc_i;                                                  // First node index.
+  size_t                            j_min[CPU_BACKEND_LANES];                                       // Neighbour stride minimum index of each node.
+  size_t                            j_max[CPU_BACKEND_LANES];                                       // Neighbour stride maximum index of each node.
+  size_t                            count = strides (offset, n, j_min, j_max);                      // Longest neighbour stride.
+  size_t                            s;                                                              // Neighbour stride position.
+  size_t                            k;                                                              // Lane index.
+  size_t                            j;                                                              // Neighbour stride index.
+  soa4                              v     (V[n], V[n + 1], V[n + 2], V[n + 3]);                     // Central node velocities.
+  soa4                              a     (A[n], A[n + 1], A[n + 2], A[n + 3]);                     // Central node accelerations.
+  soa4                              p_int (Q[n], Q[n + 1], Q[n + 2], Q[n + 3]);                     // Central node positions (intermediate).
+  soa4                              v_int (U[n], U[n + 1], U[n + 2], U[n + 3]);                     // Central node velocities (intermediate).
+  soa4                              g     (gravity->data[0], gravity->data[0], gravity->data[0],
+                                           gravity->data[0]);                                       // Gravity field.
+  soa4                              rest  (0.0f, 0.0f, 0.0f, 1.0f);                                 // Constrained kinematics.
+  lane4                             m     (&mass->data[n]);                                         // Central node masses.
+  lane4                             B     = friction->data[0];                                      // Friction.
+  lane4                             dt    = dt_simulation->data[0];                                 // Simulation time step [s].
+  lane4                             free  (float (freedom->data[n]), float (freedom->data[n + 1]),
+                                           float (freedom->data[n + 2]), float (freedom->data[n + 3])); // Freedom flags.
+  soa4                              Fe    = rest;                                                   // Elastic forces.
+  soa4                              Fg;                                                             // Gravitational forces.
+  soa4                              a_est;                                                          // Accelerations (estimation).
+  soa4                              v_est;                                                          // Velocities (estimation).
+  soa4                              a_new;                                                          // Accelerations (new).
+  soa4                              v_new;                                                          // Velocities (new).
+  soa4                              link;                                                           // Neighbour links.
+  nu_float4_structure               N[CPU_BACKEND_LANES];                                           // Neighbour positions.
+  float                             R[CPU_BACKEND_LANES];                                           // Neighbour link resting lengths.
+  float                             K[CPU_BACKEND_LANES];                                           // Neighbour link stiffnesses.
+  float                             S[CPU_BACKEND_LANES];                                           // Neighbour link strains.
+  lane4                             L;                                                              // Neighbour link lengths.
+  lane4                             strain;                                                         // Neighbour link strains.
+
+  // COMPUTING ELASTIC FORCE:
+  for(s = 0; s < count; s++)
+  {
+    for(k = 0; k < CPU_BACKEND_LANES; k++)
+    {
+      j = j_min[k] + s;                                                                             // Computing neighbour stride index...
+
+      if(j < j_max[k])
+      {
+        N[k] = Q[nearest->data[j]];                                                                 // Getting neighbour position...
+        R[k] = resting->data[j];                                                                    // Getting neighbour link resting length...
+        K[k] = stiffness->data[j];                                                                  // Getting neighbour link stiffness...
+      }
+      else
+      {
+        N[k] = Q[n + k];                                                                            // Padding stride (zero-length link)...
+        R[k] = 1.0f;                                                                                // Padding stride (resting length)...
+        K[k] = 0.0f;                                                                                // Padding stride (no stiffness)...
+      }
+    }
+
+    link   = soa4 (N[0], N[1], N[2], N[3]) - p_int;                                                 // Getting neighbour link vectors...
+    L      = link.length3 ();                                                                       // Computing neighbour link lengths...
+    strain = L - lane4 (R[0], R[1], R[2], R[3]);                                                    // Computing neighbour link strains...
+    Fe    += L.select (lane4 (K[0], K[1], K[2], K[3])*strain/L, 0.0f)*link;                         // Building up elastic force on central nodes...
+    strain.store (S);                                                                               // Getting neighbour link strains...
+
+    for(k = 0; k < CPU_BACKEND_LANES; k++)
+    {
+      j = j_min[k] + s;                                                                             // Computing neighbour stride index...
+
+      if((j < j_max[k]) && (color->data[j].w != 0.1f))
+      {
+        colormap (0.7f*(1.0f + S[k]/R[k]), color->data[j]);                                         // Setting color...
+      }
+    }
+  }
+
+  // COMPUTING TOTAL FORCE AND NEW ACCELERATION ESTIMATION:
+  Fg    = m*g;                                                                                      // Computing node gravitational forces...
+  a_est = (Fg + Fe - B*v_int)/m;                                                                    // Computing accelerations...
+  v_est = v + 0.5f*(a + a_est)*dt;                                                                  // Computing velocities...
+  a_new = (Fg + Fe - B*v_est)/m;                                                                    // Computing accelerations...
+
+  // APPLYING FREEDOM CONSTRAINTS:
+  a_new = select (free, a_new, rest);                                                               // Constraining accelerations...
+  v_new = v + 0.5f*(a + a_new)*dt;                                                                  // Computing velocities...
+  v_new = select (free, v_new, rest);                                                               // Constraining velocities...
+
+  // UPDATING KINEMATICS:
+  p_int.store (P[n], P[n + 1], P[n + 2], P[n + 3]);                                                 // Updating positions [m]...
+  v_new.with_w (1.0f).store (V[n], V[n + 1], V[n + 2], V[n + 3]);                                   // Updating velocities [m/s]...
+  a_new.with_w (1.0f).store (A[n], A[n + 1], A[n + 2], A[n + 3]);                                   // Updating accelerations [m/s^2]...
+}
+
+inline void cloth_cpu::step (
+                             cpu_backend* loc_cpu
+                            )
+{
+  size_t nodes = offset->data.size ();                                                              // Number of nodes.
+
+  loc_cpu->run (nodes, [this] (size_t loc_begin, size_t loc_end)
+  {
+    size_t i;                                                                                       // Node index.
+
+    for(i = loc_begin; i + CPU_BACKEND_LANES <= loc_end; i += CPU_BACKEND_LANES)
+    {
+      kernel_1_lanes (i);                                                                           // Running predictor (four nodes)...
+    }
+
+    for(; i < loc_end; i++)
+    {
+      kernel_1 (i);                                                                                 // Running predictor...
+    }
+  });
+
+  loc_cpu->run (nodes, [this] (size_t loc_begin, size_t loc_end)
+  {
+    size_t i;                                                                                       // Node index.
+
+    for(i = loc_begin; i + CPU_BACKEND_LANES <= loc_end; i += CPU_BACKEND_LANES)
+    {
+      kernel_2_lanes (i);                                                                           // Running corrector (four nodes)...
+    }
+
+    for(; i < loc_end; i++)
+    {
+      kernel_2 (i);                                                                                 // Running corrector...
+    }
+  });
+}
+}
+
+#endif
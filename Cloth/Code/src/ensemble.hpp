@@ -0,0 +1,235 @@
+/// @file     ensemble.hpp
+/// @brief    Ensemble of Cloth parameter sets sharing one mesh topology.
+///
+/// @details  Every member is a full copy of the cloth: node arrays are repeated once per member,
+/// link arrays as well, and node/link indices are shifted by the member's first node/link, so that
+/// all members are run by the same kernels in one NDRange. The kernels find the member of node "i"
+/// as i/MEMBER_NODES and read its friction, time step and material parameters from per-member
+/// arrays. For display, members are laid out side by side on a square grid.
+///
+/// The parameter file has one member per line: `h rho E mu` (thickness [m], mass density
+/// [kg/m^3], Young's modulus [kg/(m*s^2)], viscosity [Pa*s]); empty lines and lines starting
+/// with "#" are ignored.
+
+#ifndef ensemble_hpp
+#define ensemble_hpp
+
+// INCLUDES:
+#include "nu.hpp"                                                                                   // Neutrino header file.
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ex
+{
+/// @class ensemble
+/// @brief Cloth ensemble.
+class ensemble
+{
+public:
+  std::vector<float> h;                                                                             ///< Member thickness [m].
+  std::vector<float> rho;                                                                           ///< Member mass density [kg/m^3].
+  std::vector<float> E;                                                                             ///< Member Young's modulus [kg/(m*s^2)].
+  std::vector<float> mu;                                                                            ///< Member viscosity [Pa*s].
+
+  /// @brief **Class constructor.**
+  /// @details Reads the parameter file ("" = single member, with the example's own parameters).
+  ensemble (
+            std::string loc_path                                                                    ///< Parameter file.
+           );
+
+  /// @brief **Number of members.**
+  size_t size ();
+
+  /// @brief **Number of layout columns.**
+  size_t columns ();
+
+  /// @brief **Array replication.**
+  /// @details Repeats loc_data once per member.
+  template <class T>
+  void   replicate (
+                    std::vector<T>& loc_data                                                        ///< Data.
+                   );
+
+  /// @brief **Index replication.**
+  /// @details Repeats loc_index once per member, shifting the k-th copy by k*loc_shift.
+  template <class T>
+  void   replicate (
+                    std::vector<T>& loc_index,                                                      ///< Indices.
+                    size_t          loc_shift                                                       ///< Index shift per member.
+                   );
+
+  /// @brief **Member layout.**
+  /// @details Translates the k-th copy of the member positions to its cell of a square grid.
+  void   layout (
+                 std::vector<nu_float4_structure>& loc_position,                                    ///< Replicated positions [m].
+                 float                             loc_pitch                                        ///< Grid pitch [m].
+                );
+
+  /// @brief **Member report.**
+  /// @details Prints, for each member, its parameters, time step, simulated time, sag (lowest
+  /// node "z") and maximum node speed.
+  void   report (
+                 std::vector<nu_float4_structure>& loc_position,                                    ///< Replicated positions [m].
+                 std::vector<nu_float4_structure>& loc_velocity,                                    ///< Replicated velocities [m/s].
+                 std::vector<float>&               loc_dt,                                          ///< Member time steps [s].
+                 size_t                            loc_steps                                        ///< Number of steps [#].
+                );
+};
+
+inline ensemble::ensemble (
+                           std::string loc_path
+                          )
+{
+  std::ifstream file;                                                                               // Parameter file.
+  std::string   line;                                                                               // Parameter line.
+  float         value[4];                                                                           // Member parameters.
+
+  if(loc_path == "")
+  {
+    return;
+  }
+
+  file.open (loc_path);                                                                             // Opening parameter file...
+
+  if(!file)
+  {
+    std::cout << "Error: cannot open ensemble file " << loc_path << "." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  while(std::getline (file, line))
+  {
+    std::istringstream fields (line);                                                               // Parameter fields.
+
+    if((line.find_first_not_of (" \t\r") == std::string::npos) || (line[line.find_first_not_of (" \t")] == '#'))
+    {
+      continue;                                                                                     // Skipping empty line or comment...
+    }
+
+    if(!(fields >> value[0] >> value[1] >> value[2] >> value[3]))
+    {
+      std::cout << "Error: bad ensemble line \"" << line << "\" (expected: h rho E mu)." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                     // Exiting...
+    }
+
+    h.push_back (value[0]);                                                                         // Setting thickness...
+    rho.push_back (value[1]);                                                                       // Setting mass density...
+    E.push_back (value[2]);                                                                         // Setting Young's modulus...
+    mu.push_back (value[3]);                                                                        // Setting viscosity...
+  }
+
+  if(h.empty ())
+  {
+    std::cout << "Error: ensemble file " << loc_path << " has no members." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+}
+
+inline size_t ensemble::size ()
+{
+  return std::max (h.size (), size_t (1));
+}
+
+inline size_t ensemble::columns ()
+{
+  return size_t (std::ceil (std::sqrt (double (size ()))));
+}
+
+template <class T>
+inline void ensemble::replicate (
+                                 std::vector<T>& loc_data
+                                )
+{
+  size_t n = loc_data.size ();                                                                      // Member size.
+
+  loc_data.resize (n*size ());                                                                      // Sizing replicated data...
+
+  for(size_t k = 1; k < size (); k++)
+  {
+    std::copy (loc_data.begin (), loc_data.begin () + n, loc_data.begin () + k*n);                  // Copying member...
+  }
+}
+
+template <class T>
+inline void ensemble::replicate (
+                                 std::vector<T>& loc_index,
+                                 size_t          loc_shift
+                                )
+{
+  size_t n = loc_index.size ();                                                                     // Member size.
+
+  replicate (loc_index);                                                                            // Replicating indices...
+
+  for(size_t k = 1; k < size (); k++)
+  {
+    for(size_t j = 0; j < n; j++)
+    {
+      loc_index[k*n + j] += T (k*loc_shift);                                                        // Shifting index...
+    }
+  }
+}
+
+inline void ensemble::layout (
+                              std::vector<nu_float4_structure>& loc_position,
+                              float                             loc_pitch
+                             )
+{
+  size_t n    = loc_position.size ()/size ();                                                       // Member nodes.
+  size_t cols = columns ();                                                                         // Layout columns.
+  size_t rows = (size () + cols - 1)/cols;                                                          // Layout rows.
+  float  x;                                                                                         // Member "x" shift [m].
+  float  y;                                                                                         // Member "y" shift [m].
+
+  for(size_t k = 0; k < size (); k++)
+  {
+    x = (float (k%cols) - 0.5f*(cols - 1))*loc_pitch;                                               // Computing "x" shift...
+    y = (0.5f*(rows - 1) - float (k/cols))*loc_pitch;                                               // Computing "y" shift...
+
+    for(size_t i = k*n; i < (k + 1)*n; i++)
+    {
+      loc_position[i].x += x;                                                                       // Shifting "x"...
+      loc_position[i].y += y;                                                                       // Shifting "y"...
+    }
+  }
+}
+
+inline void ensemble::report (
+                              std::vector<nu_float4_structure>& loc_position,
+                              std::vector<nu_float4_structure>& loc_velocity,
+                              std::vector<float>&               loc_dt,
+                              size_t                            loc_steps
+                             )
+{
+  size_t n = loc_position.size ()/size ();                                                          // Member nodes.
+  float  z_min;                                                                                     // Member lowest "z" [m].
+  float  v_max;                                                                                     // Member maximum speed [m/s].
+  float  v;                                                                                         // Node speed [m/s].
+
+  std::cout << "member, h, rho, E, mu, dt [s], time [s], sag [m], v_max [m/s]" << std::endl;
+
+  for(size_t k = 0; k < h.size (); k++)
+  {
+    z_min = loc_position[k*n].z;                                                                    // Resetting lowest "z"...
+    v_max = 0.0f;                                                                                   // Resetting maximum speed...
+
+    for(size_t i = k*n; i < (k + 1)*n; i++)
+    {
+      v     = std::sqrt (loc_velocity[i].x*loc_velocity[i].x + loc_velocity[i].y*loc_velocity[i].y +
+                         loc_velocity[i].z*loc_velocity[i].z);                                      // Computing node speed...
+      z_min = std::min (z_min, loc_position[i].z);                                                  // Updating lowest "z"...
+      v_max = std::max (v_max, v);                                                                  // Updating maximum speed...
+    }
+
+    std::cout << k << ", " << h[k] << ", " << rho[k] << ", " << E[k] << ", " << mu[k] << ", "
+              << loc_dt[k] << ", " << loc_steps*loc_dt[k] << ", " << -z_min << ", " << v_max << std::endl;
+  }
+}
+}
+
+#endif
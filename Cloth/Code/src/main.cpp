@@ -1,6 +1,5 @@
 /// @file
 
-#define INTEROP       true                                                                           // "true" = use OpenGL-OpenCL interoperability.
 #define SX            800                                                                            // Window x-size [px].
 #define SY            600                                                                            // Window y-size [px].
 #define NM            "Neutrino - Cloth"                                                             // Window name.
@@ -37,19 +36,61 @@
 #define SHADER_VERT   "voxel_vertex.vert"                                                            // OpenGL vertex shader.
 #define SHADER_GEOM   "voxel_geometry.geom"                                                          // OpenGL geometry shader.
 #define SHADER_FRAG   "voxel_fragment.frag"                                                          // OpenGL fragment shader.
+#define INIT_STATE    "init_state.cl"                                                                // OpenCL kernel source (initial state).
+#define INIT_MATERIAL "init_material.cl"                                                             // OpenCL kernel source (material).
 #define KERNEL_1      "thekernel_1.cl"                                                               // OpenCL kernel source.
 #define KERNEL_2      "thekernel_2.cl"                                                               // OpenCL kernel source.
+#define KERNEL_SPEC   "cloth_specialization.cl"                                                      // OpenCL kernel specialization (generated).
+#define KERNEL_ENS    "cloth_ensemble.cl"                                                            // OpenCL ensemble definitions (generated).
+#define KERNEL_COL    "cloth_collision.cl"                                                           // OpenCL self-collision definitions (generated).
+#define HASH_GRID     "hash.cl"                                                                      // OpenCL spatial hash utilities source.
+#define HASH_CLEAR    "hash_clear.cl"                                                                // OpenCL kernel source (hash clear).
+#define HASH_COUNT    "hash_count.cl"                                                                // OpenCL kernel source (hash count).
+#define HASH_SCAN_1   "hash_scan_1.cl"                                                               // OpenCL kernel source (hash scan, block sums).
+#define HASH_SCAN_2   "hash_scan_2.cl"                                                               // OpenCL kernel source (hash scan, block offsets).
+#define HASH_SCAN_3   "hash_scan_3.cl"                                                               // OpenCL kernel source (hash scan, cell offsets).
+#define HASH_SORT     "hash_sort.cl"                                                                 // OpenCL kernel source (hash sort).
+#define COLLISION     "collision.cl"                                                                 // OpenCL kernel source (collision force).
+#define HASH_BLOCK    256                                                                            // Hash cells per scan block.
+#define KERNEL_TEAR   "cloth_tear.cl"                                                                // OpenCL tearing definitions (generated).
+#define KERNEL_FP     "cloth_precision.cl"                                                           // OpenCL precision definitions (generated).
+#define KERNEL_MAT    "cloth_materials.cl"                                                           // OpenCL material definitions (generated).
+#define KERNEL_TILE   "cloth_tiling.cl"                                                              // OpenCL tiling definitions (generated).
+#define KERNEL_PAD    "cloth_padding.cl"                                                             // OpenCL padding guard definitions (generated).
+#define TILE_LOCAL    256                                                                            // Largest tiled work-group size.
+#define FP_TYPES      "precision.cl"                                                                 // OpenCL precision types source.
+#define TEAR_LIST     "tear.cl"                                                                      // OpenCL tearing utilities source.
+#define TEAR_SCAN_1   "tear_scan_1.cl"                                                               // OpenCL kernel source (tear scan, block sums).
+#define TEAR_SCAN_2   "tear_scan_2.cl"                                                               // OpenCL kernel source (tear scan, block offsets).
+#define TEAR_SCAN_3   "tear_scan_3.cl"                                                               // OpenCL kernel source (tear scan, packing).
+#define TEAR_COMPACT  "tear_compact.cl"                                                              // OpenCL kernel source (tear compaction).
+#define TEAR_BLOCK    64                                                                             // Links per tear scan block.
 #define UTILITIES     "utilities.cl"                                                                 // OpenCL utilities source.
 #define MESH_FILE     "Square_quadrangles.msh"                                                       // GMSH mesh.
 #define MESH          GMSH_HOME MESH_FILE                                                            // GMSH mesh (full path).
 
 // INCLUDES:
 #include "nu.hpp"                                                                                    // Neutrino's header file.
+#include "options.hpp"                                                                               // Command line options.
+#include "capture.hpp"                                                                               // Offscreen capture.
+#include "specialization.hpp"                                                                        // Kernel specialization.
+#include "precision.hpp"                                                                             // Compile-time precision.
+#include "materials.hpp"                                                                             // Per-group material table.
+#include "tiling.hpp"                                                                                // Work-group tiled force kernel.
+#include "cloth_cpu.hpp"                                                                             // CPU backend.
+#include "ensemble.hpp"                                                                              // Parameter ensemble.
+#include "topology.hpp"                                                                              // Neighbour list encoding.
+#include "zerocopy.hpp"                                                                              // Zero-copy sharing without interop.
+#include "nodestate.hpp"                                                                             // Node state at the chosen precision.
+#include "snapshot.hpp"                                                                              // Shared-memory snapshot ring.
+#include "startup.hpp"                                                                               // Concurrent startup pipeline.
+#include "dispatch.hpp"                                                                              // Tuned NDRange dispatch.
 
-int main ()
+int main (int argc, char** argv)
 {
   // INDICES:
   size_t                           i;                                                                // Index [#].
+  size_t                           k;                                                                // Ensemble member index [#].
   size_t                           j;                                                                // Index [#].
   size_t                           j_min;                                                            // Index [#].
   size_t                           j_max;                                                            // Index [#].
@@ -65,14 +106,72 @@ int main ()
   float                            gmp_decaytime  = 1.25f;                                           // Low pass filter decay time [s].
   float                            gmp_deadzone   = 0.30f;                                           // Gamepad joystick deadzone [0...1].
 
+  // OPTIONS:
+  ex::options*                     opt            = new ex::options (argc, argv);                    // Command line options.
+  size_t                           steps          = opt->get ("steps", size_t (0));                  // Number of steps (0 = unlimited) [#].
+  size_t                           step           = 0;                                               // Step index [#].
+  std::string                      capture        = opt->get ("capture", std::string (""));          // Capture directory ("" = no capture).
+  size_t                           every          = opt->get ("every", size_t (1));                  // Capture period [steps].
+  bool                             headless       = opt->flag ("headless");                          // Headless flag (hidden window).
+  std::string                      backend        = opt->get ("backend", std::string ("opencl"));    // Backend ("opencl" or "cpu").
+  std::string                      coding         = opt->get ("topology", std::string ("auto"));     // Neighbour encoding ("auto", "wide" or "delta").
+  size_t                           threads        = opt->get ("threads", size_t (0));                // CPU backend threads (0 = all cores) [#].
+  size_t                           validate       = opt->get ("validate", size_t (0));               // Cross-backend validation steps (0 = off) [#].
+  float                            tolerance      = opt->get ("tolerance", 1e-4f);                   // Cross-backend relative tolerance [].
+  size_t                           scaling        = opt->get ("scaling", size_t (0));                // CPU scaling benchmark steps (0 = off) [#].
+  bool                             on_cpu         = (backend == "cpu");                              // CPU backend flag.
+  int                              status         = 0;                                               // Exit status.
+  bool                             specialize     = opt->flag ("specialize");                        // Kernel specialization flag.
+  ex::ensemble*                    set            = new ex::ensemble (opt->get ("ensemble",
+                                                                             std::string ("")));     // Parameter ensemble.
+  size_t                           members        = set->size ();                                    // Number of ensemble members [#].
+  bool                             collide        = opt->flag ("collision");                         // Self-collision flag.
+  bool                             zero_copy      = opt->flag ("zero-copy");                         // Forced zero-copy sharing flag.
+  bool                             tune           = !opt->flag ("no-tune");                          // Work-group size tuning flag.
+  std::string                      serve          = opt->get ("serve", std::string (""));            // Snapshot ring to serve ("" = none).
+  std::string                      view           = opt->get ("view", std::string (""));             // Snapshot ring to view ("" = none).
+  size_t                           publish        = opt->get ("publish", size_t (1));                // Snapshot period [steps].
+  float                            strain_max     = opt->get ("tear", 0.0f);                         // Tearing strain (0 = off) [].
+  size_t                           compact        = opt->get ("compact", size_t (256));              // Broken links before compaction [#].
+  bool                             tearing        = (strain_max > 0.0f);                             // Tearing flag.
+  ex::precision*                   fp             = new ex::precision (opt->get ("precision",
+                                                                         std::string ("single")), true); // Precision (node state, see nodestate.hpp).
+  std::string                      library        = opt->get ("materials", std::string (""));        // Material file ("" = per-link stiffness, per-node mass).
+  std::string                      tiles          = opt->get ("tiling", std::string ("auto"));       // Tiled force kernel ("auto" = on regular grids, "off").
+
+  // STARTUP (mesh loaded while the contexts are created, see startup.hpp):
+  ex::startup*                     boot           = new ex::startup (opt->get ("startup",
+                                                                           std::string ("parallel"))); // Startup pipeline.
+  nu::mesh*                        cloth          = nullptr;                                         // Mesh cloth.
+  size_t                           side_x_nodes   = 0;                                               // Number of nodes in "x" direction [#].
+  size_t                           side_y_nodes   = 0;                                               // Number of nodes in "y" direction [#].
+  std::vector<GLint>               border;                                                           // Nodes on border.
+  size_t                           loading        = boot->run ("mesh", [&] ()
+  {
+    cloth        = new nu::mesh (MESH);                                                              // Loading mesh...
+    cloth->process (SIDE_X_TAG, SIDE_X_DIM, nu::MSH_PNT);                                            // Processing mesh ("x" side)...
+    side_x_nodes = cloth->node.size ();                                                              // Getting number of nodes along "x" side...
+    cloth->process (SIDE_Y_TAG, SIDE_Y_DIM, nu::MSH_PNT);                                            // Processing mesh ("y" side)...
+    side_y_nodes = cloth->node.size ();                                                              // Getting number of nodes along "y" side...
+    cloth->process (BORDER_TAG, BORDER_DIM, nu::MSH_PNT);                                            // Processing mesh (border)...
+    border       = cloth->node;                                                                      // Getting nodes on border...
+    cloth->process (SURFACE_TAG, SURFACE_DIM, nu::MSH_QUA_4);                                        // Processing mesh (surface, last)...
+  });                                                                                                // Mesh loading phase.
+
   // OPENGL:
-  nu::opengl*                      gl             = new nu::opengl (NM, SX, SY, OX, OY, PX, PY, PZ); // OpenGL context.
+  nu::opengl*                      gl             = new nu::opengl (NM, SX, SY, OX, OY, PX, PY,
+                                                                    PZ*set->columns ());             // OpenGL context.
+  ex::capture*                     rec            = new ex::capture (capture, every,
+                                                                     headless || (serve != ""));     // Offscreen capture (hidden when serving).
   nu::shader*                      S              = new nu::shader ();                               // OpenGL shader program.
   nu::projection_mode              pmode          = nu::MONOCULAR;                                   // OpenGL projection mode.
   nu::view_mode                    vmode          = nu::DIRECT;                                      // OpenGL view mode.
 
   // OPENCL:
+  bool                             interop        = !zero_copy && ex::zerocopy::probe (CL_DEVICE_TYPE_GPU); // CL/GL interop flag (probed before the context).
   nu::opencl*                      cl             = new nu::opencl (nu::GPU);                        // OpenCL context.
+  nu::kernel*                      K_state        = new nu::kernel ();                               // OpenCL kernel array (initial state).
+  nu::kernel*                      K_material     = new nu::kernel ();                               // OpenCL kernel array (material).
   nu::kernel*                      K1             = new nu::kernel ();                               // OpenCL kernel array.
   nu::kernel*                      K2             = new nu::kernel ();                               // OpenCL kernel array.
   nu::float4*                      color          = new nu::float4 (0);                              // Color [].
@@ -86,26 +185,68 @@ int main ()
   nu::float1*                      resting        = new nu::float1 (8);                              // Resting.
   nu::float1*                      friction       = new nu::float1 (9);                              // Friction.
   nu::float1*                      mass           = new nu::float1 (10);                             // Mass [kg].
-  nu::int1*                        central        = new nu::int1 (11);                               // Central nodes.
+  nu::int1*                        encoding       = new nu::int1 (11);                               // Neighbour index encoding (implicit central nodes).
   nu::int1*                        neighbour      = new nu::int1 (12);                               // Neighbour.
   nu::int1*                        offset         = new nu::int1 (13);                               // Offset.
   nu::int1*                        freedom        = new nu::int1 (14);                               // Freedom.
   nu::float1*                      dt             = new nu::float1 (15);                             // Time step [s].
+  nu::float1*                      parameter      = new nu::float1 (16);                             // Initialization parameters.
+  nu::int1*                        cell           = new nu::int1 (17);                               // Hash cell of each node.
+  nu::int1*                        count          = new nu::int1 (18);                               // Nodes in each hash cell.
+  nu::int1*                        start          = new nu::int1 (19);                               // First sorted node of each hash cell.
+  nu::int1*                        sorted         = new nu::int1 (20);                               // Nodes sorted by hash cell.
+  nu::int1*                        block          = new nu::int1 (21);                               // Hash cell block sums.
+  nu::float4*                      collision      = new nu::float4 (22);                             // Collision force [N].
+  nu::int1*                        tear_rank      = new nu::int1 (23);                               // Tearing kept link rank.
+  nu::int1*                        tear_block     = new nu::int1 (24);                               // Tearing link block sums.
+  nu::float4*                      tear_spare     = new nu::float4 (25);                             // Tearing compaction scratch.
+  nu::int1*                        tear           = new nu::int1 (26);                               // Tearing counters (broken, live links, compacting).
+  nu::float4*                      material       = new nu::float4 (27);                             // Material table (m, K, B).
+  nu::int1*                        link_material  = new nu::int1 (28);                               // Link material ids (4 per int).
+  nu::int1*                        node_material  = new nu::int1 (29);                               // Node material ids (4 per int).
+  nu::int1*                        tile_node      = new nu::int1 (30);                               // Node of each grid cell (tiling).
+  nu::int1*                        tile_link      = new nu::int1 (31);                               // Link stencil codes (tiling, 4 per int).
+  nu::float4*                      position_node  = new nu::float4 (32);                             // Position (node state) [m].
+  std::vector<nu::kernel*>         K_hash;                                                           // OpenCL kernel arrays (self-collision).
+  std::vector<nu::kernel*>         K_tear;                                                           // OpenCL kernel arrays (tearing).
+  ex::zerocopy*                    zc;                                                               // Zero-copy sharing (without interop).
+  ex::nodestate*                   ns;                                                               // Node state (at the chosen precision).
+  ex::dispatch*                    nd;                                                               // Step kernel dispatch (tuned local size).
+  ex::snapshot*                    ring           = nullptr;                                         // Snapshot ring (server or viewer).
+
+  // KERNEL SPECIALIZATION:
+  ex::specialization*              spec           = new ex::specialization (KERNEL_SPEC);            // Kernel specialization.
+  ex::specialization*              ens            = new ex::specialization (KERNEL_ENS);             // Ensemble definitions.
+  ex::specialization*              col            = new ex::specialization (KERNEL_COL);             // Self-collision definitions.
+  ex::specialization*              rip            = new ex::specialization (KERNEL_TEAR);            // Tearing definitions.
+  ex::specialization*              fpd            = new ex::specialization (KERNEL_FP);              // Precision definitions.
+  ex::specialization*              mtd            = new ex::specialization (KERNEL_MAT);             // Material definitions.
+  ex::specialization*              tld            = new ex::specialization (KERNEL_TILE);            // Tiling definitions.
+  ex::specialization*              pad            = new ex::specialization (KERNEL_PAD);             // Padding guard definitions.
+  size_t                           stride         = 0;                                               // Maximum neighbour stride [#].
+
+  // CPU BACKEND:
+  ex::cpu_backend*                 cpu            = new ex::cpu_backend (threads);                   // CPU backend.
+  ex::cloth_cpu*                   model          = new ex::cloth_cpu (color, position, velocity,
+                                                                       acceleration, position_int,
+                                                                       velocity_int, gravity, stiffness,
+                                                                       resting, friction, mass, encoding,
+                                                                       neighbour, offset, freedom, dt); // CPU model.
 
   // IMGUI:
   nu::imgui*                       hud            = new nu::imgui ();                                // ImGui context.
 
   // MESH:
-  nu::mesh*                        cloth          = new nu::mesh (MESH);                             // Mesh cloth.
   size_t                           nodes;                                                            // Number of nodes.
   size_t                           elements;                                                         // Number of elements.
   size_t                           groups;                                                           // Number of groups.
   size_t                           neighbours;                                                       // Number of neighbours.
+  size_t                           drawn;                                                            // Number of drawn links (live links when tearing).
+  ex::topology*                    topo;                                                             // Neighbour list encoding.
+  ex::materials*                   mat = nullptr;                                                    // Material groups (nullptr = per-link arrays).
+  ex::tiling*                      grid = nullptr;                                                   // Regular grid (nullptr = untiled).
   std::vector<size_t>              side_x;                                                           // Nodes on "x" side.
   std::vector<size_t>              side_y;                                                           // Nodes on "y" side.
-  std::vector<GLint>               border;                                                           // Nodes on border.
-  size_t                           side_x_nodes;                                                     // Number of nodes in "x" direction [#].
-  size_t                           side_y_nodes;                                                     // Number of nodes in "x" direction [#].
   size_t                           border_nodes;                                                     // Number of border nodes.
   float                            x_min = -1.0f;                                                    // "x_min" spatial boundary [m].
   float                            x_max = +1.0f;                                                    // "x_max" spatial boundary [m].
@@ -130,21 +271,16 @@ int main ()
 
   // BACKUP:
   std::vector<nu_float4_structure> initial_position;                                                 // Backing up initial data...
-  std::vector<nu_float4_structure> initial_position_int;                                             // Backing up initial data...
-  std::vector<nu_float4_structure> initial_velocity;                                                 // Backing up initial data...
-  std::vector<nu_float4_structure> initial_velocity_int;                                             // Backing up initial data...
-  std::vector<nu_float4_structure> initial_acceleration;                                             // Backing up initial data...
+  std::vector<GLint>               initial_neighbour;                                                // Backing up initial neighbours (tearing)...
+  std::vector<GLint>               initial_offset;                                                   // Backing up initial offsets (tearing)...
+  std::vector<GLfloat>             initial_resting;                                                  // Backing up initial resting (tearing)...
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   ///////////////////////////////////////// DATA INITIALIZATION ///////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
-  // MESH "X" SIDE:
-  cloth->process (SIDE_X_TAG, SIDE_X_DIM, nu::MSH_PNT);                                              // Processing mesh...
-  side_x_nodes    = cloth->node.size ();                                                             // Getting number of nodes along "x" side...
-
-  // MESH "Y" SIDE:
-  cloth->process (SIDE_Y_TAG, SIDE_Y_DIM, nu::MSH_PNT);                                              // Processing mesh...
-  side_y_nodes    = cloth->node.size ();                                                             // Getting number of nodes along "y" side...
+  // MESH (sides, border and surface):
+  boot->mark ("contexts");                                                                           // Marking contexts created...
+  boot->join (loading);                                                                              // Waiting for mesh...
 
   // COMPUTING PHYSICAL PARAMETERS:
   dx              = (x_max - x_min)/(side_x_nodes - 1);                                              // x-axis mesh spatial size [m].
@@ -157,9 +293,33 @@ int main ()
   dt->data.push_back (dt_simulation);                                                                // Setting simulation time step...
   friction->data.push_back (B);                                                                      // Setting friction...
   gravity->data.push_back ({0.0f, 0.0f, -g, 1.0f});                                                  // Setting gravity...
+  parameter->data = {m, K, float (DS + EPSILON)};                                                    // Setting initialization parameters...
+
+  // SETTING ENSEMBLE PARAMETERS (one set per member):
+  if(members > 1)
+  {
+    if(on_cpu || (validate > 0) || (scaling > 0))
+    {
+      std::cout << "Error: ensemble mode runs on the OpenCL backend only." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                      // Exiting...
+    }
+
+    dt->data.clear ();                                                                               // Clearing time steps...
+    friction->data.clear ();                                                                         // Clearing frictions...
+    parameter->data.clear ();                                                                        // Clearing initialization parameters...
+
+    for(k = 0; k < members; k++)
+    {
+      m = set->rho[k]*set->h[k]*dx*dy;                                                               // Member node mass [kg].
+      K = set->E[k]*set->h[k]*dy/dx;                                                                 // Member elastic constant [kg/s^2].
+      B = set->mu[k]*set->h[k]*dx*dy;                                                                // Member damping [kg*s*m].
+      dt->data.push_back (0.5f*sqrt (m/K));                                                          // Setting member time step...
+      friction->data.push_back (B);                                                                  // Setting member friction...
+      parameter->data.insert (parameter->data.end (), {m, K, float (DS + EPSILON)});                 // Setting member initialization parameters...
+    }
+  }
 
   // MESH SURFACE:
-  cloth->process (SURFACE_TAG, SURFACE_DIM, nu::MSH_QUA_4);                                          // Processing mesh...
   position->data  = cloth->node_coordinates;                                                         // Setting all node coordinates...
   neighbour->data = cloth->neighbour;                                                                // Setting neighbour indices...
   offset->data    = cloth->neighbour_offset;                                                         // Setting neighbour offsets...
@@ -173,16 +333,26 @@ int main ()
   std::cout << "groups = " << groups/CELL_VERTICES << std::endl;                                     // Printing message...
   std::cout << "neighbours = " << neighbours << std::endl;                                           // Printing message...
 
+  // SIZING NEUTRINO ARRAYS (set on device by the initialization kernels):
+  position_int->data.resize (nodes);                                                                 // Sizing intermediate position...
+  velocity->data.resize (nodes);                                                                     // Sizing velocity...
+  velocity_int->data.resize (nodes);                                                                 // Sizing intermediate velocity...
+  acceleration->data.resize (nodes);                                                                 // Sizing acceleration...
+  mass->data.resize (nodes);                                                                         // Sizing mass...
+  stiffness->data.resize (neighbours);                                                               // Sizing stiffness...
+  color->data.resize (neighbours);                                                                   // Sizing color...
+  freedom->data.assign (nodes, 1);                                                                   // Setting freedom flags...
+
   // SETTING NEUTRINO ARRAYS ("surface" depending):
   for(i = 0; i < nodes; i++)
   {
+    if(cloth->node[i] != GLint (i))
+    {
+      std::cout << "Error: mesh nodes must be numbered 0...N-1 (implicit central nodes)." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                      // Exiting...
+    }
+
     std::cout << "i = " << i << ", node index = " << cloth->node[i] << ", neighbour indices:";       // Printing message...
-    position_int->data.push_back (position->data[i]);                                                // Setting initial intermediate position...
-    velocity->data.push_back ({0.0f, 0.0f, 0.0f, 1.0f});                                             // Setting initial velocity...
-    velocity_int->data.push_back ({0.0f, 0.0f, 0.0f, 1.0f});                                         // Setting initial intermediate velocity...
-    acceleration->data.push_back ({0.0f, 0.0f, 0.0f, 1.0f});                                         // Setting initial acceleration...
-    mass->data.push_back (m);                                                                        // Setting mass...
-    freedom->data.push_back (1);                                                                     // Setting freedom flag...
 
     // Computing minimum element offset index:
     if(i == 0)
@@ -198,27 +368,13 @@ int main ()
 
     for(j = j_min; j < j_max; j++)
     {
-      central->data.push_back (cloth->node[i]);                                                      // Building central node tuple...
-      stiffness->data.push_back (K);                                                                 // Setting link stiffness...
-
       std::cout << " " << neighbour->data[j];                                                        // Printing message...
-
-      if(resting->data[j] > (DS + EPSILON))
-      {
-        color->data.push_back ({1.0f, 0.0f, 0.0f, 0.1f});                                            // Setting link color...
-      }
-      else
-      {
-        color->data.push_back ({0.0f, 1.0f, 0.0f, 1.0f});                                            // Setting link color...
-      }
     }
 
     std::cout << std::endl;                                                                          // Printing message...
   }
 
   // MESH BORDER:
-  cloth->process (BORDER_TAG, BORDER_DIM, nu::MSH_PNT);                                              // Processing mesh...
-  border               = cloth->node;                                                                // Getting nodes on border...
   border_nodes         = border.size ();                                                             // Getting the number of nodes on border...
 
   // SETTING NEUTRINO ARRAYS ("border" depending):
@@ -227,35 +383,479 @@ int main ()
     freedom->data[border[i]] = 0;                                                                    // Resetting freedom flag...
   }
 
+  // REPLICATING ENSEMBLE MEMBERS:
+  if(members > 1)
+  {
+    set->replicate (color->data);                                                                    // Replicating color...
+    set->replicate (position->data);                                                                 // Replicating position...
+    set->replicate (velocity->data);                                                                 // Replicating velocity...
+    set->replicate (acceleration->data);                                                             // Replicating acceleration...
+    set->replicate (position_int->data);                                                             // Replicating intermediate position...
+    set->replicate (velocity_int->data);                                                             // Replicating intermediate velocity...
+    set->replicate (stiffness->data);                                                                // Replicating stiffness...
+    set->replicate (resting->data);                                                                  // Replicating resting...
+    set->replicate (mass->data);                                                                     // Replicating mass...
+    set->replicate (neighbour->data, nodes);                                                         // Replicating neighbours...
+    set->replicate (offset->data, neighbours);                                                       // Replicating offsets...
+    set->replicate (freedom->data);                                                                  // Replicating freedom flags...
+    set->layout (position->data, 1.25f*(x_max - x_min));                                             // Laying out members...
+    ens->define ("MEMBER_NODES", nodes);                                                             // Defining member size...
+    nodes      *= members;                                                                           // Getting the total number of nodes...
+    neighbours *= members;                                                                           // Getting the total number of neighbours...
+    std::cout << "ensemble = " << members << " members" << std::endl;                                // Printing message...
+  }
+
+  // SETTING MATERIALS (per-group table and 8-bit material ids, see materials.hpp):
+  if(library != "")
+  {
+    if(on_cpu || (validate > 0) || (scaling > 0) || (members > 1) || tearing)
+    {
+      std::cout << "Error: material tables run on the OpenCL backend only, without ensemble or tearing." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                      // Exiting...
+    }
+
+    mat = new ex::materials (library, 4, nodes);                                                     // Reading materials (rho, h, E, mu)...
+
+    for(i = 0; i < mat->value.size (); i++)
+    {
+      cloth->process (mat->tag[i], mat->dim[i], nu::MSH_PNT);                                        // Processing material group...
+      mat->mark (cloth->node, i + 1);                                                                // Setting node materials...
+    }
+
+    mat->connect (neighbour->data, offset->data);                                                    // Setting link materials...
+    material->data = {{m, K, B, 0.0f}};                                                              // Setting material 0...
+
+    for(i = 0; i < mat->value.size (); i++)
+    {
+      material->data.push_back ({mat->value[i][0]*mat->value[i][1]*dx*dy,
+                                 mat->value[i][2]*mat->value[i][1]*dy/dx,
+                                 mat->value[i][3]*mat->value[i][1]*dx*dy, 0.0f});                    // Setting material (m, K, B)...
+      dt_critical = std::min (dt_critical, float (sqrt (material->data[i + 1].x/material->data[i + 1].y))); // Getting stiffest material...
+    }
+
+    dt_simulation       = 0.5f*dt_critical;                                                          // Simulation time step [s].
+    dt->data[0]         = dt_simulation;                                                             // Setting simulation time step...
+    link_material->data = ex::materials::pack (mat->link);                                           // Setting link material ids...
+    node_material->data = ex::materials::pack (mat->node);                                           // Setting node material ids...
+    stiffness->data     = {0.0f};                                                                    // Dropping per-link stiffness...
+    mass->data          = {0.0f};                                                                    // Dropping per-node mass...
+    mtd->define ("MATERIALS", mat->size ());                                                         // Enabling material table...
+    mat->report ();                                                                                  // Printing materials...
+  }
+  else
+  {
+    material->data      = {{0.0f, 0.0f, 0.0f, 0.0f}};                                                // Setting placeholder...
+    link_material->data = {0};                                                                       // Setting placeholder...
+    node_material->data = {0};                                                                       // Setting placeholder...
+  }
+
+  // SETTING TILING (work-group tiles on regular grids, see tiling.hpp):
+  if((tiles != "auto") && (tiles != "off"))
+  {
+    std::cout << "Error: unknown tiling \"" << tiles << "\" (auto or off)." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                        // Exiting...
+  }
+
+  if((tiles == "auto") && (members == 1) && !tearing)
+  {
+    grid = new ex::tiling (position->data, neighbour->data, offset->data);                           // Detecting regular grid...
+  }
+
+  if((grid != nullptr) && grid->fits (TILE_LOCAL, sizeof (nu_float4_structure)))
+  {
+    tile_node->data = grid->node;                                                                    // Setting node of each grid cell...
+    tile_link->data = grid->pack ();                                                                 // Setting link stencil codes...
+    tld->define ("TILE", size_t (1));                                                                // Enabling tiled force kernel...
+    tld->define ("TILE_X", grid->nx);                                                                // Setting grid cells along "x"...
+    tld->define ("TILE_Y", grid->ny);                                                                // Setting grid cells along "y"...
+    tld->define ("TILE_HALO", grid->halo);                                                           // Setting tile halo...
+    tld->define ("TILE_LOCAL", size_t (TILE_LOCAL));                                                 // Setting largest tiled work-group...
+    tld->define ("TILE_SPAN", grid->span (TILE_LOCAL));                                              // Setting tile size...
+    tld->define ("TILE_CELLS", nodes);                                                               // Setting number of grid cells...
+  }
+  else
+  {
+    tile_node->data = {0};                                                                           // Setting placeholder...
+    tile_link->data = {0};                                                                           // Setting placeholder...
+  }
+
+  if(grid != nullptr)
+  {
+    grid->report (TILE_LOCAL);                                                                       // Printing tiling...
+  }
+  else if(tiles == "auto")
+  {
+    std::cout << "tiling = off (ensemble or tearing)" << std::endl;
+  }
+
   // SETTING INITIAL DATA BACKUP:
   initial_position     = position->data;                                                             // Setting backup data...
-  initial_position_int = position_int->data;                                                         // Setting backup data...
-  initial_velocity     = velocity->data;                                                             // Setting backup data...
-  initial_velocity_int = velocity_int->data;                                                         // Setting backup data...
-  initial_acceleration = acceleration->data;                                                         // Setting backup data...
+
+  // ENCODING NEIGHBOUR LISTS (see topology.hpp):
+  if(on_cpu || (validate > 0) || (scaling > 0))
+  {
+    coding = "wide";                                                                                 // Forcing 32-bit indices (read by the CPU backend)...
+  }
+
+  if(tearing)
+  {
+    coding = "wide";                                                                                 // Forcing 32-bit indices (moved by the tear compaction)...
+  }
+
+  topo = new ex::topology (neighbour->data, offset->data, coding);                                   // Choosing encoding...
+  topo->encode (neighbour->data, offset->data);                                                      // Encoding neighbour indices...
+  encoding->data = {int (topo->mode)};                                                               // Setting encoding...
+  topo->report (neighbours);                                                                         // Printing encoding...
+
+  // SETTING SELF-COLLISION ARRAYS (hash table with one cell per node):
+  if(collide)
+  {
+    if(on_cpu || (validate > 0) || (scaling > 0))
+    {
+      std::cout << "Error: self-collision runs on the OpenCL backend only." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                      // Exiting...
+    }
+
+    cell->data.assign (nodes, 0);                                                                    // Setting hash cells...
+    count->data.assign (nodes, 0);                                                                   // Setting hash cell counts...
+    start->data.assign (nodes, 0);                                                                   // Setting hash cell starts...
+    sorted->data.assign (nodes, 0);                                                                  // Setting sorted nodes...
+    block->data.assign ((nodes + HASH_BLOCK - 1)/HASH_BLOCK, 0);                                     // Setting hash block sums...
+    collision->data.assign (nodes, {0.0f, 0.0f, 0.0f, 0.0f});                                        // Setting collision forces...
+    col->define ("COLLISION", size_t (1));                                                           // Enabling collision force...
+    col->define ("HASH_CELLS", nodes);                                                               // Setting hash table size...
+    col->define ("HASH_BLOCK", size_t (HASH_BLOCK));                                                 // Setting hash block size...
+    col->define ("HASH_BLOCKS", block->data.size ());                                                // Setting number of hash blocks...
+    col->define ("HASH_CELL", 0.5f*std::min (dx, dy));                                               // Setting hash cell side [m]...
+    col->define ("CONTACT_RADIUS", 0.5f*std::min (dx, dy));                                          // Setting contact radius [m]...
+  }
+  else
+  {
+    cell->data      = {0};                                                                           // Setting placeholder...
+    count->data     = {0};                                                                           // Setting placeholder...
+    start->data     = {0};                                                                           // Setting placeholder...
+    sorted->data    = {0};                                                                           // Setting placeholder...
+    block->data     = {0};                                                                           // Setting placeholder...
+    collision->data = {{0.0f, 0.0f, 0.0f, 0.0f}};                                                    // Setting placeholder...
+  }
+
+  // SETTING TEARING ARRAYS (neighbour lists compacted on device, see tear.cl):
+  if(tearing)
+  {
+    if(on_cpu || (validate > 0) || (scaling > 0) || (serve != ""))
+    {
+      std::cout << "Error: tearing runs on the OpenCL backend only, without snapshot serving." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                      // Exiting...
+    }
+
+    tear_rank->data.assign (neighbours, 0);                                                          // Setting kept link ranks...
+    tear_block->data.assign ((neighbours + TEAR_BLOCK - 1)/TEAR_BLOCK, 0);                           // Setting tear block sums...
+    tear_spare->data.assign (2*neighbours, {0.0f, 0.0f, 0.0f, 0.0f});                                // Setting compaction scratch...
+
+    if(tear_block->data.size () > nodes)
+    {
+      std::cout << "Error: tear scan blocks exceed the number of nodes." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                      // Exiting...
+    }
+
+    initial_neighbour = neighbour->data;                                                             // Setting backup data...
+    initial_offset    = offset->data;                                                                // Setting backup data...
+    initial_resting   = resting->data;                                                               // Setting backup data...
+    rip->define ("TEAR", strain_max);                                                                // Setting tearing strain...
+    rip->define ("TEAR_COMPACT", compact);                                                           // Setting compaction threshold...
+    rip->define ("TEAR_BLOCK", size_t (TEAR_BLOCK));                                                 // Setting tear block size...
+    rip->define ("TEAR_BLOCKS", tear_block->data.size ());                                           // Setting number of tear blocks...
+    rip->define ("LINKS", neighbours);                                                               // Setting number of links...
+  }
+  else
+  {
+    tear_rank->data  = {0};                                                                          // Setting placeholder...
+    tear_block->data = {0};                                                                          // Setting placeholder...
+    tear_spare->data = {{0.0f, 0.0f, 0.0f, 0.0f}};                                                   // Setting placeholder...
+  }
+
+  tear->data = {0, int (neighbours), 0};                                                             // Setting tearing counters (live links read by the shader)...
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////// KERNEL SPECIALIZATION ///////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  for(i = 0; i < nodes; i++)
+  {
+    stride = std::max (stride, size_t (offset->data[i] - ((i == 0) ? 0 : offset->data[i - 1])));     // Getting maximum neighbour stride...
+  }
+
+  spec->define ("NEIGHBOURS", stride);                                                               // Specializing neighbour stride...
+  spec->define ("GRAVITY", gravity->data[0]);                                                        // Specializing gravity...
+
+  if(members == 1)
+  {
+    spec->define ("DT_SIMULATION", dt_simulation);                                                   // Specializing time step...
+    spec->define ("FRICTION", B);                                                                    // Specializing friction...
+  }
+
+  fpd->define ("PRECISION", size_t (fp->mode));                                                      // Setting kernel arithmetic precision...
+  pad->define ("NODES", nodes);                                                                      // Setting padding guard...
+
+  if(fp->position)
+  {
+    fpd->define ("POSITION_DOUBLE", size_t (1));                                                     // Storing positions in double...
+  }
+
+  if(fp->state)
+  {
+    fpd->define ("STATE_DOUBLE", size_t (1));                                                        // Storing kinematics in double...
+  }
+
+  if(on_cpu && (fp->mode != ex::SINGLE_PRECISION))
+  {
+    std::cout << "Note: the CPU backend steps in FP32, --precision " << fp->name ()
+              << " applies to the device kernels." << std::endl;
+  }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENCL KERNELS INITIALIZATION //////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
+  // WRITING DEFINITION FILES (final before the first build, as the builds run concurrently):
+  if(members > 1)
+  {
+    ens->write ();                                                                                   // Writing ensemble definitions...
+  }
+
+  if(collide)
+  {
+    col->write ();                                                                                   // Writing self-collision definitions...
+  }
+
+  if(tearing)
+  {
+    rip->write ();                                                                                   // Writing tearing definitions...
+  }
+
+  if(specialize)
+  {
+    spec->write ();                                                                                  // Writing kernel specialization...
+  }
+
+  fpd->write ();                                                                                     // Writing precision definitions...
+  mtd->write ();                                                                                     // Writing material definitions...
+  tld->write ();                                                                                     // Writing tiling definitions...
+  pad->write ();                                                                                     // Writing padding guard definitions...
+
+  if(members > 1)
+  {
+    K_state->addsource (ens->write ());                                                              // Setting kernel ensemble source...
+    K_material->addsource (ens->write ());                                                           // Setting kernel ensemble source...
+    K1->addsource (ens->write ());                                                                   // Setting kernel ensemble source...
+    K2->addsource (ens->write ());                                                                   // Setting kernel ensemble source...
+  }
+
+  if(collide)
+  {
+    for(std::string file : {HASH_CLEAR, HASH_COUNT, HASH_SCAN_1, HASH_SCAN_2, HASH_SCAN_3, HASH_SORT, COLLISION})
+    {
+      K_hash.push_back (new nu::kernel ());                                                          // Creating OpenCL kernel...
+
+      if(members > 1)
+      {
+        K_hash.back ()->addsource (ens->write ());                                                   // Setting kernel ensemble source...
+      }
+
+      K_hash.back ()->addsource (col->write ());                                                     // Setting kernel self-collision source...
+      K_hash.back ()->addsource (fpd->write ());                                                     // Setting kernel precision source...
+      K_hash.back ()->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                // Setting kernel source file...
+      K_hash.back ()->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));               // Setting kernel source file...
+      K_hash.back ()->addsource (std::string (KERNEL_HOME) + std::string (HASH_GRID));               // Setting kernel source file...
+      K_hash.back ()->addsource (std::string (KERNEL_HOME) + file);                                  // Setting kernel source file...
+      boot->run (file, [K_b = K_hash.back (), nodes] ()
+      {
+        K_b->build (nodes, 0, 0);                                                                    // Building kernel program...
+      });
+    }
+
+    K2->addsource (col->write ());                                                                   // Setting kernel self-collision source...
+  }
+
+  if(tearing)
+  {
+    for(std::string file : {TEAR_SCAN_1, TEAR_SCAN_2, TEAR_SCAN_3, TEAR_COMPACT})
+    {
+      K_tear.push_back (new nu::kernel ());                                                          // Creating OpenCL kernel...
+      K_tear.back ()->addsource (rip->write ());                                                     // Setting kernel tearing source...
+      K_tear.back ()->addsource (std::string (KERNEL_HOME) + std::string (TEAR_LIST));               // Setting kernel source file...
+      K_tear.back ()->addsource (std::string (KERNEL_HOME) + file);                                  // Setting kernel source file...
+      boot->run (file, [K_b = K_tear.back (), nodes] ()
+      {
+        K_b->build (nodes, 0, 0);                                                                    // Building kernel program...
+      });
+    }
+
+    K2->addsource (rip->write ());                                                                   // Setting kernel tearing source...
+  }
+
+  K_state->addsource (fpd->write ());                                                                // Setting kernel precision source...
+  K_state->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                           // Setting kernel source file...
+  K_state->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                          // Setting kernel source file...
+  K_state->addsource (std::string (KERNEL_HOME) + std::string (INIT_STATE));                         // Setting kernel source file...
+  boot->run ("state", [&] ()
+  {
+    K_state->build (nodes, 0, 0);                                                                    // Building kernel program...
+  });
+
+  K_material->addsource (mtd->write ());                                                             // Setting kernel material source...
+  K_material->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                       // Setting kernel source file...
+  K_material->addsource (std::string (KERNEL_HOME) + std::string (INIT_MATERIAL));                   // Setting kernel source file...
+  boot->run ("material", [&] ()
+  {
+    K_material->build (nodes, 0, 0);                                                                 // Building kernel program...
+  });
+
+  if(specialize)
+  {
+    K1->addsource (spec->write ());                                                                  // Setting kernel specialization source...
+    K2->addsource (spec->write ());                                                                  // Setting kernel specialization source...
+  }
+
+  K1->addsource (pad->write ());                                                                     // Setting kernel padding source...
+  K1->addsource (fpd->write ());                                                                     // Setting kernel precision source...
+  K1->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                                // Setting kernel source file...
   K1->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                               // Setting kernel source file...
   K1->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_1));                                // Setting kernel source file...
-  K1->build (nodes, 0, 0);                                                                           // Building kernel program...
+  boot->run ("K1", [&] ()
+  {
+    K1->build (nodes, 0, 0);                                                                         // Building kernel program...
+  });
+
+  K2->addsource (pad->write ());                                                                     // Setting kernel padding source...
+  K2->addsource (fpd->write ());                                                                     // Setting kernel precision source...
+  K2->addsource (mtd->write ());                                                                     // Setting kernel material source...
+  K2->addsource (tld->write ());                                                                     // Setting kernel tiling source...
+  K2->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                                // Setting kernel source file...
   K2->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                               // Setting kernel source file...
   K2->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_2));                                // Setting kernel source file...
-  K2->build (nodes, 0, 0);                                                                           // Building kernel program...
+  boot->run ("K2", [&] ()
+  {
+    K2->build (nodes, 0, 0);                                                                         // Building kernel program...
+  });
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENGL SHADERS INITIALIZATION //////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), nu::VERTEX);                  // Setting shader source file...
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), nu::GEOMETRY);                // Setting shader source file...
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), nu::FRAGMENT);                // Setting shader source file...
-  S->build (neighbours);                                                                             // Building shader program...
+  boot->now ("shader", [&] ()
+  {
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), nu::VERTEX);                // Setting shader source file...
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), nu::GEOMETRY);              // Setting shader source file...
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), nu::FRAGMENT);              // Setting shader source file...
+    S->build (neighbours);                                                                           // Building shader program...
+  });
+
+  drawn = neighbours;                                                                                // Drawing all links...
+
+  boot->join ();                                                                                     // Waiting for kernel builds...
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////// SETTING OPENCL KERNEL ARGUMENTS //////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
+  position_node->data = position->data;                                                              // Setting node state position...
   cl->write ();                                                                                      // Writing OpenCL data...
+  ns = new ex::nodestate (K1);                                                                       // Storing node state...
+  ns->store (2, velocity->data, fp->state);                                                          // Storing velocity...
+  ns->store (3, acceleration->data, fp->state);                                                      // Storing acceleration...
+  ns->store (4, position_int->data, fp->position);                                                   // Storing intermediate position...
+  ns->store (5, velocity_int->data, fp->state);                                                      // Storing intermediate velocity...
+  ns->store (32, position_node->data, fp->position);                                                 // Storing position...
+  ns->attach ({K_state, K_material, K1, K2});                                                        // Setting node state kernel arguments...
+  ns->attach (K_hash);                                                                               // Setting node state kernel arguments...
+  ns->attach (K_tear);                                                                               // Setting node state kernel arguments...
+  ns->report ();                                                                                     // Printing node state storage...
+  nd = new ex::dispatch (K1, nodes, tune && !on_cpu);                                                // Setting step kernel dispatch...
+
+  if(tune && !on_cpu)
+  {
+    // TUNING STEP KERNELS (on the initial state, rewritten afterwards):
+    cl->acquire ();                                                                                  // Acquiring OpenCL kernel...
+    cl->execute (K_material, nu::WAIT);                                                              // Initializing material on device...
+    cl->execute (K_state, nu::WAIT);                                                                 // Initializing state on device...
+    nd->tune (K1, "K1");                                                                             // Tuning work-group size...
+    nd->tune (K2, "K2");                                                                             // Tuning work-group size...
+    cl->release ();                                                                                  // Releasing OpenCL kernel...
+    cl->write ();                                                                                    // Rewriting OpenCL data...
+    ns->attach ({K_state, K_material, K1, K2});                                                      // Setting node state kernel arguments...
+    ns->attach (K_hash);                                                                             // Setting node state kernel arguments...
+    ns->attach (K_tear);                                                                             // Setting node state kernel arguments...
+    ns->write (cl, 2, velocity->data);                                                               // Rewriting node state...
+    ns->write (cl, 3, acceleration->data);                                                           // Rewriting node state...
+    ns->write (cl, 4, position_int->data);                                                           // Rewriting node state...
+    ns->write (cl, 5, velocity_int->data);                                                           // Rewriting node state...
+    ns->write (cl, 32, position_node->data);                                                         // Rewriting node state...
+  }
+
+  zc = new ex::zerocopy (K1, interop);                                                               // Choosing sharing path...
+  zc->share (0, color->data);                                                                        // Sharing color...
+  zc->share (1, position->data);                                                                     // Sharing position...
+  zc->attach ({K_state, K_material, K1, K2});                                                        // Setting shared kernel arguments...
+  zc->attach (K_hash);                                                                               // Setting shared kernel arguments...
+  zc->attach (K_tear);                                                                               // Setting shared kernel arguments...
+  zc->report ();                                                                                     // Printing sharing path...
+
+  if((serve != "") && (view != ""))
+  {
+    std::cout << "Error: --serve and --view are exclusive." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                        // Exiting...
+  }
+
+  if((serve != "") || (view != ""))
+  {
+    ring = new ex::snapshot ((serve != "") ? serve : view, serve != "", position->data.size (),
+                             color->data.size ());                                                   // Opening snapshot ring...
+  }
+
+  cl->acquire ();                                                                                    // Acquiring OpenCL kernel...
+  cl->execute (K_material, nu::WAIT);                                                                // Initializing material on device...
+  cl->execute (K_state, nu::WAIT);                                                                   // Initializing state on device...
+  cl->release ();                                                                                    // Releasing OpenCL kernel...
+
+  if(on_cpu || (validate > 0) || (scaling > 0))
+  {
+    cl->acquire ();                                                                                  // Acquiring OpenCL kernel...
+    zc->read (cl, 0, color->data);                                                                   // Reading initial color...
+    ns->read (cl, 2, velocity->data);                                                                // Reading initial velocity...
+    ns->read (cl, 3, acceleration->data);                                                            // Reading initial acceleration...
+    ns->read (cl, 4, position_int->data);                                                            // Reading initial intermediate position...
+    ns->read (cl, 5, velocity_int->data);                                                            // Reading initial intermediate velocity...
+    cl->read (7);                                                                                    // Reading initial stiffness...
+    cl->read (10);                                                                                   // Reading initial mass...
+    cl->release ();                                                                                  // Releasing OpenCL kernel...
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  ///////////////////////////////////// CPU BACKEND TEST AND BENCHMARK ////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  if(validate > 0)
+  {
+    status = ex::validate (model, cpu, validate, tolerance, [&] ()
+    {
+      cl->acquire ();                                                                                // Acquiring OpenCL kernel...
+      nd->execute (K1, "K1");                                                                        // Executing OpenCL kernel...
+      nd->execute (K2, "K2");                                                                        // Executing OpenCL kernel...
+      cl->release ();                                                                                // Releasing OpenCL kernel...
+    }, [&] ()
+    {
+      cl->acquire ();                                                                                // Acquiring OpenCL kernel...
+      zc->read (cl, 1, position->data);                                                              // Reading position...
+      ns->read (cl, 2, velocity->data);                                                              // Reading velocity...
+      ns->read (cl, 3, acceleration->data);                                                          // Reading acceleration...
+      ns->read (cl, 4, position_int->data);                                                          // Reading intermediate position...
+      ns->read (cl, 5, velocity_int->data);                                                          // Reading intermediate velocity...
+      cl->release ();                                                                                // Releasing OpenCL kernel...
+    }) ? 0 : 1;
+    gl->close ();                                                                                    // Closing gl (test done)...
+  }
+
+  if(scaling > 0)
+  {
+    ex::scaling (model, scaling);                                                                    // Running CPU scaling benchmark...
+    gl->close ();                                                                                    // Closing gl (benchmark done)...
+  }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////// APPLICATION LOOP /////////////////////////////////////////
@@ -263,16 +863,96 @@ int main ()
   while(!gl->closed ())                                                                              // Opening window...
   {
     cl->get_tic ();                                                                                  // Getting "tic" [us]...
-    cl->acquire ();                                                                                  // Acquiring OpenCL kernel...
-    cl->execute (K1, nu::WAIT);                                                                      // Executing OpenCL kernel...
-    cl->execute (K2, nu::WAIT);                                                                      // Executing OpenCL kernel...
-    cl->release ();                                                                                  // Releasing OpenCL kernel...
+    zc->to_cl ();                                                                                    // Waiting for the last draw...
+
+    if(view != "")
+    {
+      if(ring->fetch (position->data, color->data))
+      {
+        zc->write (cl, 0, color->data);                                                              // Writing color for plot...
+        zc->write (cl, 1, position->data);                                                           // Writing position for plot...
+      }
+    }
+    else if(on_cpu)
+    {
+      model->step (cpu);                                                                             // Executing CPU kernels...
+      zc->write (cl, 0, color->data);                                                                // Writing color for plot...
+      zc->write (cl, 1, position->data);                                                             // Writing position for plot...
+    }
+    else
+    {
+      cl->acquire ();                                                                                // Acquiring OpenCL kernel...
+      nd->execute (K1, "K1");                                                                        // Executing OpenCL kernel...
+
+      for(nu::kernel* K_h : K_hash)
+      {
+        cl->execute (K_h, nu::WAIT);                                                                 // Executing self-collision kernel...
+      }
+
+      nd->execute (K2, "K2");                                                                        // Executing OpenCL kernel...
+
+      for(nu::kernel* K_t : K_tear)
+      {
+        cl->execute (K_t, nu::WAIT);                                                                 // Executing tearing kernel...
+      }
+
+      if(tearing)
+      {
+        cl->read (26);                                                                               // Reading tearing counters (live links)...
+      }
+
+      cl->release ();                                                                                // Releasing OpenCL kernel...
+    }
+
+    // PUBLISHING SNAPSHOT (server: no rendering in the step loop):
+    if(serve != "")
+    {
+      if((publish > 0) && (step%publish == 0))
+      {
+        if(!on_cpu)
+        {
+          cl->acquire ();                                                                            // Acquiring OpenCL kernel...
+          zc->read (cl, 0, color->data);                                                             // Reading color...
+          zc->read (cl, 1, position->data);                                                          // Reading position...
+          cl->release ();                                                                            // Releasing OpenCL kernel...
+        }
+
+        ring->publish (step, position->data, color->data);                                           // Publishing snapshot...
+      }
+
+      cl->get_toc ();                                                                                // Getting "toc" [us]...
+      boot->frame ();                                                                                // Reporting startup (first step)...
+
+      if(((++step >= steps) && (steps > 0)) || ring->interrupt ())
+      {
+        gl->close ();                                                                                // Closing gl (step limit reached or interrupted)...
+      }
+
+      continue;
+    }
+
+    zc->to_gl ();                                                                                    // Handing shared arrays to OpenGL...
+
+    // DRAWING THE LIVE LINKS ONLY (the compaction packs them first, see tear.cl):
+    if(tearing && (std::max (size_t (tear->data[1]), size_t (1)) != drawn))
+    {
+      drawn = std::max (size_t (tear->data[1]), size_t (1));                                         // Setting drawn links (one at least, skipped if torn)...
+      delete S;                                                                                      // Deleting shader...
+      S     = new nu::shader ();                                                                     // Creating shader...
+      S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), nu::VERTEX);              // Setting shader source file...
+      S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), nu::GEOMETRY);            // Setting shader source file...
+      S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), nu::FRAGMENT);            // Setting shader source file...
+      S->build (drawn);                                                                              // Building shader program (live links)...
+    }
 
     gl->begin ();                                                                                    // Beginning gl...
     gl->poll_events ();                                                                              // Polling gl events...
     gl->mouse_navigation (ms_orbit_rate, ms_pan_rate, ms_decaytime);                                 // Polling mouse...
     gl->gamepad_navigation (gmp_orbit_rate, gmp_pan_rate, gmp_decaytime, gmp_deadzone);              // Polling gamepad...
+    rec->bind ();                                                                                    // Binding offscreen capture...
     gl->plot (S, pmode, vmode);                                                                      // Plotting shared arguments...
+    zc->drawn ();                                                                                    // Fencing draw...
+    rec->unbind ();                                                                                  // Reading back offscreen capture...
 
     hud->begin ();                                                                                   // Beginning HUD...
     hud->window ("FREE LATTICE PARAMETERS", 200);                                                    // Creating window...
@@ -282,46 +962,112 @@ int main ()
     hud->input ("Viscosity:       ", "[Pa*s]      ", "mu", &mu);                                     // Adding input parameter...
     hud->input ("Gravity:         ", "[m/s^2]     ", "g", &g);                                       // Adding input parameter...
 
-    if(hud->button ("(U)pdate", 100) || gl->key_U)
+    if((hud->button ("(U)pdate", 100) || gl->key_U) && (members == 1))
     {
       // RECOMPUTING PHYSICAL PARAMETERS:
       m                 = rho*h*dx*dy;                                                               // Node mass [kg].
       K                 = E*h*dy/dx;                                                                 // Elastic constant [kg/s^2].
       B                 = mu*h*dx*dy;                                                                // Damping [kg*s*m].
       dt_critical       = sqrt (m/K);                                                                // Critical time step [s].
+
+      if(mat != nullptr)
+      {
+        material->data[0] = {m, K, B, 0.0f};                                                         // Setting material 0...
+
+        for(i = 1; i < material->data.size (); i++)
+        {
+          dt_critical = std::min (dt_critical, float (sqrt (material->data[i].x/material->data[i].y))); // Getting stiffest material...
+        }
+
+        cl->write (27);                                                                              // Writing OpenCL data...
+      }
+
       dt_simulation     = 0.5f*dt_critical;                                                          // Simulation time step [s].
       dt->data[0]       = dt_simulation;                                                             // Setting simulation time step...
       friction->data[0] = B;                                                                         // Setting friction...
       gravity->data[0]  = {0.0f, 0.0f, -g, 1.0f};                                                    // Setting gravity...
+      parameter->data   = {m, K, float (DS + EPSILON)};                                              // Setting initialization parameters...
+
+      cl->write (6);                                                                                 // Writing OpenCL data...
+      cl->write (9);                                                                                 // Writing OpenCL data...
+      cl->write (15);                                                                                // Writing OpenCL data...
+      cl->write (16);                                                                                // Writing OpenCL data...
+      cl->acquire ();                                                                                // Acquiring OpenCL kernel...
+      cl->execute (K_material, nu::WAIT);                                                            // Resetting mass and stiffness on device...
+      cl->release ();                                                                                // Releasing OpenCL kernel...
+
+      spec->define ("DT_SIMULATION", dt_simulation);                                                 // Specializing time step...
+      spec->define ("FRICTION", B);                                                                  // Specializing friction...
+      spec->define ("GRAVITY", gravity->data[0]);                                                    // Specializing gravity...
 
-      // RESETTING NEUTRINO ARRAYS ("surface" depending):
-      for(i = 0; i < nodes; i++)
+      // REBUILDING SPECIALIZED KERNELS:
+      if(specialize && !on_cpu && spec->changed ())
       {
-        mass->data[i] = m;                                                                           // Setting mass...
+        cl->acquire ();                                                                              // Acquiring OpenCL kernel...
+        zc->read (cl, 0, color->data);                                                               // Reading color...
+        zc->read (cl, 1, position->data);                                                            // Reading position...
+        ns->read (cl, 32, position_node->data);                                                      // Reading node state position...
+        ns->read (cl, 2, velocity->data);                                                            // Reading velocity...
+        ns->read (cl, 3, acceleration->data);                                                        // Reading acceleration...
+        ns->read (cl, 4, position_int->data);                                                        // Reading intermediate position...
+        ns->read (cl, 5, velocity_int->data);                                                        // Reading intermediate velocity...
+        cl->read (7);                                                                                // Reading stiffness...
+        cl->read (10);                                                                               // Reading mass...
 
-        // Computing minimum element offset index:
-        if(i == 0)
+        if(tearing)
         {
-          j_min = 0;                                                                                 // Setting minimum element offset index...
+          cl->read (8);                                                                              // Reading resting (torn)...
+          cl->read (12);                                                                             // Reading neighbours (torn)...
+          cl->read (13);                                                                             // Reading offsets (torn)...
+          cl->read (26);                                                                             // Reading tearing counters...
         }
-        else
+
+        cl->release ();                                                                              // Releasing OpenCL kernel...
+        delete K1;                                                                                   // Deleting OpenCL kernel...
+        delete K2;                                                                                   // Deleting OpenCL kernel...
+        K1 = new nu::kernel ();                                                                      // Creating OpenCL kernel...
+        K2 = new nu::kernel ();                                                                      // Creating OpenCL kernel...
+
+        if(collide)
         {
-          j_min = offset->data[i - 1];                                                               // Setting minimum element offset index...
+          K2->addsource (col->write ());                                                             // Setting kernel self-collision source...
         }
 
-        j_max         = offset->data[i];                                                             // Setting maximum element offset index...
-
-        for(j = j_min; j < j_max; j++)
+        if(tearing)
         {
-          stiffness->data[j] = K;                                                                    // Setting link stiffness...
+          K2->addsource (rip->write ());                                                             // Setting kernel tearing source...
         }
+
+        K1->addsource (spec->write ());                                                              // Setting kernel specialization source...
+        K2->addsource (spec->write ());                                                              // Setting kernel specialization source...
+        K1->addsource (pad->write ());                                                               // Setting kernel padding source...
+        K1->addsource (fpd->write ());                                                               // Setting kernel precision source...
+        K1->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                          // Setting kernel source file...
+        K1->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                         // Setting kernel source file...
+        K1->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_1));                          // Setting kernel source file...
+        K1->build (nodes, 0, 0);                                                                     // Building kernel program...
+        K2->addsource (pad->write ());                                                               // Setting kernel padding source...
+        K2->addsource (fpd->write ());                                                               // Setting kernel precision source...
+        K2->addsource (mtd->write ());                                                               // Setting kernel material source...
+        K2->addsource (tld->write ());                                                               // Setting kernel tiling source...
+        K2->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                          // Setting kernel source file...
+        K2->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                         // Setting kernel source file...
+        K2->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_2));                          // Setting kernel source file...
+        K2->build (nodes, 0, 0);                                                                     // Building kernel program...
+        cl->write ();                                                                                // Writing OpenCL data...
+        zc->attach ({K_state, K_material, K1, K2});                                                  // Setting shared kernel arguments...
+        zc->attach (K_hash);                                                                         // Setting shared kernel arguments...
+        zc->attach (K_tear);                                                                         // Setting shared kernel arguments...
+        ns->attach ({K_state, K_material, K1, K2});                                                  // Setting node state kernel arguments...
+        ns->attach (K_hash);                                                                         // Setting node state kernel arguments...
+        ns->attach (K_tear);                                                                         // Setting node state kernel arguments...
       }
 
-      cl->write (6);                                                                                 // Writing OpenCL data...
-      cl->write (7);                                                                                 // Writing OpenCL data...
-      cl->write (9);                                                                                 // Writing OpenCL data...
-      cl->write (10);                                                                                // Writing OpenCL data...
-      cl->write (15);                                                                                // Writing OpenCL data...
+      if(on_cpu)
+      {
+        cl->read (7);                                                                                // Reading stiffness...
+        cl->read (10);                                                                               // Reading mass...
+      }
     }
 
     hud->space (50);                                                                                 // Setting spacing...
@@ -329,15 +1075,39 @@ int main ()
     if(hud->button ("(R)estart", 100) || gl->button_TRIANGLE || gl->key_R)
     {
       position->data     = initial_position;                                                         // Restoring backup...
-      position_int->data = initial_position_int;                                                     // Restoring backup...
-      velocity->data     = initial_velocity;                                                         // Restoring backup...
-      velocity_int->data = initial_velocity_int;                                                     // Restoring backup...
-      acceleration->data = initial_acceleration;                                                     // Restoring backup...
-      cl->write (1);                                                                                 // Writing data...
-      cl->write (2);                                                                                 // Writing data...
-      cl->write (3);                                                                                 // Writing data...
-      cl->write (4);                                                                                 // Writing data...
-      cl->write (5);                                                                                 // Writing data...
+      zc->write (cl, 1, position->data);                                                             // Writing data...
+      position_node->data = initial_position;                                                        // Restoring backup...
+      ns->write (cl, 32, position_node->data);                                                       // Writing data...
+
+      if(tearing)
+      {
+        neighbour->data = initial_neighbour;                                                         // Restoring backup...
+        offset->data    = initial_offset;                                                            // Restoring backup...
+        resting->data   = initial_resting;                                                           // Restoring backup...
+        tear->data      = {0, int (neighbours), 0};                                                  // Resetting tearing counters...
+        cl->write (8);                                                                               // Writing data...
+        cl->write (12);                                                                              // Writing data...
+        cl->write (13);                                                                              // Writing data...
+        cl->write (26);                                                                              // Writing data...
+        cl->acquire ();                                                                              // Acquiring OpenCL kernel...
+        cl->execute (K_material, nu::WAIT);                                                          // Resetting stiffness on device...
+        cl->release ();                                                                              // Releasing OpenCL kernel...
+      }
+
+      cl->acquire ();                                                                                // Acquiring OpenCL kernel...
+      cl->execute (K_state, nu::WAIT);                                                               // Resetting state on device...
+      cl->release ();                                                                                // Releasing OpenCL kernel...
+
+      if(on_cpu)
+      {
+        cl->acquire ();                                                                              // Acquiring OpenCL kernel...
+        zc->read (cl, 0, color->data);                                                               // Reading color...
+        ns->read (cl, 2, velocity->data);                                                            // Reading velocity...
+        ns->read (cl, 3, acceleration->data);                                                        // Reading acceleration...
+        ns->read (cl, 4, position_int->data);                                                        // Reading intermediate position...
+        ns->read (cl, 5, velocity_int->data);                                                        // Reading intermediate velocity...
+        cl->release ();                                                                              // Releasing OpenCL kernel...
+      }
     }
 
     hud->space (50);                                                                                 // Setting spacing...
@@ -364,19 +1134,59 @@ int main ()
     hud->end ();                                                                                     // Ending HUD...
 
     gl->end ();                                                                                      // Ending gl...
+    boot->frame ();                                                                                  // Reporting startup (first frame)...
 
     cl->get_toc ();                                                                                  // Getting "toc" [us]...
+
+    if((++step >= steps) && (steps > 0))
+    {
+      gl->close ();                                                                                  // Closing gl (step limit reached)...
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////// ENSEMBLE REPORT /////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  if(members > 1)
+  {
+    cl->acquire ();                                                                                  // Acquiring OpenCL kernel...
+    zc->read (cl, 1, position->data);                                                                // Reading position...
+    ns->read (cl, 2, velocity->data);                                                                // Reading velocity...
+    cl->release ();                                                                                  // Releasing OpenCL kernel...
+    set->report (position->data, velocity->data, dt->data, step);                                    // Printing member outputs...
   }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////// CLEANUP /////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
+  delete spec;                                                                                       // Deleting kernel specialization...
+  delete ens;                                                                                        // Deleting ensemble definitions...
+  delete col;                                                                                        // Deleting self-collision definitions...
+  delete rip;                                                                                        // Deleting tearing definitions...
+  delete fpd;                                                                                        // Deleting precision definitions...
+  delete mtd;                                                                                        // Deleting material definitions...
+  delete mat;                                                                                        // Deleting material groups...
+  delete tld;                                                                                        // Deleting tiling definitions...
+  delete pad;                                                                                        // Deleting padding guard definitions...
+  delete grid;                                                                                       // Deleting regular grid...
+  delete fp;                                                                                         // Deleting precision...
+  delete set;                                                                                        // Deleting parameter ensemble...
+  delete model;                                                                                      // Deleting CPU model...
+  delete cpu;                                                                                        // Deleting CPU backend...
+  delete ring;                                                                                       // Deleting snapshot ring...
+  delete nd;                                                                                         // Deleting step kernel dispatch...
+  delete ns;                                                                                         // Deleting node state...
+  delete zc;                                                                                         // Deleting zero-copy sharing...
+  delete rec;                                                                                        // Deleting offscreen capture...
   delete cl;                                                                                         // Deleting OpenCL context...
   delete gl;                                                                                         // Deleting OpenGL context...
+  delete opt;                                                                                        // Deleting command line options...
+  delete boot;                                                                                       // Deleting startup pipeline...
   delete hud;                                                                                        // Deleting HUD context...
   delete S;                                                                                          // Deleting shader...
   delete color;                                                                                      // Deleting color data...
   delete position;                                                                                   // Deleting position data...
+  delete position_node;                                                                              // Deleting node state position data...
   delete position_int;                                                                               // Deleting intermediate position data...
   delete velocity;                                                                                   // Deleting velocity data...
   delete velocity_int;                                                                               // Deleting intermediate velocity data...
@@ -386,14 +1196,44 @@ int main ()
   delete resting;                                                                                    // Deleting resting data...
   delete friction;                                                                                   // Deleting friction data...
   delete mass;                                                                                       // Deleting mass data...
-  delete central;                                                                                    // Deleting centrals...
+  delete encoding;                                                                                   // Deleting neighbour index encoding...
+  delete topo;                                                                                       // Deleting neighbour list encoding...
   delete neighbour;                                                                                  // Deleting neighbours...
   delete offset;                                                                                     // Deleting offset...
   delete freedom;                                                                                    // Deleting freedom flag data...
   delete dt;                                                                                         // Deleting time step data...
+  delete parameter;                                                                                  // Deleting initialization parameters...
+  delete cell;                                                                                       // Deleting hash cells...
+  delete count;                                                                                      // Deleting hash cell counts...
+  delete start;                                                                                      // Deleting hash cell starts...
+  delete sorted;                                                                                     // Deleting sorted nodes...
+  delete block;                                                                                      // Deleting hash block sums...
+  delete collision;                                                                                  // Deleting collision forces...
+  delete tear_rank;                                                                                  // Deleting kept link ranks...
+  delete tear_block;                                                                                 // Deleting tear block sums...
+  delete tear_spare;                                                                                 // Deleting compaction scratch...
+  delete tear;                                                                                       // Deleting tearing counters...
+  delete material;                                                                                   // Deleting material table...
+  delete link_material;                                                                              // Deleting link material ids...
+  delete node_material;                                                                              // Deleting node material ids...
+  delete tile_node;                                                                                  // Deleting grid cell nodes...
+  delete tile_link;                                                                                  // Deleting link stencil codes...
+  delete K_state;                                                                                    // Deleting OpenCL kernel...
+  delete K_material;                                                                                 // Deleting OpenCL kernel...
   delete K1;                                                                                         // Deleting OpenCL kernel...
   delete K2;                                                                                         // Deleting OpenCL kernel...
+
+  for(nu::kernel* K_h : K_hash)
+  {
+    delete K_h;                                                                                      // Deleting OpenCL kernel...
+  }
+
+  for(nu::kernel* K_t : K_tear)
+  {
+    delete K_t;                                                                                      // Deleting OpenCL kernel...
+  }
+
   delete cloth;                                                                                      // deleting cloth mesh...
 
-  return 0;
+  return status;
 }
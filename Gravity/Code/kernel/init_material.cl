@@ -0,0 +1,57 @@
+/// @file
+
+/// @brief **Material kernel.**
+/// @details It sets the mass of each node to parameter[0] and the stiffness of its links to
+/// parameter[1], directly on the device. With MATERIALS, both are read from the material table
+/// (see materials.hpp) and nothing is set.
+__kernel void thekernel(__global float4*    color,                                    // Color [#].
+                        __global float4*    position_gl,                              // Position (plotted copy) [m].
+                        __global float4*    velocity,                                 // Velocity [m/s].
+                        __global float4*    acceleration,                             // Acceleration [m/s^2].
+                        __global float4*    position_int,                             // Position (intermediate) [m].
+                        __global float4*    velocity_int,                             // Velocity (intermediate) [m/s].
+                        __global float*     radius,                                   // Particle radius [m].
+                        __global float*     stiffness,                                // Stiffness
+                        __global float*     resting,                                  // Resting distance [m].
+                        __global float*     friction,                                 // Friction
+                        __global float*     mass,                                     // Mass [kg].
+                        __global int*       encoding,                                 // Neighbour index encoding.
+                        __global int*       nearest,                                  // Neighbour.
+                        __global int*       offset,                                   // Offset.
+                        __global int*       freedom,                                  // Freedom flag.
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global float*     parameter,                                // Initialization parameters.
+                        __global int*       level,                                    // Multirate time step level.
+                        __global int*       order,                                    // Nodes sorted by level.
+                        __global int*       schedule,                                 // Multirate schedule (substep, level counts).
+                        __global int*       render,                                   // Render list (links to draw).
+                        __constant float4*  material,                                 // Material table (m, K, B).
+                        __global uchar*     link_material,                            // Link material id.
+                        __global uchar*     node_material,                            // Node material id.
+                        __global int*       tile_node,                                // Node of each grid cell (tiling).
+                        __global uchar*     tile_link,                                // Stencil code of each link (tiling).
+                        __global float4*    position)                                 // Position (node state) [m].
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int i = get_global_id(0);                                            // Global index [#].
+  unsigned int j = 0;                                                           // Neighbour stride index.
+  unsigned int j_min = 0;                                                       // Neighbour stride minimun index.
+  unsigned int j_max = STRIDE_MAX(i);                                           // Neighbour stride maximum index.
+  float        m     = parameter[0];                                            // Node mass [kg].
+  float        K     = parameter[1];                                            // Link stiffness [kg/s^2].
+
+  // COMPUTING STRIDE MINIMUM INDEX:
+  j_min = STRIDE_MIN(i);                                                        // Setting stride minimum...
+
+  // SETTING MATERIAL (per-link and per-node arrays only):
+#ifndef MATERIALS
+  mass[i] = m;                                                                  // Setting mass...
+
+  for (j = j_min; j < j_max; j += LINK_STEP)
+  {
+    stiffness[j] = K;                                                           // Setting link stiffness...
+  }
+#endif
+}
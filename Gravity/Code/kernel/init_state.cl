@@ -0,0 +1,65 @@
+/// @file
+
+/// @brief **Initial state kernel.**
+/// @details It sets the initial kinematics of each node (intermediate position equal to the
+/// position, null velocity and acceleration) and the color of its links, directly on the device.
+/// Links longer than parameter[2] are hidden.
+__kernel void thekernel(__global float4*    color,                                    // Color [#].
+                        __global float4*    position_gl,                              // Position (plotted copy) [m].
+                        __global STATE4*    velocity,                                 // Velocity [m/s].
+                        __global STATE4*    acceleration,                             // Acceleration [m/s^2].
+                        __global POSITION4* position_int,                             // Position (intermediate) [m].
+                        __global STATE4*    velocity_int,                             // Velocity (intermediate) [m/s].
+                        __global float*     radius,                                   // Particle radius [m].
+                        __global float*     stiffness,                                // Stiffness
+                        __global float*     resting,                                  // Resting distance [m].
+                        __global float*     friction,                                 // Friction
+                        __global float*     mass,                                     // Mass [kg].
+                        __global int*       encoding,                                 // Neighbour index encoding.
+                        __global int*       nearest,                                  // Neighbour.
+                        __global int*       offset,                                   // Offset.
+                        __global int*       freedom,                                  // Freedom flag.
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global float*     parameter,                                // Initialization parameters.
+                        __global int*       level,                                    // Multirate time step level.
+                        __global int*       order,                                    // Nodes sorted by level.
+                        __global int*       schedule,                                 // Multirate schedule (substep, level counts).
+                        __global int*       render,                                   // Render list (links to draw).
+                        __constant float4*  material,                                 // Material table (m, K, B).
+                        __global uchar*     link_material,                            // Link material id.
+                        __global uchar*     node_material,                            // Node material id.
+                        __global int*       tile_node,                                // Node of each grid cell (tiling).
+                        __global uchar*     tile_link,                                // Stencil code of each link (tiling).
+                        __global POSITION4* position)                                 // Position (node state) [m].
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int i = get_global_id(0);                                            // Global index [#].
+  unsigned int j = 0;                                                           // Neighbour stride index.
+  unsigned int j_min = 0;                                                       // Neighbour stride minimun index.
+  unsigned int j_max = STRIDE_MAX(i);                                           // Neighbour stride maximum index.
+  float        L_max = parameter[2];                                            // Maximum visible link length.
+
+  // COMPUTING STRIDE MINIMUM INDEX:
+  j_min = STRIDE_MIN(i);                                                        // Setting stride minimum...
+
+  // SETTING INITIAL KINEMATICS:
+  position_int[i] = position[i];                                                // Setting intermediate position...
+  velocity[i]     = (STATE4)(0.0f, 0.0f, 0.0f, 1.0f);                           // Setting velocity...
+  velocity_int[i] = (STATE4)(0.0f, 0.0f, 0.0f, 1.0f);                           // Setting intermediate velocity...
+  acceleration[i] = (STATE4)(0.0f, 0.0f, 0.0f, 1.0f);                           // Setting acceleration...
+
+  // SETTING LINK COLORS:
+  for (j = j_min; j < j_max; j += LINK_STEP)
+  {
+    if (resting[j] > L_max)
+    {
+      color[j] = (float4)(0.0f, 0.0f, 0.0f, 0.0f);                              // Setting link color (hidden)...
+    }
+    else
+    {
+      color[j] = (float4)(0.0f, 1.0f, 0.0f, 1.0f);                              // Setting link color...
+    }
+  }
+}
@@ -0,0 +1,113 @@
+/// @file
+
+// SPECIALIZATION (values injected at build time, see specialization.hpp; runtime otherwise):
+#ifndef DT_SIMULATION
+  #define DT_SIMULATION dt_simulation[0]                                        // Simulation time step (runtime).
+#endif
+#ifndef FRICTION
+  #define FRICTION friction[0]                                                  // Friction (runtime).
+#endif
+#ifndef RADIUS
+  #define RADIUS radius[0]                                                      // Attractive nucleus radius (runtime).
+#endif
+
+// MATERIALS (per-group table, see materials.hpp; per-link and per-node arrays otherwise):
+#ifdef MATERIALS
+  #define LINK_STIFFNESS(j) material[link_material[j]].y                        // Link stiffness (material table).
+  #define NODE_MASS(n)      material[node_material[n]].x                        // Node mass (material table).
+  #define NODE_FRICTION(n)  material[node_material[n]].z                        // Node friction (material table).
+#else
+  #define LINK_STIFFNESS(j) stiffness[j]                                        // Link stiffness (per link).
+  #define NODE_MASS(n)      mass[n]                                             // Node mass (per node).
+  #define NODE_FRICTION(n)  FRICTION                                            // Node friction (runtime or specialized).
+#endif
+
+/// @brief **Multirate level kernel.**
+/// @details It sets the time step level of each node: the node's own time step is the largest
+/// power-of-two multiple of DT_SIMULATION not exceeding its local stability limit (from the
+/// stiffness of its links, its mass and the friction) nor its motion limit (from its speed and
+/// acceleration relative to its shortest link). Constrained nodes take the coarsest level.
+__kernel void thekernel(__global float4*    color,                                    // Color [#].
+                        __global float4*    position_gl,                              // Position (plotted copy) [m].
+                        __global STATE4*    velocity,                                 // Velocity [m/s].
+                        __global STATE4*    acceleration,                             // Acceleration [m/s^2].
+                        __global POSITION4* position_int,                             // Position (intermediate) [m].
+                        __global STATE4*    velocity_int,                             // Velocity (intermediate) [m/s].
+                        __global float*     radius,                                   // Particle radius [m].
+                        __global float*     stiffness,                                // Stiffness
+                        __global float*     resting,                                  // Resting distance [m].
+                        __global float*     friction,                                 // Friction
+                        __global float*     mass,                                     // Mass [kg].
+                        __global int*       encoding,                                 // Neighbour index encoding.
+                        __global int*       nearest,                                  // Neighbour.
+                        __global int*       offset,                                   // Offset.
+                        __global int*       freedom,                                  // Freedom flag.
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global float*     parameter,                                // Initialization parameters.
+                        __global int*       level,                                    // Multirate time step level.
+                        __global int*       order,                                    // Nodes sorted by level.
+                        __global int*       schedule,                                 // Multirate schedule (substep, level counts).
+                        __global int*       render,                                   // Render list (links to draw).
+                        __constant float4*  material,                                 // Material table (m, K, B).
+                        __global uchar*     link_material,                            // Link material id.
+                        __global uchar*     node_material,                            // Node material id.
+                        __global int*       tile_node,                                // Node of each grid cell (tiling).
+                        __global uchar*     tile_link,                                // Stencil code of each link (tiling).
+                        __global POSITION4* position)                                 // Position (node state) [m].
+{
+  // PADDING (global size rounded up to a multiple of the local size, see autotune.hpp):
+  #ifdef NODES
+  if (get_global_id(0) >= NODES)
+  {
+    return;                                                                           // Skipping padding work-item...
+  }
+  #endif
+
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int i = get_global_id(0);                                            // Global index [#].
+  unsigned int j = 0;                                                           // Neighbour stride index.
+  unsigned int j_min = 0;                                                       // Neighbour stride minimun index.
+  unsigned int j_max = STRIDE_MAX(i);                                           // Neighbour stride maximum index.
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////// CELL VARIABLES //////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  float4       p     = convert_float4(position[i]);                             // Central node position.
+  float        v     = length(velocity[i].xyz);                                 // Central node speed [m/s].
+  float        a     = length(acceleration[i].xyz);                             // Central node acceleration [m/s^2].
+  float        m     = NODE_MASS(i);                                            // Central node mass [kg].
+  float        B     = NODE_FRICTION(i);                                        // Friction [kg/s].
+  float        K     = 0.0f;                                                    // Total link stiffness [kg/s^2].
+  float        R     = MAXFLOAT;                                                // Shortest link resting length [m].
+  float        dt    = MAXFLOAT;                                                // Node time step limit [s].
+  int          l     = 0;                                                       // Node time step level.
+
+  // COMPUTING STRIDE MINIMUM INDEX:
+  j_min = STRIDE_MIN(i);                                                        // Setting stride minimum...
+
+  // COMPUTING LOCAL STIFFNESS:
+  for (j = j_min; j < j_max; j += LINK_STEP)
+  {
+    K += LINK_STIFFNESS(j);                                                     // Building up total link stiffness...
+    R = fmin(R, resting[j]);                                                    // Finding shortest link...
+  }
+
+  // COMPUTING TIME STEP LIMIT (constrained nodes do not move):
+  if ((freedom[i] != 0) && (length(p.xyz) >= RADIUS))
+  {
+    dt = MULTIRATE_STABILITY*sqrt(2.0f*m/K);                                    // Elastic limit (2/w, w^2 <= 2*K/m)...
+    dt = fmin(dt, MULTIRATE_STABILITY*2.0f*m/B);                                // Viscous limit...
+    dt = fmin(dt, MULTIRATE_ETA*sqrt(R/fmax(a, 1.0e-12f)));                     // Acceleration limit...
+    dt = fmin(dt, MULTIRATE_ETA*R/fmax(v, 1.0e-12f));                           // Speed limit...
+  }
+
+  // COMPUTING LEVEL:
+  while ((l < LEVELS - 1) && ((float)(2 << l)*DT_SIMULATION <= dt))
+  {
+    l++;                                                                        // Doubling time step...
+  }
+
+  level[i] = l;                                                                 // Setting level...
+}
@@ -0,0 +1,34 @@
+/// @file
+
+/// @brief **Multirate tick kernel.**
+/// @details It advances the multirate substep counter; it runs on a single work-item.
+__kernel void thekernel(__global float4*    color,                                    // Color [#].
+                        __global float4*    position_gl,                              // Position (plotted copy) [m].
+                        __global STATE4*    velocity,                                 // Velocity [m/s].
+                        __global STATE4*    acceleration,                             // Acceleration [m/s^2].
+                        __global POSITION4* position_int,                             // Position (intermediate) [m].
+                        __global STATE4*    velocity_int,                             // Velocity (intermediate) [m/s].
+                        __global float*     radius,                                   // Particle radius [m].
+                        __global float*     stiffness,                                // Stiffness
+                        __global float*     resting,                                  // Resting distance [m].
+                        __global float*     friction,                                 // Friction
+                        __global float*     mass,                                     // Mass [kg].
+                        __global int*       encoding,                                 // Neighbour index encoding.
+                        __global int*       nearest,                                  // Neighbour.
+                        __global int*       offset,                                   // Offset.
+                        __global int*       freedom,                                  // Freedom flag.
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global float*     parameter,                                // Initialization parameters.
+                        __global int*       level,                                    // Multirate time step level.
+                        __global int*       order,                                    // Nodes sorted by level.
+                        __global int*       schedule,                                 // Multirate schedule (substep, level counts).
+                        __global int*       render,                                   // Render list (links to draw).
+                        __constant float4*  material,                                 // Material table (m, K, B).
+                        __global uchar*     link_material,                            // Link material id.
+                        __global uchar*     node_material,                            // Node material id.
+                        __global int*       tile_node,                                // Node of each grid cell (tiling).
+                        __global uchar*     tile_link,                                // Stencil code of each link (tiling).
+                        __global POSITION4* position)                                 // Position (node state) [m].
+{
+  schedule[0] = (schedule[0] + 1) % (1 << (LEVELS - 1));                        // Advancing substep...
+}
@@ -1,82 +1,187 @@
 /// @file
 
+// SPECIALIZATION (values injected at build time, see specialization.hpp; runtime otherwise):
+#ifndef DT_SIMULATION
+  #define DT_SIMULATION dt_simulation[0]                                        // Simulation time step (runtime).
+#endif
+#ifndef FRICTION
+  #define FRICTION friction[0]                                                  // Friction (runtime).
+#endif
+#ifndef RADIUS
+  #define RADIUS radius[0]                                                      // Attractive nucleus radius (runtime).
+#endif
+
+// MATERIALS (per-group table, see materials.hpp; per-link and per-node arrays otherwise):
+#ifdef MATERIALS
+  #define LINK_STIFFNESS(j) material[link_material[j]].y                        // Link stiffness (material table).
+  #define NODE_MASS(n)      material[node_material[n]].x                        // Node mass (material table).
+  #define NODE_FRICTION(n)  material[node_material[n]].z                        // Node friction (material table).
+#else
+  #define LINK_STIFFNESS(j) stiffness[j]                                        // Link stiffness (per link).
+  #define NODE_MASS(n)      mass[n]                                             // Node mass (per node).
+  #define NODE_FRICTION(n)  FRICTION                                            // Node friction (runtime or specialized).
+#endif
+
+// TILING (regular grids: one work-item per grid cell, neighbours read from a tile, see tiling.hpp):
+#ifdef TILE
+  #define TILE_DELTA(s) ((int)(s)%3 - 1 + TILE_X*((int)(s)/3%3 - 1) + TILE_X*TILE_Y*((int)(s)/9 - 1)) // Cell offset of stencil code.
+#endif
+
 __kernel void thekernel(__global float4*    color,                                    // Color [#].
-                        __global float4*    position,                                 // Position [m].
-                        __global float4*    velocity,                                 // Velocity [m/s].
-                        __global float4*    acceleration,                             // Acceleration [m/s^2].
-                        __global float4*    position_int,                             // Position (intermediate) [m].
-                        __global float4*    velocity_int,                             // Velocity (intermediate) [m/s].
+                        __global float4*    position_gl,                              // Position (plotted copy) [m].
+                        __global STATE4*    velocity,                                 // Velocity [m/s].
+                        __global STATE4*    acceleration,                             // Acceleration [m/s^2].
+                        __global POSITION4* position_int,                             // Position (intermediate) [m].
+                        __global STATE4*    velocity_int,                             // Velocity (intermediate) [m/s].
                         __global float*     radius,                                   // Particle radius [m].
                         __global float*     stiffness,                                // Stiffness
                         __global float*     resting,                                  // Resting distance [m].
                         __global float*     friction,                                 // Friction
                         __global float*     mass,                                     // Mass [kg].
-                        __global int*       central,                                  // Node.
+                        __global int*       encoding,                                 // Neighbour index encoding.
                         __global int*       nearest,                                  // Neighbour.
                         __global int*       offset,                                   // Offset.
                         __global int*       freedom,                                  // Freedom flag.
-                        __global float*     dt_simulation)                            // Simulation time step [s].
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global float*     parameter,                                // Initialization parameters.
+                        __global int*       level,                                    // Multirate time step level.
+                        __global int*       order,                                    // Nodes sorted by level.
+                        __global int*       schedule,                                 // Multirate schedule (substep, level counts).
+                        __global int*       render,                                   // Render list (links to draw).
+                        __constant float4*  material,                                 // Material table (m, K, B).
+                        __global uchar*     link_material,                            // Link material id.
+                        __global uchar*     node_material,                            // Node material id.
+                        __global int*       tile_node,                                // Node of each grid cell (tiling).
+                        __global uchar*     tile_link,                                // Stencil code of each link (tiling).
+                        __global POSITION4* position)                                 // Position (node state) [m].
 {
+#ifdef TILE
+  // LOADING TILE (cells of the work-group and halo, once per work-group):
+  __local POSITION4 tile[TILE_SPAN];                                            // Tile positions [m].
+  int               t_min = (int)(get_group_id(0)*get_local_size(0)) - TILE_HALO; // First tile cell [#].
+  int               t     = 0;                                                  // Tile index [#].
+  bool              tiled = (get_local_size(0) <= TILE_LOCAL);                  // Tile flag (work-group fits the tile).
+
+  if (tiled)
+  {
+    for (t = get_local_id(0); t < (int)get_local_size(0) + 2*TILE_HALO; t += get_local_size(0))
+    {
+      if ((t_min + t >= 0) && (t_min + t < TILE_CELLS))
+      {
+        tile[t] = position_int[tile_node[t_min + t]];                           // Loading cell position...
+      }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);                                               // Waiting for the whole tile...
+  }
+#endif
+
+  // PADDING (global size rounded up to a multiple of the local size, see autotune.hpp):
+  #ifdef NODES
+  if (get_global_id(0) >= NODES)
+  {
+    return;                                                                     // Skipping padding work-item...
+  }
+  #endif
+
   ////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// INDEXES ///////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////
+#ifdef MULTIRATE
+  unsigned int s = schedule[0];                                                 // Substep [#].
+  unsigned int l = 0;                                                           // Coarsest level ending at this substep.
+
+  // SKIPPING NODES IN MID-STEP (nodes are sorted by level, the finest first):
+  while ((l < LEVELS - 1) && ((((s + 1) >> l) & 1) == 0))
+  {
+    l++;                                                                        // Finding coarsest level ending at this substep...
+  }
+
+  if (get_global_id(0) >= schedule[1 + l])
+  {
+    return;                                                                     // Skipping node in mid-step...
+  }
+
+  unsigned int i = order[get_global_id(0)];                                     // Global index [#].
+#elif defined(TILE)
+  unsigned int i = tile_node[get_global_id(0)];                                 // Global index (node of grid cell) [#].
+#else
   unsigned int i = get_global_id(0);                                            // Global index [#].
+#endif
   unsigned int j = 0;                                                           // Neighbour stride index.
   unsigned int j_min = 0;                                                       // Neighbour stride minimun index.
-  unsigned int j_max = offset[i];                                               // Neighbour stride maximum index.
+  unsigned int j_max = STRIDE_MAX(i);                                           // Neighbour stride maximum index.
   unsigned int k = 0;                                                           // Neighbour tuple index.
-  unsigned int n = central[j_max - 1];                                          // Node index.
+  unsigned int n = i;                                                           // Node index (implicit central node).
+  int          e = encoding[0];                                                 // Neighbour index encoding.
 
   ////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////// CELL VARIABLES //////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////
   float4        c;                                                              // Central node color.
-  float4        v                 = velocity[n];                                // Central node velocity.
-  float4        a                 = acceleration[n];                            // Central node acceleration.
-  float4        p_int             = position_int[n];                            // Central node position (intermediate).
-  float4        v_int             = velocity_int[n];                            // Central node velocity (intermediate).
-  float4        p_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node position (new).
-  float4        v_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node velocity (new).
-  float4        a_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node acceleration (new).
-  float4        v_est             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node velocity (estimation).
-  float4        a_est             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node acceleration (estimation).
-  float         m                 = mass[n];                                    // Central node mass.
-  float         R0                = radius[0];                                  // Attractive nucleus radius.
-  float         B                 = friction[0];                                // Central node friction.
+  REAL4         v                 = TO_REAL4(velocity[n]);                      // Central node velocity.
+  REAL4         a                 = TO_REAL4(acceleration[n]);                  // Central node acceleration.
+  ACC4          p_int             = TO_ACC4(position_int[n]);                   // Central node position (intermediate).
+  REAL4         v_int             = TO_REAL4(velocity_int[n]);                  // Central node velocity (intermediate).
+  ACC4          p_new             = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Central node position (new).
+  REAL4         v_new             = (REAL4)(0.0f, 0.0f, 0.0f, 1.0f);            // Central node velocity (new).
+  REAL4         a_new             = (REAL4)(0.0f, 0.0f, 0.0f, 1.0f);            // Central node acceleration (new).
+  REAL4         v_est             = (REAL4)(0.0f, 0.0f, 0.0f, 1.0f);            // Central node velocity (estimation).
+  REAL4         a_est             = (REAL4)(0.0f, 0.0f, 0.0f, 1.0f);            // Central node acceleration (estimation).
+  float         m                 = NODE_MASS(n);                               // Central node mass.
+  float         R0                = RADIUS;                                     // Attractive nucleus radius.
+  float         B                 = NODE_FRICTION(n);                           // Central node friction.
   float         fr                = freedom[n];                                 // Central node freedom flag.
-  float4        Fe                = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node elastic force.  
-  float4        Fv                = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node viscous force.
-  float4        Fv_est            = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node viscous force (estimation).
-  float4        Fg                = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node gravitational force. 
-  float4        F                 = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node total force.
-  float4        F_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node total force (new).
-  float4        neighbour         = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Neighbour node position.
-  float4        link              = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Neighbour link.
-  float4        D                 = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Neighbour displacement.
+  ACC4          Fe                = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Central node elastic force.
+  ACC4          Fv                = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Central node viscous force.
+  ACC4          Fv_est            = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Central node viscous force (estimation).
+  ACC4          Fg                = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Central node gravitational force.
+  ACC4          F                 = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Central node total force.
+  ACC4          F_new             = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Central node total force (new).
+  ACC4          neighbour         = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Neighbour node position.
+  ACC4          link              = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Neighbour link.
+  ACC4          D                 = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Neighbour displacement.
   float         R                 = 0.0f;                                       // Neighbour link resting length.
   float         K                 = 0.0f;                                       // Neighbour link stiffness.
-  float         S                 = 0.0f;                                       // Neighbour link strain.
-  float         L                 = 0.0f;                                       // Neighbour link length.
-  float         dt                = dt_simulation[0];                           // Simulation time step [s].
+  ACC           S                 = 0.0f;                                       // Neighbour link strain.
+  ACC           L                 = 0.0f;                                       // Neighbour link length.
+  REAL          dt                = DT_SIMULATION;                              // Simulation time step [s].
+
+#ifdef MULTIRATE
+  dt = (REAL)(1 << level[n])*DT_SIMULATION;                                     // Setting node's own time step [s]...
+#endif
 
   // COMPUTING STRIDE MINIMUM INDEX:
-  if (i == 0)
-  {
-    j_min = 0;                                                                  // Setting stride minimum (first stride)...
-  }
-  else
-  {
-    j_min = offset[i - 1];                                                      // Setting stride minimum (all others)...
-  }
+  j_min = STRIDE_MIN(i);                                                        // Setting stride minimum...
 
   // COMPUTING ELASTIC FORCE:
-  for (j = j_min; j < j_max; j++)
+#ifdef NEIGHBOURS
+  #pragma unroll                                                                // Unrolling fixed maximum stride...
+  for (j = j_min; j < j_min + NEIGHBOURS*LINK_STEP; j += LINK_STEP)
+  {
+    if (j >= j_max) break;                                                      // Skipping missing neighbours...
+#else
+  for (j = j_min; j < j_max; j += LINK_STEP)
   {
-    k = nearest[j];                                                             // Computing neighbour index...
-    neighbour = position_int[k];                                                // Getting neighbour position...
+#endif
+#ifdef TILE
+    if (tiled)
+    {
+      neighbour = TO_ACC4(tile[(int)get_local_id(0) + TILE_HALO + TILE_DELTA(tile_link[j])]); // Getting neighbour position (tile)...
+      k = 0;                                                                    // Skipping neighbour index...
+    }
+    else
+    {
+      k = neighbour_index(nearest, e, j, n);                                    // Computing neighbour index...
+      neighbour = TO_ACC4(position_int[k]);                                     // Getting neighbour position...
+    }
+#else
+    k = neighbour_index(nearest, e, j, n);                                      // Computing neighbour index...
+    neighbour = TO_ACC4(position_int[k]);                                       // Getting neighbour position...
+#endif
     link = neighbour - p_int;                                                   // Getting neighbour link vector...
     R = resting[j];                                                             // Getting neighbour link resting length...
-    K = stiffness[j];                                                           // Getting neighbour link stiffness...
+    K = LINK_STIFFNESS(j);                                                      // Getting neighbour link stiffness...
     L = length(link);                                                           // Computing neighbour link length...
     S = L - R;                                                                  // Computing neighbour link strain...
     
@@ -91,7 +196,7 @@ __kernel void thekernel(__global float4*    color,
     }
     else
     {
-      D = (float4)(0.0f, 0.0f, 0.0f, 0.0f);
+      D = (ACC4)(0.0f, 0.0f, 0.0f, 0.0f);
     }
 
     Fe += K*D;                                                                  // Building up elastic force on central node...
@@ -100,31 +205,31 @@ __kernel void thekernel(__global float4*    color,
   // APPLYING FREEDOM CONSTRAINTS:
   if ((fr == 0) || (length(p_int.xyz) < R0))
   {
-    a_new = (float4)(0.0f, 0.0f, 0.0f, 1.0f);                                   // Constraining acceleration...
-    v_new = (float4)(0.0f, 0.0f, 0.0f, 1.0f);                                   // Constraining velocity...
+    a_new = (REAL4)(0.0f, 0.0f, 0.0f, 1.0f);                                    // Constraining acceleration...
+    v_new = (REAL4)(0.0f, 0.0f, 0.0f, 1.0f);                                    // Constraining velocity...
   }
   if ((fr != 0) && (length(p_int.xyz) >= R0))
   {
-    Fg = (float4)(-(m/pown(length(p_int.xyz), 2))*normalize(p_int.xyz), 1.0f);  // Computing gravitational force [N]...
-    Fv = -B*v_int;                                                              // Computing node viscous force...
+    Fg = (ACC4)(-(m/pown(length(p_int.xyz), 2))*normalize(p_int.xyz), 1.0f);    // Computing gravitational force [N]...
+    Fv = TO_ACC4(-B*v_int);                                                     // Computing node viscous force...
 
     // COMPUTING TOTAL FORCE:
     F  = Fe + Fv + Fg;                                                          // Total force applied to the particle [N]...
 
     // COMPUTING NEW ACCELERATION ESTIMATION:
-    a_est  = F/m;                                                                 // Computing acceleration [m/s^2]...
+    a_est  = TO_REAL4(F/m);                                                       // Computing acceleration [m/s^2]...
 
     // COMPUTING NEW VELOCITY ESTIMATION:
     v_est = v + 0.5f*(a + a_est)*dt;                                              // Computing velocity...
 
     // COMPUTING NEW VISCOUS FORCE ESTIMATION:
-    Fv_est = -B*v_est;                                                            // Computing node viscous force...
+    Fv_est = TO_ACC4(-B*v_est);                                                   // Computing node viscous force...
 
     // COMPUTING NEW TOTAL FORCE:
     F_new = Fg + Fe + Fv_est;                                                     // Computing total node force...
 
     // COMPUTING NEW ACCELERATION:
-    a_new = F_new/m;                                                              // Computing acceleration...
+    a_new = TO_REAL4(F_new/m);                                                    // Computing acceleration...
 
     // COMPUTING NEW VELOCITY:
     v_new = v + 0.5f*(a + a_new)*dt;                                              // Computing velocity...
@@ -136,7 +241,8 @@ __kernel void thekernel(__global float4*    color,
   a_new.w = 1.0f;                                                               // Adjusting projective space...
 
   // UPDATING KINEMATICS:
-  position[n] = p_int;                                                          // Updating position [m]...
-  velocity[n] = v_new;                                                          // Updating velocity [m/s]...
-  acceleration[n] = a_new;                                                      // Updating acceleration [m/s^2]...
+  position[n] = TO_POSITION4(p_int);                                            // Updating position [m]...
+  position_gl[n] = convert_float4(p_int);                                       // Updating plotted position [m]...
+  velocity[n] = TO_STATE4(v_new);                                               // Updating velocity [m/s]...
+  acceleration[n] = TO_STATE4(a_new);                                           // Updating acceleration [m/s^2]...
 }
@@ -2,7 +2,18 @@
 /// @author   Erik ZORZIN
 /// @date     26MAR2021
 /// @brief    Some useful functions.
-/// @details  Colormap.
+/// @details  Colormap, neighbour stride layout and neighbour index decoding.
+
+// NEIGHBOUR LAYOUT (SELL = slice height, see sell.hpp; CSR otherwise):
+#ifdef SELL
+  #define STRIDE_MIN(i) (offset[((i)/SELL)*(SELL + 1)] + (i)%SELL)              // Stride minimum (slice start + lane).
+  #define STRIDE_MAX(i) (STRIDE_MIN(i) + SELL*offset[((i)/SELL)*(SELL + 1) + 1 + (i)%SELL]) // Stride maximum.
+  #define LINK_STEP     SELL                                                    // Link step (column-major slices).
+#else
+  #define STRIDE_MIN(i) (((i) == 0) ? 0 : offset[(i) - 1])                      // Stride minimum (CSR).
+  #define STRIDE_MAX(i) (offset[i])                                             // Stride maximum (CSR).
+  #define LINK_STEP     1                                                       // Link step (contiguous strides).
+#endif
 
 float3 colormap (float intensity)
 {
@@ -282,3 +293,21 @@ float3 colormap (float intensity)
 
     return (float3)(turbo_colormap[i]);
 }
+
+/// @brief **Neighbour index.**
+/// @details Decodes the neighbour of the j-th link of node "n" according to the neighbour index
+/// encoding (see topology.hpp): 0 = 32-bit indices, 1 = 16-bit indices, 2 = 16-bit deltas from "n".
+int neighbour_index (__global int* nearest, int encoding, unsigned int j, unsigned int n)
+{
+    if(encoding == 1)
+    {
+        return ((__global ushort*)nearest)[j];
+    }
+
+    if(encoding == 2)
+    {
+        return (int)n + ((__global short*)nearest)[j];
+    }
+
+    return nearest[j];
+}
@@ -3,7 +3,6 @@
 /// @date     11MAR2021
 /// @brief    Central gravitational potantial simulated attractor in a 3D continuum body.
 
-#define INTEROP       true                                                                           // "true" = use OpenGL-OpenCL interoperability.
 #define SX            800                                                                            // Window x-size [px].
 #define SY            600                                                                            // Window y-size [px].
 #define NM            "Neutrino - Gravity"                                                           // Window name.
@@ -28,22 +27,46 @@
 #define SHADER_VERT   "voxel_vertex.vert"                                                            // OpenGL vertex shader.
 #define SHADER_GEOM   "voxel_geometry.geom"                                                          // OpenGL geometry shader.
 #define SHADER_FRAG   "voxel_fragment.frag"                                                          // OpenGL fragment shader.
+#define INIT_STATE    "init_state.cl"                                                                // OpenCL kernel source (initial state).
+#define INIT_MATERIAL "init_material.cl"                                                             // OpenCL kernel source (material).
 #define KERNEL_1      "thekernel1.cl"                                                                // OpenCL kernel source.
 #define KERNEL_2      "thekernel2.cl"                                                                // OpenCL kernel source.
+#define KERNEL_SPEC   "gravity_specialization.cl"                                                    // OpenCL kernel specialization (generated).
+#define KERNEL_MR     "gravity_multirate.cl"                                                         // OpenCL multirate definitions (generated).
+#define KERNEL_FP     "gravity_precision.cl"                                                         // OpenCL precision definitions (generated).
+#define KERNEL_MAT    "gravity_materials.cl"                                                         // OpenCL material definitions (generated).
+#define KERNEL_TILE   "gravity_tiling.cl"                                                            // OpenCL tiling definitions (generated).
+#define KERNEL_PAD    "gravity_padding.cl"                                                           // OpenCL padding guard definitions (generated).
+#define TILE_LOCAL    256                                                                            // Largest tiled work-group size.
+#define FP_TYPES      "precision.cl"                                                                 // OpenCL precision types source.
+#define MR_LEVEL      "multirate_level.cl"                                                           // OpenCL kernel source (multirate levels).
+#define MR_TICK       "multirate_tick.cl"                                                            // OpenCL kernel source (multirate substep).
 #define UTILITIES     "utilities.cl"                                                                 // OpenCL kernel source.
 #define MESH_FILE     "gravity.msh"                                                                  // GMSH mesh.
 #define MESH          GMSH_HOME MESH_FILE                                                            // GMSH mesh (full path).
 
 // INCLUDES:
 #include "nu.hpp"                                                                                    // Neutrino header file.
-
-int main ()
+#include "options.hpp"                                                                               // Command line options.
+#include "capture.hpp"                                                                               // Offscreen capture.
+#include "specialization.hpp"                                                                        // Kernel specialization.
+#include "precision.hpp"                                                                             // Compile-time precision.
+#include "materials.hpp"                                                                             // Per-group material table.
+#include "tiling.hpp"                                                                                // Work-group tiled force kernel.
+#include "gravity_cpu.hpp"                                                                           // CPU backend.
+#include "multirate.hpp"                                                                             // Multirate time stepping.
+#include "surface.hpp"                                                                               // Render topology extraction.
+#include "topology.hpp"                                                                              // Neighbour list encoding.
+#include "zerocopy.hpp"                                                                              // Zero-copy sharing without interop.
+#include "nodestate.hpp"                                                                             // Node state at the chosen precision.
+#include "snapshot.hpp"                                                                              // Shared-memory snapshot ring.
+#include "startup.hpp"                                                                               // Concurrent startup pipeline.
+#include "dispatch.hpp"                                                                              // Tuned NDRange dispatch.
+
+int main (int argc, char** argv)
 {
   // INDEXES:
   size_t                           i;                                                                // Index [#].
-  size_t                           j;                                                                // Index [#].
-  size_t                           j_min;                                                            // Index [#].
-  size_t                           j_max;                                                            // Index [#].
 
   // MOUSE PARAMETERS:
   float                            ms_orbit_rate  = 1.0f;                                            // Orbit rotation rate [rev/s].
@@ -56,16 +79,63 @@ int main ()
   float                            gmp_decaytime  = 1.25f;                                           // Low pass filter decay time [s].
   float                            gmp_deadzone   = 0.3f;                                            // Gamepad joystick deadzone [0...1].
 
+  // OPTIONS:
+  ex::options*                     opt            = new ex::options (argc, argv);                    // Command line options.
+  size_t                           steps          = opt->get ("steps", size_t (0));                  // Number of steps (0 = unlimited) [#].
+  size_t                           step           = 0;                                               // Step index [#].
+  std::string                      capture        = opt->get ("capture", std::string (""));          // Capture directory ("" = no capture).
+  size_t                           every          = opt->get ("every", size_t (1));                  // Capture period [steps].
+  bool                             headless       = opt->flag ("headless");                          // Headless flag (hidden window).
+  std::string                      backend        = opt->get ("backend", std::string ("opencl"));    // Backend ("opencl" or "cpu").
+  std::string                      coding         = opt->get ("topology", std::string ("auto"));     // Neighbour encoding ("auto", "wide" or "delta").
+  size_t                           threads        = opt->get ("threads", size_t (0));                // CPU backend threads (0 = all cores) [#].
+  size_t                           validate       = opt->get ("validate", size_t (0));               // Cross-backend validation steps (0 = off) [#].
+  float                            tolerance      = opt->get ("tolerance", 1e-4f);                   // Cross-backend relative tolerance [].
+  size_t                           scaling        = opt->get ("scaling", size_t (0));                // CPU scaling benchmark steps (0 = off) [#].
+  bool                             on_cpu         = (backend == "cpu");                              // CPU backend flag.
+  int                              status         = 0;                                               // Exit status.
+  bool                             specialize     = opt->flag ("specialize");                        // Kernel specialization flag.
+  size_t                           levels         = opt->get ("multirate", size_t (0));              // Multirate levels (0 = global time step) [#].
+  float                            eta            = opt->get ("eta", 0.05f);                         // Multirate motion accuracy [].
+  bool                             zero_copy      = opt->flag ("zero-copy");                         // Forced zero-copy sharing flag.
+  bool                             tune           = !opt->flag ("no-tune");                          // Work-group size tuning flag.
+  std::string                      serve          = opt->get ("serve", std::string (""));            // Snapshot ring to serve ("" = none).
+  std::string                      view           = opt->get ("view", std::string (""));             // Snapshot ring to view ("" = none).
+  size_t                           publish        = opt->get ("publish", size_t (1));                // Snapshot period [steps].
+  std::string                      drawing        = opt->get ("render", std::string ("surface"));    // Rendered links ("surface", "all" or slab "axis:min:max").
+  ex::precision*                   fp             = new ex::precision (opt->get ("precision",
+                                                                         std::string ("single")), true); // Precision (node state, see nodestate.hpp).
+  std::string                      library        = opt->get ("materials", std::string (""));        // Material file ("" = per-link stiffness, per-node mass).
+  std::string                      tiles          = opt->get ("tiling", std::string ("auto"));       // Tiled force kernel ("auto" = on regular grids, "off").
+
+  // STARTUP (mesh loaded while the contexts are created, see startup.hpp):
+  ex::startup*                     boot           = new ex::startup (opt->get ("startup",
+                                                                           std::string ("parallel"))); // Startup pipeline.
+  nu::mesh*                        gravity        = nullptr;                                         // Mesh body.
+  int                              VOLUME         = 1;                                               // Entire volume.
+  size_t                           loading        = boot->run ("mesh", [&] ()
+  {
+    gravity = new nu::mesh (MESH);                                                                   // Loading mesh...
+    gravity->process (VOLUME, 3, nu::MSH_HEX_8);                                                     // Processing mesh...
+  });                                                                                                // Mesh loading phase.
+
   // OPENGL:
   nu::opengl*                      gl             = new nu::opengl (NM, SX, SY, OX, OY, PX, PY, PZ); // OpenGL context.
+  ex::capture*                     rec            = new ex::capture (capture, every,
+                                                                     headless || (serve != ""));     // Offscreen capture (hidden when serving).
   nu::shader*                      S              = new nu::shader ();                               // OpenGL shader program.
   nu::projection_mode              pmode          = nu::MONOCULAR;                                   // OpenGL projection mode.
   nu::view_mode                    vmode          = nu::DIRECT;                                      // OpenGL view mode.
 
   // OPENCL::
+  bool                             interop        = !zero_copy && ex::zerocopy::probe (CL_DEVICE_TYPE_GPU); // CL/GL interop flag (probed before the context).
   nu::opencl*                      cl             = new nu::opencl (nu::GPU);                        // OpenCL context.
+  nu::kernel*                      K_state        = new nu::kernel ();                               // OpenCL kernel array (initial state).
+  nu::kernel*                      K_material     = new nu::kernel ();                               // OpenCL kernel array (material).
   nu::kernel*                      K1             = new nu::kernel ();                               // OpenCL kernel array.
   nu::kernel*                      K2             = new nu::kernel ();                               // OpenCL kernel array.
+  nu::kernel*                      K_level        = new nu::kernel ();                               // OpenCL kernel array (multirate levels).
+  nu::kernel*                      K_tick         = new nu::kernel ();                               // OpenCL kernel array (multirate substep).
   nu::float4*                      color          = new nu::float4 (0);                              // Color [].
   nu::float4*                      position       = new nu::float4 (1);                              // Position [m].
   nu::float4*                      velocity       = new nu::float4 (2);                              // Velocity [m/s].
@@ -77,21 +147,60 @@ int main ()
   nu::float1*                      resting        = new nu::float1 (8);                              // Resting.
   nu::float1*                      friction       = new nu::float1 (9);                              // Friction.
   nu::float1*                      mass           = new nu::float1 (10);                             // Mass.
-  nu::int1*                        central        = new nu::int1 (11);                               // Central nodes.
+  nu::int1*                        encoding       = new nu::int1 (11);                               // Neighbour index encoding (implicit central nodes).
   nu::int1*                        neighbour      = new nu::int1 (12);                               // Neighbour.
   nu::int1*                        offset         = new nu::int1 (13);                               // Offset.
   nu::int1*                        freedom        = new nu::int1 (14);                               // Freedom.
   nu::float1*                      dt             = new nu::float1 (15);                             // Time step [s].
+  nu::float1*                      parameter      = new nu::float1 (16);                             // Initialization parameters.
+  nu::int1*                        level          = new nu::int1 (17);                               // Multirate time step level.
+  nu::int1*                        order          = new nu::int1 (18);                               // Nodes sorted by level.
+  nu::int1*                        schedule       = new nu::int1 (19);                               // Multirate schedule (substep, level counts).
+  nu::int1*                        render         = new nu::int1 (20);                               // Render list (links to draw).
+  nu::float4*                      material       = new nu::float4 (21);                             // Material table (m, K, B).
+  nu::int1*                        link_material  = new nu::int1 (22);                               // Link material ids (4 per int).
+  nu::int1*                        node_material  = new nu::int1 (23);                               // Node material ids (4 per int).
+  nu::int1*                        tile_node      = new nu::int1 (24);                               // Node of each grid cell (tiling).
+  nu::int1*                        tile_link      = new nu::int1 (25);                               // Link stencil codes (tiling, 4 per int).
+  nu::float4*                      position_node  = new nu::float4 (26);                             // Position (node state) [m].
+  ex::zerocopy*                    zc;                                                               // Zero-copy sharing (without interop).
+  ex::nodestate*                   ns;                                                               // Node state (at the chosen precision).
+  ex::dispatch*                    nd;                                                               // Step kernel dispatch (tuned local size).
+  ex::snapshot*                    ring           = nullptr;                                         // Snapshot ring (server or viewer).
+
+  // KERNEL SPECIALIZATION:
+  ex::specialization*              spec           = new ex::specialization (KERNEL_SPEC);            // Kernel specialization.
+  size_t                           stride         = 0;                                               // Maximum neighbour stride [#].
+
+  // MULTIRATE:
+  ex::specialization*              mr             = new ex::specialization (KERNEL_MR);              // Multirate definitions.
+  ex::specialization*              fpd            = new ex::specialization (KERNEL_FP);              // Precision definitions.
+  ex::specialization*              mtd            = new ex::specialization (KERNEL_MAT);             // Material definitions.
+  ex::specialization*              tld            = new ex::specialization (KERNEL_TILE);            // Tiling definitions.
+  ex::specialization*              pad            = new ex::specialization (KERNEL_PAD);             // Padding guard definitions.
+  ex::multirate*                   rate           = new ex::multirate (std::max (levels, size_t (1))); // Multirate schedule.
+
+  // CPU BACKEND:
+  ex::cpu_backend*                 cpu            = new ex::cpu_backend (threads);                   // CPU backend.
+  ex::gravity_cpu*                 model          = new ex::gravity_cpu (color, position, velocity,
+                                                                         acceleration, position_int,
+                                                                         velocity_int, radius, stiffness,
+                                                                         resting, friction, mass, encoding,
+                                                                         neighbour, offset, freedom, dt); // CPU model.
 
   // IMGUI:
   nu::imgui*                       hud            = new nu::imgui ();                                // ImGui context.
 
   // MESH:
-  nu::mesh*                        gravity        = new nu::mesh (MESH);                             // Mesh cloth.
   size_t                           nodes;                                                            // Number of nodes.
   size_t                           elements;                                                         // Number of elements.
   size_t                           groups;                                                           // Number of groups.
   size_t                           neighbours;                                                       // Number of neighbours.
+  ex::topology*                    topo;                                                             // Neighbour list encoding.
+  ex::surface*                     shell;                                                            // Render list builder.
+  ex::materials*                   mat            = nullptr;                                         // Material groups (nullptr = per-link arrays).
+  ex::tiling*                      grid           = nullptr;                                         // Regular grid (nullptr = untiled).
+  std::vector<GLint>               nearest;                                                          // Neighbour indices (not encoded).
   std::vector<GLint>               point;                                                            // Point on frame.
   size_t                           point_nodes;                                                      // Number of point nodes.
   float                            x_min          = -1.0f;                                           // "x_min" spatial boundary [m].
@@ -109,7 +218,6 @@ int main ()
   int                              DCGH           = 6;                                               // Loop "DCGH".
   int                              AB_SIDE        = 7;                                               // Side "AB".
   int                              DA_SIDE        = 8;                                               // Side "DA".
-  int                              VOLUME         = 1;                                               // Entire volume.
 
   // SIMULATION VARIABLES:
   float                            m              = 20.0f;                                           // Node mass [kg].
@@ -122,16 +230,13 @@ int main ()
 
   // BACKUP:
   std::vector<nu_float4_structure> initial_position;                                                 // Backing up initial data...
-  std::vector<nu_float4_structure> initial_position_int;                                             // Backing up initial data...
-  std::vector<nu_float4_structure> initial_velocity;                                                 // Backing up initial data...
-  std::vector<nu_float4_structure> initial_velocity_int;                                             // Backing up initial data...
-  std::vector<nu_float4_structure> initial_acceleration;                                             // Backing up initial data...
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   ///////////////////////////////////////// DATA INITIALIZATION ///////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   // MESH:
-  gravity->process (VOLUME, 3, nu::MSH_HEX_8);                                                       // Processing mesh...
+  boot->mark ("contexts");                                                                           // Marking contexts created...
+  boot->join (loading);                                                                              // Waiting for mesh...
 
   position->data  = gravity->node_coordinates;                                                       // Setting all node coordinates...
   neighbour->data = gravity->neighbour;                                                              // Setting neighbour indices...
@@ -158,42 +263,26 @@ int main ()
   friction->data.push_back (B);                                                                      // Setting friction...
   dt->data.push_back (dt_simulation);                                                                // Setting time step...
   radius->data.push_back (R0);                                                                       // Setting nucleus radius...
-
-  // SETTING NEUTRINO ARRAYS ("nodes" depending):
+  parameter->data = {m, K, 0.11f};                                                                   // Setting initialization parameters...
+
+  // SIZING NEUTRINO ARRAYS (set on device by the initialization kernels):
+  position_int->data.resize (nodes);                                                                 // Sizing intermediate position...
+  velocity->data.resize (nodes);                                                                     // Sizing velocity...
+  velocity_int->data.resize (nodes);                                                                 // Sizing intermediate velocity...
+  acceleration->data.resize (nodes);                                                                 // Sizing acceleration...
+  mass->data.resize (nodes);                                                                         // Sizing mass...
+  stiffness->data.resize (neighbours);                                                               // Sizing stiffness...
+  color->data.resize (neighbours);                                                                   // Sizing color...
+  freedom->data.assign (nodes, 1);                                                                   // Setting freedom flags...
+  shell = new ex::surface (nodes, drawing);                                                          // Choosing rendered links...
+
+  // CHECKING NODE NUMBERING (central nodes are implicit, see topology.hpp):
   for(i = 0; i < nodes; i++)
   {
-    position_int->data.push_back (position->data[i]);                                                // Setting intermediate position...
-    velocity->data.push_back ({0.0f, 0.0f, 0.0f, 1.0f});                                             // Setting velocity...
-    velocity_int->data.push_back ({0.0f, 0.0f, 0.0f, 1.0f});                                         // Setting intermediate velocity...
-    acceleration->data.push_back ({0.0f, 0.0f, 0.0f, 1.0f});                                         // Setting acceleration...
-    mass->data.push_back (m);                                                                        // Setting mass...
-    freedom->data.push_back (1);                                                                     // Setting freedom flag...
-
-    // Computing minimum element offset index:
-    if(i == 0)
+    if(gravity->node[i] != GLint (i))
     {
-      j_min = 0;                                                                                     // Setting minimum element offset index...
-    }
-    else
-    {
-      j_min = offset->data[i - 1];                                                                   // Setting minimum element offset index...
-    }
-
-    j_max = offset->data[i];                                                                         // Setting maximum element offset index...
-
-    for(j = j_min; j < j_max; j++)
-    {
-      central->data.push_back (gravity->node[i]);                                                    // Building central node vector...
-      stiffness->data.push_back (K);                                                                 // Setting link stiffness...
-
-      if(resting->data[j] > 0.11)
-      {
-        color->data.push_back ({0.0f, 0.0f, 0.0f, 0.0f});                                            // Setting color...
-      }
-      else
-      {
-        color->data.push_back ({0.0f, 1.0f, 0.0f, 1.0f});                                            // Setting color...
-      }
+      std::cout << "Error: mesh nodes must be numbered 0...N-1 (implicit central nodes)." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                      // Exiting...
     }
   }
 
@@ -207,6 +296,8 @@ int main ()
     freedom->data[point[i]] = 0;                                                                     // Resetting freedom flag...
   }
 
+  shell->mark (point, ABCD);                                                                         // Marking boundary face...
+
   gravity->process (EFGH, 2, nu::MSH_PNT);                                                           // Processing mesh...
   point                = gravity->node;                                                              // Getting nodes on border...
   point_nodes          = point.size ();                                                              // Getting the number of nodes on border...
@@ -216,6 +307,8 @@ int main ()
     freedom->data[point[i]] = 0;                                                                     // Resetting freedom flag...
   }
 
+  shell->mark (point, EFGH);                                                                         // Marking boundary face...
+
   gravity->process (ADHE, 2, nu::MSH_PNT);                                                           // Processing mesh...
   point                = gravity->node;                                                              // Getting nodes on border...
   point_nodes          = point.size ();                                                              // Getting the number of nodes on border...
@@ -225,6 +318,8 @@ int main ()
     freedom->data[point[i]] = 0;                                                                     // Resetting freedom flag...
   }
 
+  shell->mark (point, ADHE);                                                                         // Marking boundary face...
+
   gravity->process (BCGF, 2, nu::MSH_PNT);                                                           // Processing mesh...
   point                = gravity->node;                                                              // Getting nodes on border...
   point_nodes          = point.size ();                                                              // Getting the number of nodes on border...
@@ -234,6 +329,8 @@ int main ()
     freedom->data[point[i]] = 0;                                                                     // Resetting freedom flag...
   }
 
+  shell->mark (point, BCGF);                                                                         // Marking boundary face...
+
   gravity->process (ABFE, 2, nu::MSH_PNT);                                                           // Processing mesh...
   point                = gravity->node;                                                              // Getting nodes on border...
   point_nodes          = point.size ();                                                              // Getting the number of nodes on border...
@@ -243,6 +340,8 @@ int main ()
     freedom->data[point[i]] = 0;                                                                     // Resetting freedom flag...
   }
 
+  shell->mark (point, ABFE);                                                                         // Marking boundary face...
+
   gravity->process (DCGH, 2, nu::MSH_PNT);                                                           // Processing mesh...
   point                = gravity->node;                                                              // Getting nodes on border...
   point_nodes          = point.size ();                                                              // Getting the number of nodes on border...
@@ -252,36 +351,389 @@ int main ()
     freedom->data[point[i]] = 0;                                                                     // Resetting freedom flag...
   }
 
+  shell->mark (point, DCGH);                                                                         // Marking boundary face...
+
   // SETTING INITIAL DATA BACKUP:
   initial_position     = position->data;                                                             // Setting backup data...
-  initial_position_int = position_int->data;                                                         // Setting backup data...
-  initial_velocity     = velocity->data;                                                             // Setting backup data...
-  initial_velocity_int = velocity_int->data;                                                         // Setting backup data...
-  initial_acceleration = acceleration->data;                                                         // Setting backup data...
+
+  // ENCODING NEIGHBOUR LISTS (see topology.hpp):
+  nearest = neighbour->data;                                                                         // Backing up neighbour indices...
+  if(on_cpu || (validate > 0) || (scaling > 0))
+  {
+    coding = "wide";                                                                                 // Forcing 32-bit indices (read by the CPU backend)...
+  }
+
+  topo = new ex::topology (neighbour->data, offset->data, coding);                                   // Choosing encoding...
+  topo->encode (neighbour->data, offset->data);                                                      // Encoding neighbour indices...
+  encoding->data = {int (topo->mode)};                                                               // Setting encoding...
+  topo->report (neighbours);                                                                         // Printing encoding...
+
+  // SETTING RENDER LIST (see surface.hpp):
+  shell->build (render->data, nearest, offset->data, resting->data, parameter->data[2],
+                initial_position);                                                                   // Listing links to draw...
+  shell->report ();                                                                                  // Printing render list...
+
+  // SETTING MATERIALS (per-group table and 8-bit material ids, see materials.hpp):
+  if(library != "")
+  {
+    if(on_cpu || (validate > 0) || (scaling > 0))
+    {
+      std::cout << "Error: material tables run on the OpenCL backend only." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                      // Exiting...
+    }
+
+    mat = new ex::materials (library, 3, nodes);                                                     // Reading materials (m, K, B)...
+
+    for(i = 0; i < mat->value.size (); i++)
+    {
+      gravity->process (mat->tag[i], mat->dim[i], nu::MSH_PNT);                                      // Processing material group...
+      mat->mark (gravity->node, i + 1);                                                              // Setting node materials...
+    }
+
+    mat->connect (nearest, offset->data);                                                            // Setting link materials...
+    material->data = {{m, K, B, 0.0f}};                                                              // Setting material 0...
+
+    for(i = 0; i < mat->value.size (); i++)
+    {
+      material->data.push_back ({mat->value[i][0], mat->value[i][1], mat->value[i][2], 0.0f});       // Setting material...
+      dt_critical = std::min (dt_critical, float (sqrt (mat->value[i][0]/mat->value[i][1])));        // Getting stiffest material...
+    }
+
+    dt_simulation       = safety_CFL*dt_critical;                                                    // Simulation time step [s].
+    dt->data[0]         = dt_simulation;                                                             // Setting time step...
+    link_material->data = ex::materials::pack (mat->link);                                           // Setting link material ids...
+    node_material->data = ex::materials::pack (mat->node);                                           // Setting node material ids...
+    stiffness->data     = {0.0f};                                                                    // Dropping per-link stiffness...
+    mass->data          = {0.0f};                                                                    // Dropping per-node mass...
+    mtd->define ("MATERIALS", mat->size ());                                                         // Enabling material table...
+    mat->report ();                                                                                  // Printing materials...
+  }
+  else
+  {
+    material->data      = {{0.0f, 0.0f, 0.0f, 0.0f}};                                                // Setting placeholder...
+    link_material->data = {0};                                                                       // Setting placeholder...
+    node_material->data = {0};                                                                       // Setting placeholder...
+  }
+
+  // SETTING TILING (work-group tiles on regular grids, see tiling.hpp):
+  if((tiles != "auto") && (tiles != "off"))
+  {
+    std::cout << "Error: unknown tiling \"" << tiles << "\" (auto or off)." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                        // Exiting...
+  }
+
+  if((tiles == "auto") && (levels == 0))
+  {
+    grid = new ex::tiling (initial_position, nearest, offset->data);                                 // Detecting regular grid...
+  }
+
+  if((grid != nullptr) && grid->fits (TILE_LOCAL, sizeof (nu_float4_structure)))
+  {
+    tile_node->data = grid->node;                                                                    // Setting node of each grid cell...
+    tile_link->data = grid->pack ();                                                                 // Setting link stencil codes...
+    tld->define ("TILE", size_t (1));                                                                // Enabling tiled force kernel...
+    tld->define ("TILE_X", grid->nx);                                                                // Setting grid cells along "x"...
+    tld->define ("TILE_Y", grid->ny);                                                                // Setting grid cells along "y"...
+    tld->define ("TILE_HALO", grid->halo);                                                           // Setting tile halo...
+    tld->define ("TILE_LOCAL", size_t (TILE_LOCAL));                                                 // Setting largest tiled work-group...
+    tld->define ("TILE_SPAN", grid->span (TILE_LOCAL));                                              // Setting tile size...
+    tld->define ("TILE_CELLS", nodes);                                                               // Setting number of grid cells...
+  }
+  else
+  {
+    tile_node->data = {0};                                                                           // Setting placeholder...
+    tile_link->data = {0};                                                                           // Setting placeholder...
+  }
+
+  if(grid != nullptr)
+  {
+    grid->report (TILE_LOCAL);                                                                       // Printing tiling...
+  }
+  else if(tiles == "auto")
+  {
+    std::cout << "tiling = off (multirate time stepping)" << std::endl;
+  }
+
+  // SETTING MULTIRATE ARRAYS (all nodes on the finest level until the end of the first macro step):
+  if(levels > 0)
+  {
+    if(on_cpu || (validate > 0) || (scaling > 0))
+    {
+      std::cout << "Error: multirate time stepping runs on the OpenCL backend only." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                      // Exiting...
+    }
+
+    if(levels > 16)
+    {
+      std::cout << "Error: multirate time stepping supports 1 to 16 levels." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                      // Exiting...
+    }
+
+    level->data.assign (nodes, 0);                                                                   // Setting node levels...
+    order->data.resize (nodes);                                                                      // Sizing sorted nodes...
+    rate->schedule (level->data, order->data, schedule->data, nearest, offset->data);                // Setting schedule...
+    mr->define ("MULTIRATE", size_t (1));                                                            // Enabling multirate time stepping...
+    mr->define ("LEVELS", levels);                                                                   // Setting number of levels...
+    mr->define ("MULTIRATE_ETA", eta);                                                               // Setting motion accuracy...
+    mr->define ("MULTIRATE_STABILITY", 0.9f);                                                        // Setting stability safety coefficient...
+  }
+  else
+  {
+    level->data    = {0};                                                                            // Setting placeholder...
+    order->data    = {0};                                                                            // Setting placeholder...
+    schedule->data = {0};                                                                            // Setting placeholder...
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////////// KERNEL SPECIALIZATION ///////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  for(i = 0; i < nodes; i++)
+  {
+    stride = std::max (stride, size_t (offset->data[i] - ((i == 0) ? 0 : offset->data[i - 1])));     // Getting maximum neighbour stride...
+  }
+
+  spec->define ("NEIGHBOURS", stride);                                                               // Specializing neighbour stride...
+  spec->define ("DT_SIMULATION", dt_simulation);                                                     // Specializing time step...
+  spec->define ("FRICTION", B);                                                                      // Specializing friction...
+  spec->define ("RADIUS", R0);                                                                       // Specializing nucleus radius...
+  fpd->define ("PRECISION", size_t (fp->mode));                                                      // Setting kernel arithmetic precision...
+  pad->define ("NODES", nodes);                                                                      // Setting padding guard...
+
+  if(fp->position)
+  {
+    fpd->define ("POSITION_DOUBLE", size_t (1));                                                     // Storing positions in double...
+  }
+
+  if(fp->state)
+  {
+    fpd->define ("STATE_DOUBLE", size_t (1));                                                        // Storing kinematics in double...
+  }
+
+  if(on_cpu && (fp->mode != ex::SINGLE_PRECISION))
+  {
+    std::cout << "Note: the CPU backend steps in FP32, --precision " << fp->name ()
+              << " applies to the device kernels." << std::endl;
+  }
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENCL KERNELS INITIALIZATION /////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // WRITING DEFINITION FILES (final before the first build, as the builds run concurrently):
+  if(levels > 0)
+  {
+    mr->write ();                                                                                    // Writing multirate definitions...
+  }
+
+  if(specialize)
+  {
+    spec->write ();                                                                                  // Writing kernel specialization...
+  }
+
+  fpd->write ();                                                                                     // Writing precision definitions...
+  mtd->write ();                                                                                     // Writing material definitions...
+  tld->write ();                                                                                     // Writing tiling definitions...
+  pad->write ();                                                                                     // Writing padding guard definitions...
+
+  K_state->addsource (fpd->write ());                                                                // Setting kernel precision source...
+  K_state->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                           // Setting kernel source file...
+  K_state->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                          // Setting kernel source file...
+  K_state->addsource (std::string (KERNEL_HOME) + std::string (INIT_STATE));                         // Setting kernel source file...
+  boot->run ("state", [&] ()
+  {
+    K_state->build (nodes, 0, 0);                                                                    // Building kernel program...
+  });
+
+  K_material->addsource (mtd->write ());                                                             // Setting kernel material source...
+  K_material->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                       // Setting kernel source file...
+  K_material->addsource (std::string (KERNEL_HOME) + std::string (INIT_MATERIAL));                   // Setting kernel source file...
+  boot->run ("material", [&] ()
+  {
+    K_material->build (nodes, 0, 0);                                                                 // Building kernel program...
+  });
+
+  if(levels > 0)
+  {
+    K_level->addsource (mr->write ());                                                               // Setting kernel multirate source...
+    K_level->addsource (fpd->write ());                                                              // Setting kernel precision source...
+    K_level->addsource (mtd->write ());                                                              // Setting kernel material source...
+    K_level->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                         // Setting kernel source file...
+    K_level->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                        // Setting kernel source file...
+    K_level->addsource (std::string (KERNEL_HOME) + std::string (MR_LEVEL));                         // Setting kernel source file...
+    boot->run ("level", [&] ()
+    {
+      K_level->build (nodes, 0, 0);                                                                  // Building kernel program...
+    });
+
+    K_tick->addsource (mr->write ());                                                                // Setting kernel multirate source...
+    K_tick->addsource (fpd->write ());                                                               // Setting kernel precision source...
+    K_tick->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                          // Setting kernel source file...
+    K_tick->addsource (std::string (KERNEL_HOME) + std::string (MR_TICK));                           // Setting kernel source file...
+    boot->run ("tick", [&] ()
+    {
+      K_tick->build (1, 0, 0);                                                                       // Building kernel program...
+    });
+
+    K1->addsource (mr->write ());                                                                    // Setting kernel multirate source...
+    K2->addsource (mr->write ());                                                                    // Setting kernel multirate source...
+  }
+
+  if(specialize)
+  {
+    K1->addsource (spec->write ());                                                                  // Setting kernel specialization source...
+    K2->addsource (spec->write ());                                                                  // Setting kernel specialization source...
+  }
+
+  K1->addsource (pad->write ());                                                                     // Setting kernel padding source...
+  K1->addsource (fpd->write ());                                                                     // Setting kernel precision source...
+  K1->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                                // Setting kernel source file...
   K1->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                               // Setting kernel source file...
   K1->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_1));                                // Setting kernel source file...
-  K1->build (nodes, 0, 0);                                                                           // Building kernel program...
-
+  boot->run ("K1", [&] ()
+  {
+    K1->build (nodes, 0, 0);                                                                         // Building kernel program...
+  });
+
+  K2->addsource (pad->write ());                                                                     // Setting kernel padding source...
+  K2->addsource (fpd->write ());                                                                     // Setting kernel precision source...
+  K2->addsource (mtd->write ());                                                                     // Setting kernel material source...
+  K2->addsource (tld->write ());                                                                     // Setting kernel tiling source...
+  K2->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                                // Setting kernel source file...
   K2->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                               // Setting kernel source file...
   K2->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_2));                                // Setting kernel source file...
-  K2->build (nodes, 0, 0);                                                                           // Building kernel program...
+  boot->run ("K2", [&] ()
+  {
+    K2->build (nodes, 0, 0);                                                                         // Building kernel program...
+  });
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENGL SHADERS INITIALIZATION /////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), nu::VERTEX);                  // Setting shader source file...
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), nu::GEOMETRY);                // Setting shader source file...
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), nu::FRAGMENT);                // Setting shader source file...
-  S->build (neighbours);                                                                             // Building shader program...
+  boot->now ("shader", [&] ()
+  {
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), nu::VERTEX);                // Setting shader source file...
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), nu::GEOMETRY);              // Setting shader source file...
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), nu::FRAGMENT);              // Setting shader source file...
+    S->build (render->data.size ());                                                                 // Building shader program (render list)...
+  });
+
+  boot->join ();                                                                                     // Waiting for kernel builds...
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////// SETTING OPENCL KERNEL ARGUMENTS /////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
-  cl->write ();
+  position_node->data = position->data;                                                              // Setting node state position...
+  cl->write ();                                                                                      // Writing OpenCL data...
+  ns = new ex::nodestate (K1);                                                                       // Storing node state...
+  ns->store (2, velocity->data, fp->state);                                                          // Storing velocity...
+  ns->store (3, acceleration->data, fp->state);                                                      // Storing acceleration...
+  ns->store (4, position_int->data, fp->position);                                                   // Storing intermediate position...
+  ns->store (5, velocity_int->data, fp->state);                                                      // Storing intermediate velocity...
+  ns->store (26, position_node->data, fp->position);                                                 // Storing position...
+  ns->attach ({K_state, K_material, K1, K2});                                                        // Setting node state kernel arguments...
+
+  if(levels > 0)
+  {
+    ns->attach ({K_level, K_tick});                                                                  // Setting node state kernel arguments...
+  }
+
+  ns->report ();                                                                                     // Printing node state storage...
+  nd = new ex::dispatch (K1, nodes, tune && !on_cpu);                                                // Setting step kernel dispatch...
+
+  if(tune && !on_cpu)
+  {
+    // TUNING STEP KERNELS (on the initial state, rewritten afterwards):
+    cl->acquire ();                                                                                  // Acquiring OpenCL kernel...
+    cl->execute (K_material, nu::WAIT);                                                              // Initializing material on device...
+    cl->execute (K_state, nu::WAIT);                                                                 // Initializing state on device...
+    nd->tune (K1, "K1");                                                                             // Tuning work-group size...
+    nd->tune (K2, "K2");                                                                             // Tuning work-group size...
+    cl->release ();                                                                                  // Releasing OpenCL kernel...
+    cl->write ();                                                                                    // Rewriting OpenCL data...
+    ns->attach ({K_state, K_material, K1, K2});                                                      // Setting node state kernel arguments...
+
+    if(levels > 0)
+    {
+      ns->attach ({K_level, K_tick});                                                                // Setting node state kernel arguments...
+    }
+
+    ns->write (cl, 2, velocity->data);                                                               // Rewriting node state...
+    ns->write (cl, 3, acceleration->data);                                                           // Rewriting node state...
+    ns->write (cl, 4, position_int->data);                                                           // Rewriting node state...
+    ns->write (cl, 5, velocity_int->data);                                                           // Rewriting node state...
+    ns->write (cl, 26, position_node->data);                                                         // Rewriting node state...
+  }
+
+  zc = new ex::zerocopy (K1, interop);                                                               // Choosing sharing path...
+  zc->share (0, color->data);                                                                        // Sharing color...
+  zc->share (1, position->data);                                                                     // Sharing position...
+  zc->attach ({K_state, K_material, K1, K2});                                                        // Setting shared kernel arguments...
+
+  if(levels > 0)
+  {
+    zc->attach ({K_level, K_tick});                                                                  // Setting shared kernel arguments...
+  }
+
+  zc->report ();                                                                                     // Printing sharing path...
+
+  if((serve != "") && (view != ""))
+  {
+    std::cout << "Error: --serve and --view are exclusive." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                        // Exiting...
+  }
+
+  if((serve != "") || (view != ""))
+  {
+    ring = new ex::snapshot ((serve != "") ? serve : view, serve != "", position->data.size (),
+                             color->data.size ());                                                   // Opening snapshot ring...
+  }
+
+  cl->acquire ();
+  cl->execute (K_material, nu::WAIT);                                                                // Initializing material on device...
+  cl->execute (K_state, nu::WAIT);                                                                   // Initializing state on device...
+  cl->release ();
+
+  if(on_cpu || (validate > 0) || (scaling > 0))
+  {
+    cl->acquire ();                                                                                  // Acquiring OpenCL kernel...
+    zc->read (cl, 0, color->data);                                                                   // Reading initial color...
+    ns->read (cl, 2, velocity->data);                                                                // Reading initial velocity...
+    ns->read (cl, 3, acceleration->data);                                                            // Reading initial acceleration...
+    ns->read (cl, 4, position_int->data);                                                            // Reading initial intermediate position...
+    ns->read (cl, 5, velocity_int->data);                                                            // Reading initial intermediate velocity...
+    cl->read (7);                                                                                    // Reading initial stiffness...
+    cl->read (10);                                                                                   // Reading initial mass...
+    cl->release ();                                                                                  // Releasing OpenCL kernel...
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  ///////////////////////////////////// CPU BACKEND TEST AND BENCHMARK ////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  if(validate > 0)
+  {
+    status = ex::validate (model, cpu, validate, tolerance, [&] ()
+    {
+      cl->acquire ();                                                                                // Acquiring OpenCL kernel...
+      nd->execute (K1, "K1");                                                                        // Executing OpenCL kernel...
+      nd->execute (K2, "K2");                                                                        // Executing OpenCL kernel...
+      cl->release ();                                                                                // Releasing OpenCL kernel...
+    }, [&] ()
+    {
+      cl->acquire ();                                                                                // Acquiring OpenCL kernel...
+      zc->read (cl, 1, position->data);                                                              // Reading position...
+      ns->read (cl, 2, velocity->data);                                                              // Reading velocity...
+      ns->read (cl, 3, acceleration->data);                                                          // Reading acceleration...
+      ns->read (cl, 4, position_int->data);                                                          // Reading intermediate position...
+      ns->read (cl, 5, velocity_int->data);                                                          // Reading intermediate velocity...
+      cl->release ();                                                                                // Releasing OpenCL kernel...
+    }) ? 0 : 1;
+    gl->close ();                                                                                    // Closing gl (test done)...
+  }
+
+  if(scaling > 0)
+  {
+    ex::scaling (model, scaling);                                                                    // Running CPU scaling benchmark...
+    gl->close ();                                                                                    // Closing gl (benchmark done)...
+  }
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////// APPLICATION LOOP ////////////////////////////////////////
@@ -289,16 +741,86 @@ int main ()
   while(!gl->closed ())                                                                              // Opening window...
   {
     cl->get_tic ();                                                                                  // Getting "tic" [us]...
-    cl->acquire ();
-    cl->execute (K1, nu::WAIT);                                                                      // Executing OpenCL kernel...
-    cl->execute (K2, nu::WAIT);                                                                      // Executing OpenCL kernel...
-    cl->release ();
+    zc->to_cl ();                                                                                    // Waiting for the last draw...
+
+    if(view != "")
+    {
+      if(ring->fetch (position->data, color->data))
+      {
+        zc->write (cl, 0, color->data);                                                              // Writing color for plot...
+        zc->write (cl, 1, position->data);                                                           // Writing position for plot...
+      }
+    }
+    else if(on_cpu)
+    {
+      model->step (cpu);                                                                             // Executing CPU kernels...
+      zc->write (cl, 0, color->data);                                                                // Writing color for plot...
+      zc->write (cl, 1, position->data);                                                             // Writing position for plot...
+    }
+    else
+    {
+      cl->acquire ();                                                                                // Acquiring OpenCL kernel...
+      nd->execute (K1, "K1");                                                                        // Executing OpenCL kernel...
+      nd->execute (K2, "K2");                                                                        // Executing OpenCL kernel...
+      cl->release ();                                                                                // Releasing OpenCL kernel...
+
+      // ADVANCING MULTIRATE SUBSTEP (levels reassigned at the end of each macro step):
+      if((levels > 0) && rate->tick ())
+      {
+        cl->acquire ();                                                                              // Acquiring OpenCL kernel...
+        cl->execute (K_level, nu::WAIT);                                                             // Computing node levels...
+        cl->read (17);                                                                               // Reading node levels...
+        cl->release ();                                                                              // Releasing OpenCL kernel...
+        rate->schedule (level->data, order->data, schedule->data, nearest, offset->data);            // Setting schedule...
+        cl->write (17);                                                                              // Writing node levels...
+        cl->write (18);                                                                              // Writing sorted nodes...
+        cl->write (19);                                                                              // Writing schedule...
+      }
+      else if(levels > 0)
+      {
+        cl->acquire ();                                                                              // Acquiring OpenCL kernel...
+        cl->execute (K_tick, nu::WAIT);                                                              // Advancing substep on device...
+        cl->release ();                                                                              // Releasing OpenCL kernel...
+      }
+    }
+
+    // PUBLISHING SNAPSHOT (server: no rendering in the step loop):
+    if(serve != "")
+    {
+      if((publish > 0) && (step%publish == 0))
+      {
+        if(!on_cpu)
+        {
+          cl->acquire ();                                                                            // Acquiring OpenCL kernel...
+          zc->read (cl, 0, color->data);                                                             // Reading color...
+          zc->read (cl, 1, position->data);                                                          // Reading position...
+          cl->release ();                                                                            // Releasing OpenCL kernel...
+        }
+
+        ring->publish (step, position->data, color->data);                                           // Publishing snapshot...
+      }
+
+      cl->get_toc ();                                                                                // Getting "toc" [us]...
+      boot->frame ();                                                                                // Reporting startup (first step)...
+
+      if(((++step >= steps) && (steps > 0)) || ring->interrupt ())
+      {
+        gl->close ();                                                                                // Closing gl (step limit reached or interrupted)...
+      }
+
+      continue;
+    }
+
+    zc->to_gl ();                                                                                    // Handing shared arrays to OpenGL...
 
     gl->begin ();                                                                                    // Beginning gl...
     gl->poll_events ();                                                                              // Polling gl events...
     gl->mouse_navigation (ms_orbit_rate, ms_pan_rate, ms_decaytime);
     gl->gamepad_navigation (gmp_orbit_rate, gmp_pan_rate, gmp_decaytime, gmp_deadzone);
+    rec->bind ();                                                                                    // Binding offscreen capture...
     gl->plot (S, pmode, vmode);                                                                      // Plotting shared arguments...
+    zc->drawn ();                                                                                    // Fencing draw...
+    rec->unbind ();                                                                                  // Reading back offscreen capture...
 
     hud->begin ();                                                                                   // Beginning HUD...
     hud->window ("FREE LATTICE PARAMETERS", 200);                                                    // Creating window...
@@ -311,41 +833,102 @@ int main ()
     if(hud->button ("(U)pdate", 100) || gl->key_U)
     {
       dt_critical       = sqrt (m/K);                                                                // Critical time step [s].
+
+      if(mat != nullptr)
+      {
+        material->data[0] = {m, K, B, 0.0f};                                                         // Setting material 0...
+
+        for(i = 1; i < material->data.size (); i++)
+        {
+          dt_critical = std::min (dt_critical, float (sqrt (material->data[i].x/material->data[i].y))); // Getting stiffest material...
+        }
+
+        cl->write (21);                                                                              // Writing OpenCL data...
+      }
+
       dt_simulation     = safety_CFL*dt_critical;                                                    // Simulation time step [s].
 
       // RECOMPUTING NEUTRINO ARRAYS (parameters):
       friction->data[0] = B;                                                                         // Setting friction...
       dt->data[0]       = dt_simulation;                                                             // Setting time step...
       radius->data[0]   = R0;                                                                        // Setting nucleus radius...
+      parameter->data   = {m, K, 0.11f};                                                             // Setting initialization parameters...
 
-      // RESETTING NEUTRINO ARRAYS ("nodes" depending):
-      for(i = 0; i < nodes; i++)
-      {
-        mass->data[i] = m;                                                                           // Setting mass...
+      cl->write (6);                                                                                 // Writing OpenCL data...
+      cl->write (9);                                                                                 // Writing OpenCL data...
+      cl->write (15);                                                                                // Writing OpenCL data...
+      cl->write (16);                                                                                // Writing OpenCL data...
+      cl->acquire ();
+      cl->execute (K_material, nu::WAIT);                                                            // Resetting mass and stiffness on device...
+      cl->release ();
+
+      spec->define ("DT_SIMULATION", dt_simulation);                                                 // Specializing time step...
+      spec->define ("FRICTION", B);                                                                  // Specializing friction...
+      spec->define ("RADIUS", R0);                                                                   // Specializing nucleus radius...
 
-        // Computing minimum element offset index:
-        if(i == 0)
+      // REBUILDING SPECIALIZED KERNELS:
+      if(specialize && !on_cpu && spec->changed ())
+      {
+        cl->acquire ();                                                                              // Acquiring OpenCL kernel...
+        zc->read (cl, 0, color->data);                                                               // Reading color...
+        zc->read (cl, 1, position->data);                                                            // Reading position...
+        ns->read (cl, 26, position_node->data);                                                      // Reading node state position...
+        ns->read (cl, 2, velocity->data);                                                            // Reading velocity...
+        ns->read (cl, 3, acceleration->data);                                                        // Reading acceleration...
+        ns->read (cl, 4, position_int->data);                                                        // Reading intermediate position...
+        ns->read (cl, 5, velocity_int->data);                                                        // Reading intermediate velocity...
+        cl->read (7);                                                                                // Reading stiffness...
+        cl->read (10);                                                                               // Reading mass...
+        cl->release ();                                                                              // Releasing OpenCL kernel...
+        delete K1;                                                                                   // Deleting OpenCL kernel...
+        delete K2;                                                                                   // Deleting OpenCL kernel...
+        K1 = new nu::kernel ();                                                                      // Creating OpenCL kernel...
+        K2 = new nu::kernel ();                                                                      // Creating OpenCL kernel...
+        K1->addsource (spec->write ());                                                              // Setting kernel specialization source...
+        K2->addsource (spec->write ());                                                              // Setting kernel specialization source...
+
+        if(levels > 0)
         {
-          j_min = 0;                                                                                 // Setting minimum element offset index...
+          K1->addsource (mr->write ());                                                              // Setting kernel multirate source...
+          K2->addsource (mr->write ());                                                              // Setting kernel multirate source...
         }
-        else
+
+        K1->addsource (pad->write ());                                                               // Setting kernel padding source...
+        K1->addsource (fpd->write ());                                                               // Setting kernel precision source...
+        K1->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                          // Setting kernel source file...
+        K1->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                         // Setting kernel source file...
+        K1->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_1));                          // Setting kernel source file...
+        K1->build (nodes, 0, 0);                                                                     // Building kernel program...
+
+        K2->addsource (pad->write ());                                                               // Setting kernel padding source...
+        K2->addsource (fpd->write ());                                                               // Setting kernel precision source...
+        K2->addsource (mtd->write ());                                                               // Setting kernel material source...
+        K2->addsource (tld->write ());                                                               // Setting kernel tiling source...
+        K2->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                          // Setting kernel source file...
+        K2->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                         // Setting kernel source file...
+        K2->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_2));                          // Setting kernel source file...
+        K2->build (nodes, 0, 0);                                                                     // Building kernel program...
+        cl->write ();                                                                                // Writing OpenCL data...
+        zc->attach ({K_state, K_material, K1, K2});                                                  // Setting shared kernel arguments...
+
+        if(levels > 0)
         {
-          j_min = offset->data[i - 1];                                                               // Setting minimum element offset index...
+          zc->attach ({K_level, K_tick});                                                            // Setting shared kernel arguments...
         }
 
-        j_max         = offset->data[i];                                                             // Setting maximum element offset index...
+        ns->attach ({K_state, K_material, K1, K2});                                                  // Setting node state kernel arguments...
 
-        for(j = j_min; j < j_max; j++)
+        if(levels > 0)
         {
-          stiffness->data[j] = K;                                                                    // Setting link stiffness...
+          ns->attach ({K_level, K_tick});                                                            // Setting node state kernel arguments...
         }
       }
 
-      cl->write (6);                                                                                 // Writing OpenCL data...
-      cl->write (7);                                                                                 // Writing OpenCL data...
-      cl->write (9);                                                                                 // Writing OpenCL data...
-      cl->write (10);                                                                                // Writing OpenCL data...
-      cl->write (15);                                                                                // Writing OpenCL data...
+      if(on_cpu)
+      {
+        cl->read (7);                                                                                // Reading stiffness...
+        cl->read (10);                                                                               // Reading mass...
+      }
     }
 
     hud->space (50);                                                                                 // Setting spacing...
@@ -353,15 +936,32 @@ int main ()
     if(hud->button ("(R)estart", 100) || gl->button_TRIANGLE || gl->key_R)
     {
       position->data     = initial_position;                                                         // Restoring backup...
-      position_int->data = initial_position_int;                                                     // Restoring backup...
-      velocity->data     = initial_velocity;                                                         // Restoring backup...
-      velocity_int->data = initial_velocity_int;                                                     // Restoring backup...
-      acceleration->data = initial_acceleration;                                                     // Restoring backup...
-      cl->write (1);                                                                                 // Writing data...
-      cl->write (2);                                                                                 // Writing data...
-      cl->write (3);                                                                                 // Writing data...
-      cl->write (4);                                                                                 // Writing data...
-      cl->write (5);                                                                                 // Writing data...
+      zc->write (cl, 1, position->data);                                                             // Writing data...
+      position_node->data = initial_position;                                                        // Restoring backup...
+      ns->write (cl, 26, position_node->data);                                                       // Writing data...
+      cl->acquire ();
+      cl->execute (K_state, nu::WAIT);                                                               // Resetting state on device...
+      cl->release ();
+
+      if(levels > 0)
+      {
+        level->data.assign (nodes, 0);                                                               // Resetting node levels...
+        rate->schedule (level->data, order->data, schedule->data, nearest, offset->data);            // Resetting schedule...
+        cl->write (17);                                                                              // Writing node levels...
+        cl->write (18);                                                                              // Writing sorted nodes...
+        cl->write (19);                                                                              // Writing schedule...
+      }
+
+      if(on_cpu)
+      {
+        cl->acquire ();                                                                              // Acquiring OpenCL kernel...
+        zc->read (cl, 0, color->data);                                                               // Reading color...
+        ns->read (cl, 2, velocity->data);                                                            // Reading velocity...
+        ns->read (cl, 3, acceleration->data);                                                        // Reading acceleration...
+        ns->read (cl, 4, position_int->data);                                                        // Reading intermediate position...
+        ns->read (cl, 5, velocity_int->data);                                                        // Reading intermediate velocity...
+        cl->release ();                                                                              // Releasing OpenCL kernel...
+      }
     }
 
     hud->space (50);                                                                                 // Setting spacing...
@@ -389,18 +989,52 @@ int main ()
     hud->end ();                                                                                     // Ending HUD...
 
     gl->end ();                                                                                      // Ending gl...
+    boot->frame ();                                                                                  // Reporting startup (first frame)...
 
     cl->get_toc ();                                                                                  // Getting "toc" [us]...
+
+    if((steps > 0) && (++step >= steps))
+    {
+      gl->close ();                                                                                  // Closing gl (step limit reached)...
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////////////// MULTIRATE REPORT ////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  if(levels > 0)
+  {
+    rate->report ();                                                                                 // Printing multirate work...
   }
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////// CLEANUP ////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
+  delete spec;                                                                                       // Deleting kernel specialization...
+  delete mr;                                                                                         // Deleting multirate definitions...
+  delete fpd;                                                                                        // Deleting precision definitions...
+  delete mtd;                                                                                        // Deleting material definitions...
+  delete mat;                                                                                        // Deleting material groups...
+  delete tld;                                                                                        // Deleting tiling definitions...
+  delete pad;                                                                                        // Deleting padding guard definitions...
+  delete grid;                                                                                       // Deleting regular grid...
+  delete fp;                                                                                         // Deleting precision...
+  delete rate;                                                                                       // Deleting multirate schedule...
+  delete model;                                                                                      // Deleting CPU model...
+  delete cpu;                                                                                        // Deleting CPU backend...
+  delete ring;                                                                                       // Deleting snapshot ring...
+  delete nd;                                                                                         // Deleting step kernel dispatch...
+  delete ns;                                                                                         // Deleting node state...
+  delete zc;                                                                                         // Deleting zero-copy sharing...
+  delete rec;                                                                                        // Deleting offscreen capture...
   delete cl;                                                                                         // Deleting OpenCL context...
   delete gl;                                                                                         // Deleting OpenGL context...
+  delete opt;                                                                                        // Deleting command line options...
+  delete boot;                                                                                       // Deleting startup pipeline...
   delete hud;                                                                                        // Deleting HUD context...
   delete color;                                                                                      // Deleting color data...
   delete position;                                                                                   // Deleting position data...
+  delete position_node;                                                                              // Deleting node state position data...
   delete position_int;                                                                               // Deleting intermediate position data...
   delete velocity;                                                                                   // Deleting velocity data...
   delete velocity_int;                                                                               // Deleting intermediate velocity data...
@@ -408,12 +1042,29 @@ int main ()
   delete stiffness;                                                                                  // Deleting stiffness data...
   delete resting;                                                                                    // Deleting resting data...
   delete friction;                                                                                   // Deleting friction data...
+  delete encoding;                                                                                   // Deleting neighbour index encoding...
+  delete topo;                                                                                       // Deleting neighbour list encoding...
+  delete shell;                                                                                      // Deleting render list builder...
   delete neighbour;                                                                                  // Deleting neighbours...
   delete offset;                                                                                     // Deleting offset...
   delete freedom;                                                                                    // Deleting freedom flag data...
   delete dt;                                                                                         // Deleting time step data...
+  delete parameter;                                                                                  // Deleting initialization parameters...
+  delete level;                                                                                      // Deleting multirate levels...
+  delete order;                                                                                      // Deleting sorted nodes...
+  delete schedule;                                                                                   // Deleting multirate schedule...
+  delete render;                                                                                     // Deleting render list...
+  delete material;                                                                                   // Deleting material table...
+  delete link_material;                                                                              // Deleting link material ids...
+  delete node_material;                                                                              // Deleting node material ids...
+  delete tile_node;                                                                                  // Deleting grid cell nodes...
+  delete tile_link;                                                                                  // Deleting link stencil codes...
+  delete K_state;                                                                                    // Deleting OpenCL kernel...
+  delete K_material;                                                                                 // Deleting OpenCL kernel...
   delete K1;                                                                                         // Deleting OpenCL kernel...
   delete K2;                                                                                         // Deleting OpenCL kernel...
+  delete K_level;                                                                                    // Deleting OpenCL kernel...
+  delete K_tick;                                                                                     // Deleting OpenCL kernel...
 
-  return 0;
+  return status;
 }
\ No newline at end of file
@@ -0,0 +1,182 @@
+/// @file     multirate.hpp
+/// @brief    Multirate local time stepping for the Gravity example.
+///
+/// @details  Each node is given a power-of-two time step level "l": it advances by 2^l*dt, dt
+/// being the global (finest) time step. A macro step lasts 2^(LEVELS - 1) substeps of dt; all nodes
+/// are synchronized at its end, when levels are reassigned. At each substep, the predictor kernel
+/// extrapolates every node to the end of the substep from the start of its own step, and the
+/// corrector kernel only runs on the nodes whose step ends there: their forces are computed from
+/// the (synchronized) positions of finer neighbours and the (predicted) positions of coarser ones.
+/// Levels of linked nodes differ by one at most, so that the predictions stay short at level
+/// boundaries. Nodes are sorted by level, the finest first: the nodes ending their step at a
+/// substep are then a prefix of the sorted list, and the corrector's other work-items exit at once.
+
+#ifndef multirate_hpp
+#define multirate_hpp
+
+// INCLUDES:
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace ex
+{
+/// @class multirate
+/// @brief Multirate schedule.
+class multirate
+{
+public:
+  size_t              levels;                                                                       ///< Number of levels.
+  size_t              substep;                                                                      ///< Substep in macro step [#].
+  std::vector<size_t> count;                                                                        ///< Nodes up to each level [#].
+  double              updates;                                                                      ///< Corrector node updates (multirate) [#].
+  double              global;                                                                       ///< Corrector node updates (global stepping) [#].
+
+  /// @brief **Class constructor.**
+  multirate (
+             size_t loc_levels                                                                      ///< Number of levels.
+            );
+
+  /// @brief **Number of substeps per macro step.**
+  size_t substeps ();
+
+  /// @brief **Schedule builder.**
+  /// @details Limits the level of each node to one more than the level of its neighbours, sorts
+  /// the nodes by level (the finest first) and sets the schedule: substep, then number of nodes up
+  /// to each level. It must be called at the end of a macro step.
+  void   schedule (
+                   std::vector<int>&       loc_level,                                               ///< Node levels (raw in, graded out).
+                   std::vector<int>&       loc_order,                                               ///< Nodes sorted by level.
+                   std::vector<int>&       loc_schedule,                                            ///< Schedule.
+                   const std::vector<int>& loc_neighbour,                                           ///< Neighbour indices.
+                   const std::vector<int>& loc_offset                                               ///< Neighbour offsets.
+                  );
+
+  /// @brief **Substep counter.**
+  /// @details Accounts for the corrector work of the current substep and advances it; returns
+  /// "true" at the end of a macro step.
+  bool   tick ();
+
+  /// @brief **Work report.**
+  /// @details Prints the nodes per level and the corrector work compared with global stepping.
+  void   report ();
+};
+
+inline multirate::multirate (
+                             size_t loc_levels
+                            )
+{
+  levels  = loc_levels;                                                                             // Setting number of levels...
+  substep = 0;                                                                                      // Resetting substep...
+  updates = 0.0;                                                                                    // Resetting multirate work...
+  global  = 0.0;                                                                                    // Resetting global stepping work...
+  count.assign (levels, 0);                                                                         // Resetting level counts...
+}
+
+inline size_t multirate::substeps ()
+{
+  return size_t (1) << (levels - 1);
+}
+
+inline void multirate::schedule (
+                                 std::vector<int>&       loc_level,
+                                 std::vector<int>&       loc_order,
+                                 std::vector<int>&       loc_schedule,
+                                 const std::vector<int>& loc_neighbour,
+                                 const std::vector<int>& loc_offset
+                                )
+{
+  size_t nodes   = loc_level.size ();                                                               // Number of nodes.
+  bool   changed = true;                                                                            // Level change flag.
+  size_t j_min;                                                                                     // Neighbour stride minimum index.
+  int    l;                                                                                         // Level.
+
+  while(changed)
+  {
+    changed = false;                                                                                // Resetting change flag...
+
+    for(size_t i = 0; i < nodes; i++)
+    {
+      j_min = (i == 0) ? 0 : size_t (loc_offset[i - 1]);                                            // Setting stride minimum...
+
+      for(size_t j = j_min; j < size_t (loc_offset[i]); j++)
+      {
+        l = loc_level[loc_neighbour[j]] + 1;                                                        // Getting neighbour level limit...
+
+        if(loc_level[i] > l)
+        {
+          loc_level[i] = l;                                                                         // Grading level...
+          changed      = true;                                                                      // Flagging change...
+        }
+      }
+    }
+  }
+
+  std::fill (count.begin (), count.end (), 0);                                                      // Resetting level counts...
+
+  for(size_t i = 0; i < nodes; i++)
+  {
+    count[loc_level[i]]++;                                                                          // Counting nodes per level...
+  }
+
+  for(size_t k = 1; k < levels; k++)
+  {
+    count[k] += count[k - 1];                                                                       // Accumulating level counts...
+  }
+
+  loc_schedule.assign (levels + 1, 0);                                                              // Resetting schedule (substep 0)...
+
+  for(size_t k = 0; k < levels; k++)
+  {
+    loc_schedule[k + 1] = int (count[k]);                                                           // Setting nodes up to level...
+  }
+
+  for(size_t i = nodes; i > 0; i--)
+  {
+    loc_order[--count[loc_level[i - 1]]] = int (i - 1);                                             // Sorting node by level (stable)...
+  }
+
+  for(size_t k = 0; k < levels; k++)
+  {
+    count[k] = size_t (loc_schedule[k + 1]);                                                        // Restoring level counts...
+  }
+
+  substep = 0;                                                                                      // Resetting substep...
+}
+
+inline bool multirate::tick ()
+{
+  size_t l = 0;                                                                                     // Coarsest level ending at this substep.
+
+  while((l < levels - 1) && ((((substep + 1) >> l) & 1) == 0))
+  {
+    l++;                                                                                            // Finding coarsest level ending at this substep...
+  }
+
+  updates += double (count[l]);                                                                     // Accounting for multirate work...
+  global  += double (count[levels - 1]);                                                            // Accounting for global stepping work...
+  substep  = (substep + 1)%substeps ();                                                             // Advancing substep...
+
+  return substep == 0;
+}
+
+inline void multirate::report ()
+{
+  std::cout << "multirate levels = " << levels << std::endl;
+
+  for(size_t k = 0; k < levels; k++)
+  {
+    std::cout << "  level " << k << " (dt x " << (size_t (1) << k) << ") = "
+              << (count[k] - ((k == 0) ? 0 : count[k - 1])) << " nodes" << std::endl;               // Printing nodes per level...
+  }
+
+  if(updates > 0.0)
+  {
+    std::cout << "multirate work = " << updates << " node updates (global stepping: " << global
+              << ", " << global/updates << "x less)" << std::endl;                                  // Printing work reduction...
+  }
+}
+}
+
+#endif
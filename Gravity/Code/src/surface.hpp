@@ -0,0 +1,201 @@
+/// @file     surface.hpp
+/// @brief    Render topology extraction for the Gravity example.
+///
+/// @details  The Gravity lattice is volumetric: drawing every link makes the geometry shader work
+/// scale with the volume of the body, while only its boundary surface is visible. The render list
+/// holds the neighbour list indices of the links to draw: the geometry shader runs once per entry
+/// and reads its link through it, so that vertex work scales with the surface area instead. A link
+/// is on the boundary surface when both its nodes lie on a common boundary face (links crossing
+/// the body between two faces are inside); a link is in a clipping slab when both its nodes
+/// initially lie between the slab planes. Links hidden by the initial state kernel (longer than
+/// the maximum visible length) are never listed.
+
+#ifndef surface_hpp
+#define surface_hpp
+
+// INCLUDES:
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ex
+{
+/// @brief **Rendered links.**
+enum surface_mode
+{
+  ALL_LINKS     = 0,                                                                                ///< All visible links.
+  SURFACE_LINKS = 1,                                                                                ///< Boundary surface links.
+  SLAB_LINKS    = 2                                                                                 ///< Clipping slab links.
+};
+
+/// @class surface
+/// @brief Render list builder.
+class surface
+{
+public:
+  surface_mode     mode;                                                                            ///< Rendered links.
+  int              axis;                                                                            ///< Slab axis (0 = x, 1 = y, 2 = z).
+  float            lo;                                                                              ///< Slab lower plane [m].
+  float            hi;                                                                              ///< Slab upper plane [m].
+  std::vector<int> face;                                                                            ///< Boundary faces of each node (bit mask).
+  size_t           links;                                                                           ///< Number of links [#].
+  size_t           drawn;                                                                           ///< Number of rendered links [#].
+
+  /// @brief **Class constructor.**
+  /// @details The mode is "surface", "all" or a slab "axis:min:max" (e.g. "z:-0.25:0.25").
+  surface (
+           size_t      loc_nodes,                                                                   ///< Number of nodes.
+           std::string loc_mode                                                                     ///< Rendered links.
+          );
+
+  /// @brief **Boundary face marker.**
+  /// @details Marks the nodes of a boundary face, given its physical group.
+  void mark (
+             const std::vector<int>& loc_point,                                                     ///< Nodes on face.
+             int                     loc_face                                                       ///< Face physical group (0...31).
+            );
+
+  /// @brief **Render list builder.**
+  /// @details Lists the links to draw; it must be given the neighbour indices before encoding.
+  void build (
+              std::vector<int>&                       loc_render,                                   ///< Render list.
+              const std::vector<int>&                 loc_neighbour,                                ///< Neighbour indices.
+              const std::vector<int>&                 loc_offset,                                   ///< Neighbour offsets.
+              const std::vector<float>&               loc_resting,                                  ///< Resting lengths [m].
+              float                                   loc_length,                                   ///< Maximum visible length [m].
+              const std::vector<nu_float4_structure>& loc_position                                  ///< Initial positions [m].
+             );
+
+  /// @brief **Render report.**
+  /// @details Prints the rendered links compared with all links.
+  void report ();
+
+private:
+  /// @brief **Slab test.**
+  bool inside (
+               const nu_float4_structure& loc_position                                              ///< Position [m].
+              );
+};
+
+inline surface::surface (
+                         size_t      loc_nodes,
+                         std::string loc_mode
+                        )
+{
+  char a = 0;                                                                                       // Slab axis name.
+
+  axis  = 0;                                                                                        // Resetting slab axis...
+  lo    = 0.0f;                                                                                     // Resetting slab lower plane...
+  hi    = 0.0f;                                                                                     // Resetting slab upper plane...
+  links = 0;                                                                                        // Resetting number of links...
+  drawn = 0;                                                                                        // Resetting number of rendered links...
+  face.assign (loc_nodes, 0);                                                                       // Resetting boundary faces...
+
+  if(loc_mode == "all")
+  {
+    mode = ALL_LINKS;                                                                               // Drawing all visible links...
+  }
+  else if(loc_mode == "surface")
+  {
+    mode = SURFACE_LINKS;                                                                           // Drawing boundary surface links...
+  }
+  else if((std::sscanf (loc_mode.c_str (), "%c:%f:%f", &a, &lo, &hi) == 3) &&
+          (a >= 'x') && (a <= 'z') && (lo < hi))
+  {
+    mode = SLAB_LINKS;                                                                              // Drawing clipping slab links...
+    axis = a - 'x';                                                                                 // Setting slab axis...
+  }
+  else
+  {
+    std::cout << "Error: --render must be \"surface\", \"all\" or a slab \"axis:min:max\"." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+}
+
+inline void surface::mark (
+                           const std::vector<int>& loc_point,
+                           int                     loc_face
+                          )
+{
+  for(size_t i = 0; i < loc_point.size (); i++)
+  {
+    face[loc_point[i]] |= (1 << loc_face);                                                          // Marking node on face...
+  }
+}
+
+inline bool surface::inside (
+                             const nu_float4_structure& loc_position
+                            )
+{
+  float x = (axis == 0) ? loc_position.x : ((axis == 1) ? loc_position.y : loc_position.z);         // Coordinate along slab axis [m].
+
+  return (x >= lo) && (x <= hi);
+}
+
+inline void surface::build (
+                            std::vector<int>&                       loc_render,
+                            const std::vector<int>&                 loc_neighbour,
+                            const std::vector<int>&                 loc_offset,
+                            const std::vector<float>&               loc_resting,
+                            float                                   loc_length,
+                            const std::vector<nu_float4_structure>& loc_position
+                           )
+{
+  size_t j_min;                                                                                     // Neighbour stride minimum index.
+  size_t k;                                                                                         // Neighbour node index.
+  bool   keep;                                                                                      // Rendering flag.
+
+  loc_render.clear ();                                                                              // Resetting render list...
+  links = loc_neighbour.size ();                                                                    // Getting number of links...
+
+  for(size_t i = 0; i < loc_offset.size (); i++)
+  {
+    j_min = (i == 0) ? 0 : size_t (loc_offset[i - 1]);                                              // Setting stride minimum...
+
+    for(size_t j = j_min; j < size_t (loc_offset[i]); j++)
+    {
+      k = size_t (loc_neighbour[j]);                                                                // Getting neighbour node...
+
+      switch(mode)
+      {
+        case SURFACE_LINKS:
+          keep = (face[i] & face[k]) != 0;                                                          // Checking common boundary face...
+          break;
+
+        case SLAB_LINKS:
+          keep = inside (loc_position[i]) && inside (loc_position[k]);                              // Checking slab...
+          break;
+
+        default:
+          keep = true;                                                                              // Keeping all links...
+          break;
+      }
+
+      if(keep && (loc_resting[j] <= loc_length))
+      {
+        loc_render.push_back (int (j));                                                             // Listing link...
+      }
+    }
+  }
+
+  drawn = loc_render.size ();                                                                       // Getting number of rendered links...
+
+  if(drawn == 0)
+  {
+    std::cout << "Error: no links to render (check the --render slab)." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+}
+
+inline void surface::report ()
+{
+  const char* name[] = {"all", "surface", "slab"};
+
+  std::cout << "render = " << name[mode] << ", " << drawn << " of " << links << " links ("
+            << 100.0*double (drawn)/double (links) << "%)" << std::endl;                            // Printing render list size...
+}
+}
+
+#endif
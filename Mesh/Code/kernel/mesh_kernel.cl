@@ -1,47 +1,52 @@
 /// @file
 
 __kernel void thekernel(__global float4*    color,                              // Color [#].
-                        __global float4*    position,                           // Position [m].
-                        __global int*       central,                            // Node.
+                        __global float4*    position_gl,                        // Position (plotted copy) [m].
+                        __global int*       encoding,                           // Neighbour index encoding.
                         __global int*       neighbour,                          // Neighbour.
-                        __global int*       offset                              // Offset.
+                        __global int*       offset,                             // Offset.
+                        __global POSITION4* position                            // Position (node state) [m].
                         )
 {
+  // PADDING (global size rounded up to a multiple of the local size, see autotune.hpp):
+  #ifdef NODES
+  if (get_global_id(0) >= NODES)
+  {
+    return;                                                                     // Skipping padding work-item...
+  }
+  #endif
+
   ////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// INDICES ///////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////
   unsigned int i = get_global_id(0);                                            // Global index [#].
   unsigned int j = 0;                                                           // Neighbour stride index.
   unsigned int j_min = 0;                                                       // Neighbour stride minimun index.
-  unsigned int j_max = offset[i];                                               // Neighbour stride maximum index.
+  unsigned int j_max = STRIDE_MAX(i);                                           // Neighbour stride maximum index.
   unsigned int k = 0;                                                           // Neighbour tuple index.
-  unsigned int n = central[j_max - 1];                                          // Node index.
+  unsigned int n = i;                                                           // Node index (implicit central node).
+  int          e = encoding[0];                                                 // Neighbour index encoding.
 
   ////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////// CELL VARIABLES //////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////
-  float4        nearest           = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Neighbour node position.
-  float4        link              = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Neighbour link.
-  float         L                 = 0.0f;                                       // Neighbour link length.
-  float4        p                 = position[n];                                // Central node position (intermediate).
+  ACC4          nearest           = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Neighbour node position.
+  ACC4          link              = (ACC4)(0.0f, 0.0f, 0.0f, 1.0f);             // Neighbour link.
+  ACC           L                 = 0.0f;                                       // Neighbour link length.
+  ACC4          p                 = TO_ACC4(position[n]);                       // Central node position (intermediate).
 
   // COMPUTING STRIDE MINIMUM INDEX:
-  if (i == 0)
-  {
-    j_min = 0;                                                                  // Setting stride minimum (first stride)...
-  }
-  else
-  {
-    j_min = offset[i - 1];                                                      // Setting stride minimum (all others)...
-  }
+  j_min = STRIDE_MIN(i);                                                        // Setting stride minimum...
 
   // COMPUTING ELASTIC FORCE:
-  for (j = j_min; j < j_max; j++)
+  for (j = j_min; j < j_max; j += LINK_STEP)
   {
-    k = neighbour[j];                                                           // Computing neighbour index...
-    nearest = position[k];                                                      // Getting neighbour position...
+    k = neighbour_index(neighbour, e, j, n);                                    // Computing neighbour index...
+    nearest = TO_ACC4(position[k]);                                             // Getting neighbour position...
     link = nearest - p;                                                         // Getting neighbour link vector...
     L = length(link);                                                           // Computing neighbour link length...
-    color[j].xyz = colormap(50.0f*L);                                           // Setting color...
+    color[j].xyz = colormap((float)(50.0f*L));                                  // Setting color...
   }
+
+  position_gl[n] = convert_float4(p);                                           // Setting plotted position...
 }
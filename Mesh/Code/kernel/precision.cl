@@ -0,0 +1,56 @@
+/// @file     precision.cl
+/// @brief    Compile-time precision of the node state and of the force accumulation.
+/// @details  PRECISION chooses the arithmetic of the step kernels: 0 = single (default), 1 = mixed
+/// (positions and accumulated forces in double, everything else in float), 2 = double. REAL is the
+/// type of the plain arithmetic, ACC the type of positions and force accumulators. The storage of
+/// the node state is set by the host (see nodestate.hpp): POSITION_DOUBLE stores the positions
+/// (position, position_int) as double4 and STATE_DOUBLE the other kinematic arrays (velocity,
+/// acceleration, velocity_int). The plotted arrays shared with OpenGL stay float4, and kernels
+/// which never read the node state keep their float4 arguments.
+
+#ifndef PRECISION
+  #define PRECISION 0                                                           // Single precision (default).
+#endif
+
+#if (PRECISION > 0) || defined(POSITION_DOUBLE) || defined(STATE_DOUBLE)
+  #pragma OPENCL EXTENSION cl_khr_fp64 : enable                                 // Enabling double precision...
+#endif
+
+// ARITHMETIC (double in double mode only):
+#if PRECISION == 2
+  typedef double  REAL;                                                         // Real number.
+  typedef double4 REAL4;                                                        // Real vector.
+  #define TO_REAL4(x) convert_double4(x)                                        // Real vector conversion.
+#else
+  typedef float   REAL;                                                         // Real number.
+  typedef float4  REAL4;                                                        // Real vector.
+  #define TO_REAL4(x) convert_float4(x)                                         // Real vector conversion.
+#endif
+
+// ACCUMULATION (positions and forces, double in mixed and double modes):
+#if PRECISION > 0
+  typedef double  ACC;                                                          // Accumulator number.
+  typedef double4 ACC4;                                                         // Accumulator vector.
+  #define TO_ACC4(x) convert_double4(x)                                         // Accumulator vector conversion.
+#else
+  typedef float   ACC;                                                          // Accumulator number.
+  typedef float4  ACC4;                                                         // Accumulator vector.
+  #define TO_ACC4(x) convert_float4(x)                                          // Accumulator vector conversion.
+#endif
+
+// STORAGE (node arrays, FP32 unless widened by the host):
+#ifdef POSITION_DOUBLE
+  typedef double4 POSITION4;                                                    // Position array element.
+  #define TO_POSITION4(x) convert_double4(x)                                    // Position conversion.
+#else
+  typedef float4  POSITION4;                                                    // Position array element.
+  #define TO_POSITION4(x) convert_float4(x)                                     // Position conversion.
+#endif
+
+#ifdef STATE_DOUBLE
+  typedef double4 STATE4;                                                       // Kinematic array element.
+  #define TO_STATE4(x) convert_double4(x)                                       // Kinematic conversion.
+#else
+  typedef float4  STATE4;                                                       // Kinematic array element.
+  #define TO_STATE4(x) convert_float4(x)                                        // Kinematic conversion.
+#endif
@@ -1,6 +1,5 @@
 /// @file
 
-#define INTEROP       true                                                                          // "true" = use OpenGL-OpenCL interoperability.
 #define SX            800                                                                           // Window x-size [px].
 #define SY            600                                                                           // Window y-size [px].
 #define NM            "Neutrino - Mesh"                                                             // Window name.
@@ -31,13 +30,24 @@
 #define SHADER_FRAG   "voxel_fragment.frag"                                                         // OpenGL fragment shader.
 #define KERNEL        "mesh_kernel.cl"                                                              // OpenCL kernel source.
 #define UTILITIES     "utilities.cl"                                                                // OpenCL utilities source.
+#define FP_TYPES      "precision.cl"                                                                // OpenCL precision types source.
+#define KERNEL_FP     "mesh_precision.cl"                                                           // OpenCL precision definitions (generated).
 #define MESH_FILE     "Utah_teapot.msh"                                                             // GMSH mesh.
 #define MESH          GMSH_HOME MESH_FILE                                                           // GMSH mesh (full path).
 
 // INCLUDES:
 #include "nu.hpp"                                                                                   // Neutrino's header file.
+#include "options.hpp"                                                                              // Command line options.
+#include "capture.hpp"                                                                              // Offscreen capture.
+#include "topology.hpp"                                                                             // Neighbour list encoding.
+#include "zerocopy.hpp"                                                                             // Zero-copy sharing without interop.
+#include "nodestate.hpp"                                                                            // Node state at the chosen precision.
+#include "specialization.hpp"                                                                       // Kernel specialization.
+#include "precision.hpp"                                                                            // Compile-time precision.
+#include "startup.hpp"                                                                              // Concurrent startup pipeline.
+#include "scene.hpp"                                                                                // Mesh instance batching.
 
-int main ()
+int main (int argc, char** argv)
 {
   // INDEXES:
   size_t              i;                                                                            // Index [#].
@@ -56,27 +66,66 @@ int main ()
   float               gmp_decaytime  = 1.25f;                                                       // Low pass filter decay time [s].
   float               gmp_deadzone   = 0.1f;                                                        // Gamepad joystick deadzone [0...1].
 
+  // OPTIONS:
+  ex::options*        opt            = new ex::options (argc, argv);                                // Command line options.
+  size_t              steps          = opt->get ("steps", size_t (0));                              // Number of steps (0 = unlimited) [#].
+  size_t              step           = 0;                                                           // Step index [#].
+  std::string         capture        = opt->get ("capture", std::string (""));                      // Capture directory ("" = no capture).
+  size_t              every          = opt->get ("every", size_t (1));                              // Capture period [steps].
+  bool                headless       = opt->flag ("headless");                                      // Headless flag (hidden window).
+  std::string         coding         = opt->get ("topology", std::string ("auto"));                 // Neighbour encoding ("auto", "wide" or "delta").
+  bool                zero_copy      = opt->flag ("zero-copy");                                     // Forced zero-copy sharing flag.
+  std::string         scenery        = opt->get ("scene", std::string (""));                        // Scene file ("" = MESH_FILE only).
+  ex::precision*      fp             = new ex::precision (opt->get ("precision",
+                                                          std::string ("single")), true);           // Precision (node state, see nodestate.hpp).
+
+  // STARTUP (mesh loaded while the contexts are created, see startup.hpp):
+  ex::startup*        boot           = new ex::startup (opt->get ("startup", std::string ("parallel"))); // Startup pipeline.
+  ex::scene*          scn            = new ex::scene ();                                            // Mesh instances (batched).
+  size_t              loading;                                                                      // Mesh loading phase.
+
+  if(scenery == "")
+  {
+    scn->add (MESH, {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f});                                    // Adding single mesh...
+  }
+  else
+  {
+    scn->read (scenery);                                                                            // Reading scene...
+  }
+
+  loading = boot->run ("mesh", [&] ()
+  {
+    scn->load (TAG, DIM, nu::MSH_TRI_3);                                                            // Loading meshes and batching instances...
+  });
+
   // OPENGL:
   nu::opengl*         gl             = new nu::opengl (NM, SX, SY, OX, OY, PX, PY, PZ);             // OpenGL context.
+  ex::capture*        rec            = new ex::capture (capture, every, headless);                  // Offscreen capture.
   nu::shader*         S              = new nu::shader ();                                           // OpenGL shader program.
   nu::projection_mode pmode          = nu::MONOCULAR;                                               // OpenGL projection mode.
   nu::view_mode       vmode          = nu::DIRECT;                                                  // OpenGL view mode.
 
   // OPENCL:
+  bool                interop        = !zero_copy && ex::zerocopy::probe (CL_DEVICE_TYPE_GPU);      // CL/GL interop flag (probed before the context).
   nu::opencl*         cl             = new nu::opencl (nu::GPU);                                    // OpenCL context.
   nu::kernel*         K              = new nu::kernel ();                                           // OpenCL kernel array.
   nu::float4*         color          = new nu::float4 (0);                                          // Color [].
   nu::float4*         position       = new nu::float4 (1);                                          // Position [m].
-  nu::int1*           central        = new nu::int1 (2);                                            // Central nodes.
+  nu::int1*           encoding       = new nu::int1 (2);                                            // Neighbour index encoding (implicit central nodes).
   nu::int1*           neighbour      = new nu::int1 (3);                                            // Neighbour.
   nu::int1*           offset         = new nu::int1 (4);                                            // Offset.
+  nu::float4*         position_node  = new nu::float4 (5);                                          // Position (node state) [m].
+  ex::zerocopy*       zc;                                                                           // Zero-copy sharing (without interop).
+  ex::nodestate*      ns;                                                                           // Node state (at the chosen precision).
+  ex::specialization* fpd            = new ex::specialization (KERNEL_FP);                          // Precision definitions.
 
   // MESH:
-  nu::mesh*           obj            = new nu::mesh (MESH);                                         // Mesh obj.
   size_t              nodes;                                                                        // Number of nodes.
   size_t              elements;                                                                     // Number of elements.
   size_t              groups;                                                                       // Number of groups.
   size_t              neighbours;                                                                   // Number of neighbours.
+  ex::topology*       topo;                                                                         // Neighbour list encoding.
+  bool                listing;                                                                      // Neighbour listing flag.
   float               x_min          = -1.0f;                                                       // "x_min" spatial boundary [m].
   float               x_max          = +1.0f;                                                       // "x_max" spatial boundary [m].
   float               y_min          = -1.0f;                                                       // "y_min" spatial boundary [m].
@@ -86,14 +135,18 @@ int main ()
   ///////////////////////////////////////// DATA INITIALIZATION //////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   // MESH:
-  obj->process (TAG, DIM, nu::MSH_TRI_3);                                                           // Processing mesh...
-  position->data  = obj->node_coordinates;                                                          // Setting all node coordinates...
-  neighbour->data = obj->neighbour;                                                                 // Setting neighbour indices...
-  offset->data    = obj->neighbour_offset;                                                          // Setting neighbour offsets...
-  nodes           = obj->node.size ();                                                              // Getting the number of nodes...
-  elements        = obj->element.size ();                                                           // Getting the number of elements...
-  groups          = obj->group.size ();                                                             // Getting the number of groups...
-  neighbours      = obj->neighbour.size ();                                                         // Getting the number of neighbours...
+  boot->mark ("contexts");                                                                          // Marking contexts created...
+  boot->join (loading);                                                                             // Waiting for mesh...
+  position->data  = scn->position;                                                                  // Setting all node coordinates...
+  position_node->data = scn->position;                                                              // Setting node state coordinates...
+  neighbour->data = scn->neighbour;                                                                 // Setting neighbour indices...
+  offset->data    = scn->offset;                                                                    // Setting neighbour offsets...
+  nodes           = scn->position.size ();                                                          // Getting the number of nodes...
+  elements        = scn->elements;                                                                  // Getting the number of elements...
+  groups          = scn->groups;                                                                    // Getting the number of groups...
+  neighbours      = scn->neighbour.size ();                                                         // Getting the number of neighbours...
+  listing         = (scn->instances () == 1);                                                       // Listing neighbours of a single mesh only...
+  scn->report ();                                                                                   // Printing scene...
   std::cout << "nodes = " << nodes << std::endl;                                                    // Printing message...
   std::cout << "elements = " << elements/CELL_VERTICES << std::endl;                                // Printing message...
   std::cout << "groups = " << groups/CELL_VERTICES << std::endl;                                    // Printing message...
@@ -102,7 +155,10 @@ int main ()
   // SETTING NEUTRINO ARRAYS ("surface" depending):
   for(i = 0; i < nodes; i++)
   {
-    std::cout << "i = " << i << ", node index = " << obj->node[i] << ", neighbour indices:";        // Printing message...
+    if(listing)
+    {
+      std::cout << "i = " << i << ", node index = " << i << ", neighbour indices:";                 // Printing message...
+    }
 
     // Computing minimum element offset index:
     if(i == 0)
@@ -118,35 +174,71 @@ int main ()
 
     for(j = j_min; j < j_max; j++)
     {
-      central->data.push_back (obj->node[i]);                                                       // Building central node tuple...
-
-      std::cout << " " << neighbour->data[j];                                                       // Printing message...
+      if(listing)
+      {
+        std::cout << " " << neighbour->data[j];                                                     // Printing message...
+      }
 
       color->data.push_back ({1.0f, 0.0f, 0.0f, 0.5f});                                             // Setting link color...
     }
 
-    std::cout << std::endl;                                                                         // Printing message...
+    if(listing)
+    {
+      std::cout << std::endl;                                                                       // Printing message...
+    }
   }
 
+  // ENCODING NEIGHBOUR LISTS (see topology.hpp):
+  topo = new ex::topology (neighbour->data, offset->data, coding);                                  // Choosing encoding...
+  topo->encode (neighbour->data, offset->data);                                                     // Encoding neighbour indices...
+  encoding->data = {int (topo->mode)};                                                              // Setting encoding...
+  topo->report (neighbours);                                                                        // Printing encoding...
+
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENCL KERNELS INITIALIZATION /////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
+  fpd->define ("PRECISION", size_t (fp->mode));                                                     // Setting kernel arithmetic precision...
+
+  if(fp->position)
+  {
+    fpd->define ("POSITION_DOUBLE", size_t (1));                                                    // Storing positions in double...
+  }
+
+  K->addsource (fpd->write ());                                                                     // Setting kernel precision source...
+  K->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                                // Setting kernel source file...
   K->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                               // Setting kernel source file...
   K->addsource (std::string (KERNEL_HOME) + std::string (KERNEL));                                  // Setting kernel source file...
-  K->build (nodes, 0, 0);                                                                           // Building kernel program...
+  boot->run ("kernel", [&] ()
+  {
+    K->build (nodes, 0, 0);                                                                         // Building kernel program...
+  });
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENGL SHADERS INITIALIZATION /////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), nu::VERTEX);                 // Setting shader source file...
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), nu::GEOMETRY);               // Setting shader source file...
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), nu::FRAGMENT);               // Setting shader source file...
-  S->build (neighbours);                                                                            // Building shader program...
+  boot->now ("shader", [&] ()
+  {
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), nu::VERTEX);               // Setting shader source file...
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), nu::GEOMETRY);             // Setting shader source file...
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), nu::FRAGMENT);             // Setting shader source file...
+    S->build (neighbours);                                                                          // Building shader program...
+  });
+
+  boot->join ();                                                                                    // Waiting for kernel builds...
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////// SETTING OPENCL KERNEL ARGUMENTS /////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   cl->write ();                                                                                     // Writing OpenCL data...
+  zc = new ex::zerocopy (K, interop);                                                               // Choosing sharing path...
+  zc->share (0, color->data);                                                                       // Sharing color...
+  zc->share (1, position->data);                                                                    // Sharing position...
+  zc->attach ({K});                                                                                 // Setting shared kernel arguments...
+  zc->report ();                                                                                    // Printing sharing path...
+  ns = new ex::nodestate (K);                                                                       // Storing node state...
+  ns->store (5, position_node->data, fp->position);                                                 // Storing position...
+  ns->attach ({K});                                                                                 // Setting node state kernel arguments...
+  ns->report ();                                                                                    // Printing node state storage...
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////// APPLICATION LOOP ////////////////////////////////////////
@@ -154,15 +246,20 @@ int main ()
   while(!gl->closed ())                                                                             // Opening window...
   {
     cl->get_tic ();                                                                                 // Getting "tic" [us]...
+    zc->to_cl ();                                                                                   // Waiting for the last draw...
     cl->acquire ();                                                                                 // Acquiring OpenCL kernel...
     cl->execute (K, nu::WAIT);                                                                      // Executing OpenCL kernel...
     cl->release ();                                                                                 // Releasing OpenCL kernel...
+    zc->to_gl ();                                                                                   // Handing shared arrays to OpenGL...
 
     gl->begin ();                                                                                   // Beginning gl...
     gl->poll_events ();                                                                             // Polling gl events...
     gl->mouse_navigation (ms_orbit_rate, ms_pan_rate, ms_decaytime);                                // Polling mouse...
     gl->gamepad_navigation (gmp_orbit_rate, gmp_pan_rate, gmp_decaytime, gmp_deadzone);             // Polling gamepad...
+    rec->bind ();                                                                                   // Binding offscreen capture...
     gl->plot (S, pmode, vmode);                                                                     // Plotting shared arguments...
+    zc->drawn ();                                                                                   // Fencing draw...
+    rec->unbind ();                                                                                 // Reading back offscreen capture...
 
     if(gl->key_M)
     {
@@ -180,19 +277,35 @@ int main ()
     }
 
     gl->end ();                                                                                     // Ending gl...
+    boot->frame ();                                                                                 // Reporting startup (first frame)...
     cl->get_toc ();                                                                                 // Getting "toc" [us]...
+
+    if((steps > 0) && (++step >= steps))
+    {
+      gl->close ();                                                                                 // Closing gl (step limit reached)...
+    }
   }
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////// CLEANUP ////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
+  delete ns;                                                                                        // Deleting node state...
+  delete zc;                                                                                        // Deleting zero-copy sharing...
+  delete rec;                                                                                       // Deleting offscreen capture...
   delete cl;                                                                                        // Deleting OpenCL context...
   delete gl;                                                                                        // Deleting OpenGL gui ...
+  delete opt;                                                                                       // Deleting command line options...
+  delete boot;                                                                                      // Deleting startup pipeline...
   delete color;                                                                                     // Deleting color data...
   delete position;                                                                                  // Deleting position data...
-  delete central;                                                                                   // Deleting centrals...
+  delete position_node;                                                                             // Deleting node state position data...
+  delete fpd;                                                                                       // Deleting precision definitions...
+  delete fp;                                                                                        // Deleting precision...
+  delete encoding;                                                                                  // Deleting neighbour index encoding...
+  delete topo;                                                                                      // Deleting neighbour list encoding...
   delete neighbour;                                                                                 // Deleting neighbours...
   delete offset;                                                                                    // Deleting offset...
+  delete scn;                                                                                       // Deleting scene...
   delete K;                                                                                         // Deleting OpenCL kernel...
 
   return 0;
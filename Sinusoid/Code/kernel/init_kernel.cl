@@ -0,0 +1,61 @@
+/// @file     init_kernel.cl
+/// @brief    It initializes the sinusoidal sheet directly on the device.
+///
+/// @details  Each work-item sets the point of its node on the regular grid described by the
+/// "grid" array and a pseudo-random color from a counter-based hash of (seed, node, channel):
+/// the same seed always gives the same colors, independently of the device and of the order in
+/// which work-items are executed.
+
+/// @brief **Counter-based hash.**
+/// @details Integer hash with good avalanche properties ("lowbias32").
+uint hash (uint x)
+{
+        x ^= x >> 16;
+        x *= 0x7feb352dU;
+        x ^= x >> 15;
+        x *= 0x846ca68bU;
+        x ^= x >> 16;
+
+        return x;
+}
+
+/// @brief **Counter-based random number.**
+/// @details It returns a value in [0, 0.99] with steps of 0.01, as "0.01*(rand() % 100)".
+float random (uint seed, uint node, uint channel)
+{
+        return 0.01f*(hash(hash(seed ^ hash(node)) + channel)%100);
+}
+
+/// @brief **OpenCL kernel function**
+/// @details grid = {x_min, y_min, dx, dy}, grid_index = {nodes_x, seed}: the integers are not
+/// passed as floats, which would round the seed above 2^24.
+__kernel void thekernel (
+        __global float4*    voxel_color,                                                            ///< Voxel color coordinates.
+        __global float4*    voxel_point,                                                            ///< Voxel point coordinates (plotted copy).
+        __constant float*   time,                                                                   ///< Time [s] (high and low parts).
+        __constant float*   grid,                                                                   ///< Grid parameters.
+        __constant int*     grid_index,                                                             ///< Grid integer parameters.
+        __global POSITION4* voxel_state                                                             ///< Voxel point coordinates (node state).
+        )
+{
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        //////////////////////////////////////////// INDEXES /////////////////////////////////////////
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        unsigned int gid = get_global_id(0);                                                        // Global index "0".
+        unsigned int nodes_x = (unsigned int)grid_index[0];                                         // Number of nodes in "x" direction.
+        unsigned int seed = (unsigned int)grid_index[1];                                            // Color seed.
+        unsigned int i = gid%nodes_x;                                                               // "x" direction index.
+        unsigned int j = gid/nodes_x;                                                               // "y" direction index.
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        ///////////////////////////////////////////// NODES //////////////////////////////////////////
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        float4 P = (float4)(grid[0] + i*grid[2], grid[1] + j*grid[3], 0.0f, 1.0f);                  // Voxel point coordinates.
+
+        voxel_point[gid] = P;                                                                       // Setting voxel point...
+        voxel_state[gid] = TO_POSITION4(P);                                                         // Setting voxel state...
+        voxel_color[gid] = (float4)(random(seed, gid, 0),
+                                    random(seed, gid, 1),
+                                    random(seed, gid, 2),
+                                    1.0f);                                                          // Setting voxel color...
+}
@@ -9,12 +9,30 @@
 /// @brief **OpenCL kernel function**
 /// @details It computes the 3D coordinates of a sinsoidal sheet defined by:
 /// @f$ z = 0.1 \sin(10 x - 0.1 t) + 0.1 \cos(10 y - 0.1 t) @f$
+/// The time is the same for all nodes: it is advanced by the host in double and passed as a float
+/// pair (high part, low part), summed in ACC. The node state is read from and written to
+/// voxel_state at the chosen precision (see precision.cl), with the phases in ACC: in mixed mode
+/// they are reduced to [0, 2 pi) in double before the float sine and cosine. voxel_point gets a
+/// float4 copy for plotting.
+/// With ROUND_TRIP defined at build time, the voxel color is also read and written back (memory
+/// bandwidth benchmark only).
 __kernel void thekernel (
         __global float4*    voxel_color,                                                            ///< Voxel color coordinates.
-        __global float4*    voxel_point,                                                            ///< Voxel point coordinates.
-        __global float*     time                                                                    ///< Time [s].
+        __global float4*    voxel_point,                                                            ///< Voxel point coordinates (plotted copy).
+        __constant float*   time,                                                                   ///< Time [s] (high and low parts).
+        __constant float*   grid,                                                                   ///< Grid parameters.
+        __constant int*     grid_index,                                                             ///< Grid integer parameters.
+        __global POSITION4* voxel_state                                                             ///< Voxel point coordinates (node state).
         )
 {
+        // PADDING (global size rounded up to a multiple of the local size, see autotune.hpp):
+        #ifdef NODES
+        if (get_global_id(0) >= NODES)
+        {
+                return;                                                                             // Skipping padding work-item...
+        }
+        #endif
+
         //////////////////////////////////////////////////////////////////////////////////////////////
         //////////////////////////////////////////// INDEXES /////////////////////////////////////////
         //////////////////////////////////////////////////////////////////////////////////////////////
@@ -23,18 +41,31 @@ __kernel void thekernel (
         //////////////////////////////////////////////////////////////////////////////////////////////
         ///////////////////////////////////////////// NODES //////////////////////////////////////////
         //////////////////////////////////////////////////////////////////////////////////////////////
-        float4 P;                                                                                   // Voxel point coordinates.
+        ACC4 P;                                                                                     // Voxel point coordinates.
+        ACC t;                                                                                      // Time [s].
+        ACC phase_x;                                                                                // "x" phase [rad].
+        ACC phase_y;                                                                                // "y" phase [rad].
+#ifdef ROUND_TRIP
         float4 C;                                                                                   // Voxel color coordinates.
-        float t;                                                                                    // Time [s].
+#endif
 
+        P = TO_ACC4(voxel_state[gid]);                                                              // Getting voxel point...
+        t = (ACC)time[0] + (ACC)time[1];                                                            // Getting simulation time...
+#ifdef ROUND_TRIP
         C = voxel_color[gid];                                                                       // Getting voxel color...
-        P = voxel_point[gid];                                                                       // Getting voxel point...
-        t = time[gid];                                                                              // Getting simulation time...
+#endif
 
-        P.z = 0.1f*sin(10.0f*P.x - 0.1f*t) + 0.1f*cos(10.0f*P.y - 0.1f*t);                          // Computing "z" point coordinate...
-        t += 0.1;                                                                                   // Incrementing simulation time...
+        phase_x = 10*P.x - t/10;                                                                    // Computing "x" phase...
+        phase_y = 10*P.y - t/10;                                                                    // Computing "y" phase...
+#if PRECISION == 1
+        phase_x = fmod(phase_x, 2*M_PI);                                                            // Reducing "x" phase...
+        phase_y = fmod(phase_y, 2*M_PI);                                                            // Reducing "y" phase...
+#endif
+        P.z = (sin((REAL)phase_x) + cos((REAL)phase_y))/10;                                         // Computing "z" point coordinate...
 
+        voxel_state[gid] = TO_POSITION4(P);                                                         // Setting voxel state...
+        voxel_point[gid] = convert_float4(P);                                                       // Setting voxel point...
+#ifdef ROUND_TRIP
         voxel_color[gid] = C;                                                                       // Setting voxel color...
-        voxel_point[gid] = P;                                                                       // Setting voxel point...
-        time[gid] = t;                                                                              // Setting simulation time...
+#endif
 }
@@ -3,7 +3,6 @@
 /// @date     24OCT2019
 /// @brief    It implements an example of a Neutrino application.
 
-#define INTEROP       true                                                                          // "true" = use OpenGL-OpenCL interoperability.
 #define SX            800                                                                           // Window x-size [px].
 #define SY            600                                                                           // Window y-size [px].
 #define NM            "Neutrino - Sinusoid"                                                         // Window name.
@@ -23,20 +22,29 @@
   #define KERNEL_HOME "..\\..\\Sinusoid\\Code\\kernel\\"                                            // Windows OpenCL kernels directory.
 #endif
 
+#define KERNEL_INIT   "init_kernel.cl"                                                              // OpenCL kernel (initialization).
 #define KERNEL_FILE   "sine_kernel.cl"                                                              // OpenCL kernel.
+#define KERNEL_SPEC   "sinusoid_specialization.cl"                                                // OpenCL kernel defines (generated).
+#define KERNEL_FP     "sinusoid_precision.cl"                                                       // OpenCL precision definitions (generated).
+#define FP_TYPES      "precision.cl"                                                                // OpenCL precision types source.
+#define REPORT        100                                                                           // Throughput report period [steps].
 #define SHADER_VERT   "voxel.vert"                                                                  // OpenGL vertex shader.
 #define SHADER_GEOM   "voxel.geom"                                                                  // OpenGL geometry shader.
 #define SHADER_FRAG   "voxel.frag"                                                                  // OpenGL fragment shader.
 
 // INCLUDES:
 #include "nu.hpp"                                                                                   // Neutrino header file.
+#include "options.hpp"                                                                              // Command line options.
+#include "capture.hpp"                                                                              // Offscreen capture.
+#include "zerocopy.hpp"                                                                             // Zero-copy sharing without interop.
+#include "startup.hpp"                                                                              // Concurrent startup pipeline.
+#include "specialization.hpp"                                                                       // Kernel build defines.
+#include "precision.hpp"                                                                            // Compile-time precision.
+#include "nodestate.hpp"                                                                            // Node state at the chosen precision.
+#include <chrono>                                                                                   // Benchmark timing.
 
-int main ()
+int main (int argc, char** argv)
 {
-  // INDICES:
-  size_t              i              = 0;                                                           // "x" direction index.
-  size_t              j              = 0;                                                           // "y" direction index.
-
   // MOUSE PARAMETERS:
   float               ms_orbit_rate  = 1.0f;                                                        // Orbit rotation rate [rev/s].
   float               ms_pan_rate    = 5.0f;                                                        // Pan translation rate [m/s].
@@ -48,79 +56,143 @@ int main ()
   float               gmp_decaytime  = 1.25f;                                                       // Low pass filter decay time [s].
   float               gmp_deadzone   = 0.30f;                                                       // Gamepad joystick deadzone [0...1].
 
+  // OPTIONS:
+  ex::options*        opt            = new ex::options (argc, argv);                                // Command line options.
+  size_t              steps          = opt->get ("steps", size_t (0));                              // Number of steps (0 = unlimited) [#].
+  size_t              step           = 0;                                                           // Step index [#].
+  std::string         capture        = opt->get ("capture", std::string (""));                      // Capture directory ("" = no capture).
+  size_t              every          = opt->get ("every", size_t (1));                              // Capture period [steps].
+  bool                headless       = opt->flag ("headless");                                      // Headless flag (hidden window).
+  bool                round_trip     = opt->flag ("color");                                         // Color read/write round-trip flag.
+  bool                plot           = !opt->flag ("no-plot");                                      // Plotting flag.
+  bool                zero_copy      = opt->flag ("zero-copy");                                     // Forced zero-copy sharing flag.
+  ex::precision*      fp             = new ex::precision (opt->get ("precision",
+                                                          std::string ("single")), true);           // Precision (node state, see nodestate.hpp).
+  ex::startup*        boot           = new ex::startup (opt->get ("startup", std::string ("parallel"))); // Startup pipeline.
+
   // OPENGL:
   nu::opengl*         gl             = new nu::opengl (NM, SX, SY, OX, OY, PX, PY, PZ);             // OpenGL context.
+  ex::capture*        rec            = new ex::capture (capture, every, headless);                  // Offscreen capture.
   nu::shader*         S              = new nu::shader ();                                           // OpenGL shader program.
   nu::projection_mode pmode          = nu::MONOCULAR;                                               // OpenGL projection mode.
   nu::view_mode       vmode          = nu::DIRECT;                                                  // OpenGL view mode.
 
   // OPENCL:
+  bool                interop        = !zero_copy && ex::zerocopy::probe (CL_DEVICE_TYPE_GPU);      // CL/GL interop flag (probed before the context).
   nu::opencl*         cl             = new nu::opencl (nu::GPU);                                    // OpenCL context.
+  nu::kernel*         K0             = new nu::kernel ();                                           // OpenCL kernel array (initialization).
   nu::kernel*         K              = new nu::kernel ();                                           // OpenCL kernel array.
   nu::float4*         color          = new nu::float4 (0);                                          // Color [].
   nu::float4*         position       = new nu::float4 (1);                                          // Position [m].
-  nu::float1*         t              = new nu::float1 (2);                                          // Time step [s].
+  nu::float1*         t              = new nu::float1 (2);                                          // Time [s] (high and low parts).
+  nu::float1*         grid           = new nu::float1 (3);                                          // Grid parameters.
+  nu::int1*           grid_index     = new nu::int1 (4);                                            // Grid integer parameters.
+  nu::float4*         state          = new nu::float4 (5);                                          // Position (node state) [m].
+  ex::zerocopy*       zc;                                                                           // Zero-copy sharing (without interop).
+  ex::nodestate*      ns;                                                                           // Node state (at the chosen precision).
+  ex::specialization* spec           = new ex::specialization (KERNEL_SPEC);                        // Kernel build defines.
+  ex::specialization* fpd            = new ex::specialization (KERNEL_FP);                          // Precision definitions.
 
   // SIMULATION:
   float               x_min          = -1.0f;                                                       // "x_min" spatial boundary [m].
   float               x_max          = +1.0f;                                                       // "x_max" spatial boundary [m].
   float               y_min          = -1.0f;                                                       // "y_min" spatial boundary [m].
   float               y_max          = +1.0f;                                                       // "y_max" spatial boundary [m].
-  size_t              nodes_x        = 100;                                                         // Number of nodes in "X" direction [#].
-  size_t              nodes_y        = 100;                                                         // Number of nodes in "Y" direction [#].
+  size_t              nodes_x        = opt->get ("nodes_x", size_t (100));                          // Number of nodes in "X" direction [#].
+  size_t              nodes_y        = opt->get ("nodes_y", size_t (100));                          // Number of nodes in "Y" direction [#].
   size_t              nodes          = nodes_x*nodes_y;                                             // Total number of nodes [#].
-  float               dx             = (x_max - x_min)/(nodes_x - 1);                               // x-axis mesh spatial size [m].
-  float               dy             = (y_max - y_min)/(nodes_y - 1);                               // y-axis mesh spatial size [m].
+  float               dx             = (nodes_x > 1) ? (x_max - x_min)/(nodes_x - 1) : 0.0f;        // x-axis mesh spatial size [m].
+  float               dy             = (nodes_y > 1) ? (y_max - y_min)/(nodes_y - 1) : 0.0f;        // y-axis mesh spatial size [m].
+  size_t              seed           = opt->get ("seed", size_t (0));                               // Color seed.
+  double              time           = 0.0;                                                         // Simulation time [s].
+
+  // BENCHMARK:
+  std::chrono::steady_clock::time_point tic;                                                        // Kernel start time.
+  double              kernel_time    = 0.0;                                                         // Accumulated kernel time [s].
+  size_t              kernel_steps   = 0;                                                           // Accumulated kernel steps [#].
+  double              node_bytes     = (round_trip ? 32.0 : 0.0) + (fp->position ? 80.0 : 48.0);    // Global memory traffic per node [B].
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   ///////////////////////////////////////// DATA INITIALIZATION //////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
-  for(j = 0; j < nodes_y; j++)
+  boot->mark ("contexts");                                                                          // Marking contexts created...
+
+  if(nodes == 0)
   {
-    for(i = 0; i < nodes_x; i++)
-    {
-      // Setting point coordinates:
-      position->data.push_back (
-      {
-        x_min + i*dx,
-        y_min + j*dy,
-        0.0f,
-        1.0f}
-                               );                                                                   // Setting position...
-
-      // Setting point colors:
-      color->data.push_back (
-      {
-        0.01f*(rand () % 100),
-        0.01f*(rand () % 100),
-        0.01f*(rand () % 100),
-        1.0f
-      }
-                            );                                                                      // Setting "r" color coordinate...
-
-      // Setting time:
-      t->data.push_back (0.0f);                                                                     // Setting time...
-    }
+    std::cout << "Error: nodes_x and nodes_y must be at least 1." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
   }
 
+  std::cout << "nodes = " << nodes << std::endl;                                                    // Printing message...
+  position->data.resize (nodes);                                                                    // Sizing position (set on device)...
+  color->data.resize (nodes);                                                                       // Sizing color (set on device)...
+  state->data.resize (nodes);                                                                       // Sizing node state (set on device)...
+  t->data         = {0.0f, 0.0f};                                                                   // Setting time...
+  grid->data       = {x_min, y_min, dx, dy};                                                        // Setting grid parameters...
+  grid_index->data = {(int)nodes_x, (int)(unsigned int)seed};                                       // Setting grid integer parameters...
+
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENCL KERNELS INITIALIZATION //////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
+  if(round_trip)
+  {
+    spec->define ("ROUND_TRIP", size_t (1));                                                        // Setting color round-trip define...
+    K->addsource (spec->write ());                                                                  // Setting kernel defines (written before any build)...
+  }
+
+  fpd->define ("PRECISION", size_t (fp->mode));                                                     // Setting kernel arithmetic precision...
+
+  if(fp->position)
+  {
+    fpd->define ("POSITION_DOUBLE", size_t (1));                                                    // Storing positions in double...
+  }
+
+  fpd->write ();                                                                                    // Writing precision definitions (before any build)...
+  K0->addsource (fpd->write ());                                                                    // Setting kernel precision source...
+  K0->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                               // Setting kernel source file...
+  K0->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_INIT));                            // Setting kernel source file...
+  boot->run ("init", [&] ()
+  {
+    K0->build (nodes, 0, 0);                                                                        // Building kernel program...
+  });
+
+  K->addsource (fpd->write ());                                                                     // Setting kernel precision source...
+  K->addsource (std::string (KERNEL_HOME) + std::string (FP_TYPES));                                // Setting kernel source file...
   K->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_FILE));                             // Setting kernel source file...
-  K->build (nodes, 0, 0);                                                                           // Building kernel program...
+  boot->run ("kernel", [&] ()
+  {
+    K->build (nodes, 0, 0);                                                                         // Building kernel program...
+  });
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENGL SHADERS INITIALIZATION //////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), nu::VERTEX);                 // Setting shader source file...
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), nu::GEOMETRY);               // Setting shader source file...
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), nu::FRAGMENT);               // Setting shader source file...
-  S->build (nodes);                                                                                 // Building shader program...
+  boot->now ("shader", [&] ()
+  {
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), nu::VERTEX);               // Setting shader source file...
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), nu::GEOMETRY);             // Setting shader source file...
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), nu::FRAGMENT);             // Setting shader source file...
+    S->build (nodes);                                                                               // Building shader program...
+  });
+
+  boot->join ();                                                                                    // Waiting for kernel builds...
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////// SETTING OPENCL KERNEL ARGUMENTS //////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   cl->write ();                                                                                     // Writing OpenCL data...
+  zc = new ex::zerocopy (K, interop);                                                               // Choosing sharing path...
+  zc->share (0, color->data);                                                                       // Sharing color...
+  zc->share (1, position->data);                                                                    // Sharing position...
+  zc->attach ({K0, K});                                                                             // Setting shared kernel arguments...
+  zc->report ();                                                                                    // Printing sharing path...
+  ns = new ex::nodestate (K);                                                                       // Storing node state...
+  ns->store (5, state->data, fp->position);                                                         // Storing position...
+  ns->attach ({K0, K});                                                                             // Setting node state kernel arguments...
+  ns->report ();                                                                                    // Printing node state storage...
+  cl->acquire ();                                                                                   // Acquiring OpenCL kernel...
+  cl->execute (K0, nu::WAIT);                                                                       // Initializing data on device...
+  cl->release ();                                                                                   // Releasing OpenCL kernel...
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////// APPLICATION LOOP ////////////////////////////////////////
@@ -128,15 +200,40 @@ int main ()
   while(!gl->closed ())                                                                             // Opening gui...
   {
     cl->get_tic ();                                                                                 // Getting "tic" [us]...
+    zc->to_cl ();                                                                                   // Waiting for the last draw...
     cl->acquire ();                                                                                 // Acquiring OpenCL kernel...
+    tic = std::chrono::steady_clock::now ();                                                        // Getting kernel start time...
     cl->execute (K, nu::WAIT);                                                                      // Executing OpenCL kernel...
+    kernel_time += std::chrono::duration<double>(std::chrono::steady_clock::now () - tic).count (); // Accumulating kernel time...
     cl->release ();                                                                                 // Releasing OpenCL kernel...
+    time        += 0.1;                                                                             // Advancing simulation time...
+    t->data[0]   = float (time);                                                                    // Setting time (high part)...
+    t->data[1]   = float (time - double (t->data[0]));                                              // Setting time (low part)...
+    cl->write (2);                                                                                  // Writing simulation time...
+    zc->to_gl ();                                                                                   // Handing shared arrays to OpenGL...
+
+    if(++kernel_steps == REPORT)
+    {
+      std::cout << "steps/s = " << kernel_steps/kernel_time
+                << ", nodes/s = " << kernel_steps*nodes/kernel_time
+                << ", GB/s = " << 1.0e-9*kernel_steps*nodes*node_bytes/kernel_time << std::endl;    // Printing throughput...
+      kernel_time  = 0.0;                                                                           // Resetting kernel time...
+      kernel_steps = 0;                                                                             // Resetting kernel steps...
+    }
 
     gl->begin ();                                                                                   // Beginning gl...
     gl->poll_events ();                                                                             // Polling gl events...
     gl->mouse_navigation (ms_orbit_rate, ms_pan_rate, ms_decaytime);                                // Polling mouse...
     gl->gamepad_navigation (gmp_orbit_rate, gmp_pan_rate, gmp_decaytime, gmp_deadzone);             // Polling gamepad...
-    gl->plot (S, pmode, vmode);                                                                     // Plotting shared arguments...
+    rec->bind ();                                                                                   // Binding offscreen capture...
+
+    if(plot)
+    {
+      gl->plot (S, pmode, vmode);                                                                   // Plotting shared arguments...
+      zc->drawn ();                                                                                 // Fencing draw...
+    }
+
+    rec->unbind ();                                                                                 // Reading back offscreen capture...
 
     if(gl->key_M)
     {
@@ -154,19 +251,37 @@ int main ()
     }
 
     gl->end ();                                                                                     // Ending gl...
+    boot->frame ();                                                                                 // Reporting startup (first frame)...
     cl->get_toc ();                                                                                 // Getting "toc" [us]...
+
+    if((steps > 0) && (++step >= steps))
+    {
+      gl->close ();                                                                                 // Closing gl (step limit reached)...
+    }
   }
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////// CLEANUP ////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
+  delete ns;                                                                                        // Deleting node state...
+  delete zc;                                                                                        // Deleting zero-copy sharing...
+  delete rec;                                                                                       // Deleting offscreen capture...
   delete cl;                                                                                        // Deleting OpenCL context...
   delete gl;                                                                                        // Deleting OpenGL gui ...
+  delete opt;                                                                                       // Deleting command line options...
+  delete boot;                                                                                      // Deleting startup pipeline...
   delete S;                                                                                         // Deleting OpenGL shader...
+  delete K0;                                                                                        // Deleting OpenCL kernel...
   delete K;                                                                                         // Deleting OpenCL kernel...
   delete position;                                                                                  // Deleting OpenGL point...
   delete color;                                                                                     // Deleting OpenGL color...
+  delete state;                                                                                     // Deleting node state...
   delete t;                                                                                         // Deleting time...
+  delete grid;                                                                                      // Deleting grid parameters...
+  delete grid_index;                                                                                // Deleting grid integer parameters...
+  delete spec;                                                                                      // Deleting kernel build defines...
+  delete fpd;                                                                                       // Deleting precision definitions...
+  delete fp;                                                                                        // Deleting precision...
 
   return 0;
 }
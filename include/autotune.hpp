@@ -0,0 +1,196 @@
+/// @file     autotune.hpp
+/// @brief    Work-group size autotuner with per-device persistence.
+///
+/// @details  Each kernel is timed with the driver's default local size and with every multiple of
+/// its preferred work-group size multiple (doubling) up to its maximum work-group size. When the
+/// number of nodes is not a multiple of the local size, the global size is padded up to the next
+/// multiple: the kernels must then be built with NODES defined as the number of nodes (the
+/// "-DNODES=<nodes>" option, or a definition file in the examples), so that the padding work-items
+/// return immediately. The winner is stored as `<directory>/<key>.lws`, where the key hashes the
+/// device, the kernel source and build options and the number of nodes, and it is reused on later
+/// runs without timing anything.
+
+#ifndef autotune_hpp
+#define autotune_hpp
+
+// INCLUDES:
+#include "clhost.hpp"                                                                               // Raw OpenCL host context.
+#include "program_cache.hpp"                                                                        // Program hash.
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ex
+{
+/// @class autotune
+/// @brief Work-group size autotuner.
+class autotune
+{
+private:
+  std::string directory;                                                                            ///< Tuning directory ("" = no persistence).
+  bool        retune;                                                                               ///< Retune flag (ignore stored results).
+  size_t      repeats;                                                                              ///< Timed runs per candidate.
+
+  double time (
+               clhost*   loc_cl,                                                                    ///< OpenCL host context.
+               cl_kernel loc_kernel,                                                                ///< Kernel.
+               size_t    loc_global,                                                                ///< Global size.
+               size_t    loc_local                                                                  ///< Local size (0 = driver default).
+              );
+
+public:
+  /// @brief **Class constructor.**
+  autotune (
+            std::string loc_directory,                                                              ///< Tuning directory ("" = no persistence).
+            bool        loc_retune,                                                                 ///< Retune flag (ignore stored results).
+            size_t      loc_repeats                                                                 ///< Timed runs per candidate.
+           );
+
+  /// @brief **Global size.**
+  /// @details loc_size rounded up to a multiple of loc_local (0 = driver default, no padding).
+  static size_t global (
+                        size_t loc_size,                                                            ///< Number of nodes.
+                        size_t loc_local                                                            ///< Local size.
+                       );
+
+  /// @brief **Local size.**
+  /// @details Returns the stored local size for this device, kernel and size, or tunes it. The
+  /// kernel is run on the actual data: the caller must restore its state afterwards.
+  size_t        local (
+                       clhost*     loc_cl,                                                          ///< OpenCL host context.
+                       cl_kernel   loc_kernel,                                                      ///< Kernel.
+                       std::string loc_name,                                                        ///< Kernel name (for the report).
+                       std::string loc_source,                                                      ///< Kernel source and build options.
+                       size_t      loc_size                                                         ///< Number of nodes.
+                      );
+};
+
+inline autotune::autotune (
+                           std::string loc_directory,
+                           bool        loc_retune,
+                           size_t      loc_repeats
+                          )
+{
+  directory = loc_directory;                                                                        // Setting tuning directory...
+  retune    = loc_retune;                                                                           // Setting retune flag...
+  repeats   = loc_repeats;                                                                          // Setting number of timed runs...
+
+  if(directory != "")
+  {
+    std::filesystem::create_directories (directory);                                                // Creating tuning directory...
+  }
+}
+
+inline size_t autotune::global (
+                                size_t loc_size,
+                                size_t loc_local
+                               )
+{
+  if(loc_local == 0)
+  {
+    return loc_size;
+  }
+
+  return ((loc_size + loc_local - 1)/loc_local)*loc_local;
+}
+
+inline double autotune::time (
+                              clhost*   loc_cl,
+                              cl_kernel loc_kernel,
+                              size_t    loc_global,
+                              size_t    loc_local
+                             )
+{
+  std::vector<double> sample;                                                                       // Kernel times [ms].
+  cl_event            event;                                                                        // Kernel event.
+  cl_ulong            start;                                                                        // Kernel start time [ns].
+  cl_ulong            end;                                                                          // Kernel end time [ns].
+
+  for(size_t r = 0; r <= repeats; r++)
+  {
+    check (clEnqueueNDRangeKernel (loc_cl->queue, loc_kernel, 1, nullptr, &loc_global,
+                                   (loc_local == 0) ? nullptr : &loc_local, 0, nullptr, &event),
+           "clEnqueueNDRangeKernel");                                                               // Running kernel...
+    check (clWaitForEvents (1, &event), "clWaitForEvents");                                         // Waiting for kernel...
+    clGetEventProfilingInfo (event, CL_PROFILING_COMMAND_START, sizeof (start), &start, nullptr);   // Getting start time...
+    clGetEventProfilingInfo (event, CL_PROFILING_COMMAND_END, sizeof (end), &end, nullptr);         // Getting end time...
+    clReleaseEvent (event);                                                                         // Releasing event...
+
+    if(r > 0)
+    {
+      sample.push_back (1e-6*(end - start));                                                        // Storing time (first run = warm-up)...
+    }
+  }
+
+  std::sort (sample.begin (), sample.end ());                                                       // Sorting times...
+
+  return sample[sample.size ()/2];                                                                  // Returning median...
+}
+
+inline size_t autotune::local (
+                               clhost*     loc_cl,
+                               cl_kernel   loc_kernel,
+                               std::string loc_name,
+                               std::string loc_source,
+                               size_t      loc_size
+                              )
+{
+  std::string path;                                                                                 // Tuning file path.
+  size_t      maximum;                                                                              // Maximum work-group size.
+  size_t      multiple;                                                                             // Preferred work-group size multiple.
+  size_t      best       = 0;                                                                       // Best local size.
+  double      best_time;                                                                            // Best kernel time [ms].
+  double      base_time;                                                                            // Driver default kernel time [ms].
+  double      t;                                                                                    // Candidate kernel time [ms].
+
+  if(directory != "")
+  {
+    path = (std::filesystem::path (directory)/(hash (loc_cl->name () + '\0' + loc_source + '\0' +
+                                                     std::to_string (loc_size)) + ".lws")).string ();
+    std::ifstream file (path);                                                                      // Tuning file.
+
+    if(!retune && file && (file >> best))
+    {
+      std::cout << "tuning   = " << loc_name << ": local = " << best << " (stored)" << std::endl;
+
+      return best;
+    }
+  }
+
+  check (clGetKernelWorkGroupInfo (loc_kernel, loc_cl->device, CL_KERNEL_WORK_GROUP_SIZE,
+                                   sizeof (maximum), &maximum, nullptr), "clGetKernelWorkGroupInfo");
+  check (clGetKernelWorkGroupInfo (loc_kernel, loc_cl->device,
+                                   CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof (multiple),
+                                   &multiple, nullptr), "clGetKernelWorkGroupInfo");
+  base_time = time (loc_cl, loc_kernel, loc_size, 0);                                               // Timing driver default...
+  best_time = base_time;                                                                            // Setting best time...
+
+  for(size_t l = std::max (multiple, size_t (1)); l <= maximum; l *= 2)
+  {
+    t = time (loc_cl, loc_kernel, global (loc_size, l), l);                                         // Timing candidate...
+
+    if(t < best_time)
+    {
+      best      = l;                                                                                // Setting best local size...
+      best_time = t;                                                                                // Setting best time...
+    }
+  }
+
+  std::cout << "tuning   = " << loc_name << ": local = " << best << " (" << best_time
+            << " ms/run, driver default " << base_time << " ms/run)" << std::endl;
+
+  if(directory != "")
+  {
+    std::ofstream file (path + ".tmp");                                                             // Tuning file (temporary).
+    file << best << std::endl;                                                                      // Writing local size...
+    file.close ();                                                                                  // Closing file...
+    std::filesystem::rename (path + ".tmp", path);                                                  // Publishing local size...
+  }
+
+  return best;
+}
+}
+
+#endif
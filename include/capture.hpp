@@ -0,0 +1,363 @@
+/// @file     capture.hpp
+/// @brief    Offscreen frame capture to numbered image sequences.
+///
+/// @details  The scene is rendered into an offscreen framebuffer object (FBO). Every k-th step
+/// the FBO is read back into one pixel buffer object (PBO) of a ring: the read is asynchronous
+/// and a fence marks its completion, so the application loop never waits for the GPU. Completed
+/// PBOs are mapped on a later step and their pixels are handed to a background writer thread,
+/// which flips, converts and writes them as binary PPM files: `<directory>/frame_<step>.ppm`.
+/// When every PBO of the ring is still being read back, or the writer queue is full, the frame
+/// is dropped and counted instead of waited for.
+
+#ifndef capture_hpp
+#define capture_hpp
+
+// INCLUDES:
+#include "nu.hpp"                                                                                   // Neutrino header file.
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define CAPTURE_RING  3                                                                             // Number of PBOs in the readback ring.
+#define CAPTURE_QUEUE 64                                                                            // Maximum number of frames waiting for the writer.
+#define CAPTURE_DRAIN 1000000000                                                                    // Readback timeout when draining the ring [ns].
+
+namespace ex
+{
+/// @class capture
+/// @brief Offscreen capture context.
+/// @details When constructed with an empty directory the capture is disabled: bind() and
+/// unbind() only blit nothing and count frames, so the same loop measures frames/s either way.
+class capture
+{
+private:
+  /// @brief Frame waiting to be written.
+  struct frame
+  {
+    size_t                     step;                                                                ///< Simulation step.
+    std::vector<unsigned char> pixel;                                                               ///< RGBA pixels (bottom-up).
+  };
+
+  std::string                           directory;                                                  ///< Output directory.
+  size_t                                every;                                                      ///< Capture period [steps].
+  bool                                  headless;                                                   ///< Headless flag.
+  bool                                  enabled;                                                    ///< Capture flag.
+  GLsizei                               size_x;                                                     ///< Framebuffer size_x [px].
+  GLsizei                               size_y;                                                     ///< Framebuffer size_y [px].
+  GLuint                                fbo;                                                        ///< Offscreen framebuffer.
+  GLuint                                color_rbo;                                                  ///< Offscreen color renderbuffer.
+  GLuint                                depth_rbo;                                                  ///< Offscreen depth renderbuffer.
+  GLuint                                pbo[CAPTURE_RING];                                          ///< Readback PBO ring.
+  GLsync                                fence[CAPTURE_RING];                                        ///< Readback fences.
+  size_t                                pbo_step[CAPTURE_RING];                                     ///< Readback steps.
+  size_t                                head;                                                       ///< Next PBO to be filled.
+  size_t                                pending;                                                    ///< PBOs being read back.
+  size_t                                step;                                                       ///< Current step.
+  size_t                                written;                                                    ///< Frames written.
+  size_t                                dropped;                                                    ///< Frames dropped.
+  std::deque<frame>                     queue;                                                      ///< Writer queue.
+  std::mutex                            queue_mutex;                                                ///< Writer queue mutex.
+  std::condition_variable               queue_cv;                                                   ///< Writer queue condition.
+  bool                                  stop;                                                       ///< Writer stop flag.
+  std::thread                           writer;                                                     ///< Writer thread.
+  std::chrono::steady_clock::time_point start;                                                      ///< Loop start time.
+
+  void collect (
+                bool loc_wait                                                                       ///< Drain flag (wait up to CAPTURE_DRAIN per PBO).
+               );
+  void write ();
+
+public:
+  /// @brief **Class constructor.**
+  /// @details Creates the FBO and the PBO ring and starts the writer thread. It must be called
+  /// after the OpenGL context has been created.
+  capture (
+           std::string loc_directory,                                                               ///< Output directory ("" = disabled).
+           size_t      loc_every,                                                                   ///< Capture period [steps].
+           bool        loc_headless                                                                 ///< Headless flag (hidden window).
+          );
+
+  /// @brief **Binding function.**
+  /// @details Redirects rendering to the FBO. To be called after gl->begin () and before
+  /// gl->plot ().
+  void bind ();
+
+  /// @brief **Unbinding function.**
+  /// @details Restores the default framebuffer, starts the asynchronous readback on capture
+  /// steps and blits the FBO to the window unless headless. To be called after gl->plot ().
+  void unbind ();
+
+  /// @brief **Class destructor.**
+  /// @details Drains the PBO ring, joins the writer thread and prints the frames/s. It must be
+  /// called before the OpenGL context is deleted.
+  ~capture ();
+};
+
+inline capture::capture (
+                         std::string loc_directory,
+                         size_t      loc_every,
+                         bool        loc_headless
+                        )
+{
+  size_t i;                                                                                         // Index [#].
+
+  directory = loc_directory;                                                                        // Setting output directory...
+  every     = (loc_every > 0) ? loc_every : 1;                                                      // Setting capture period...
+  headless  = loc_headless;                                                                         // Setting headless flag...
+  enabled   = !directory.empty ();                                                                  // Setting capture flag...
+  head      = 0;                                                                                    // Resetting ring head...
+  pending   = 0;                                                                                    // Resetting ring count...
+  step      = 0;                                                                                    // Resetting step...
+  written   = 0;                                                                                    // Resetting frame counter...
+  dropped   = 0;                                                                                    // Resetting frame counter...
+  stop      = false;                                                                                // Resetting stop flag...
+  fbo       = 0;                                                                                    // Resetting framebuffer...
+
+  if(headless)
+  {
+    glfwHideWindow (glfwGetCurrentContext ());                                                      // Hiding window...
+  }
+
+  if(enabled)
+  {
+    glfwGetFramebufferSize (glfwGetCurrentContext (), &size_x, &size_y);                            // Getting framebuffer size...
+
+    // CREATING OFFSCREEN FRAMEBUFFER:
+    glGenFramebuffers (1, &fbo);                                                                    // Creating framebuffer...
+    glGenRenderbuffers (1, &color_rbo);                                                             // Creating color renderbuffer...
+    glGenRenderbuffers (1, &depth_rbo);                                                             // Creating depth renderbuffer...
+    glBindRenderbuffer (GL_RENDERBUFFER, color_rbo);                                                // Binding color renderbuffer...
+    glRenderbufferStorage (GL_RENDERBUFFER, GL_RGBA8, size_x, size_y);                              // Allocating color renderbuffer...
+    glBindRenderbuffer (GL_RENDERBUFFER, depth_rbo);                                                // Binding depth renderbuffer...
+    glRenderbufferStorage (GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, size_x, size_y);                   // Allocating depth renderbuffer...
+    glBindRenderbuffer (GL_RENDERBUFFER, 0);                                                        // Unbinding renderbuffer...
+    glBindFramebuffer (GL_FRAMEBUFFER, fbo);                                                        // Binding framebuffer...
+    glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_rbo);   // Attaching color...
+    glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_rbo);
+
+    if(glCheckFramebufferStatus (GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+      std::cout << "Error: incomplete capture framebuffer!" << std::endl;                           // Printing message...
+      exit (EXIT_FAILURE);                                                                          // Exiting...
+    }
+
+    glBindFramebuffer (GL_FRAMEBUFFER, 0);                                                          // Unbinding framebuffer...
+
+    // CREATING PBO RING:
+    glGenBuffers (CAPTURE_RING, pbo);                                                               // Creating PBOs...
+
+    for(i = 0; i < CAPTURE_RING; i++)
+    {
+      glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo[i]);                                                  // Binding PBO...
+      glBufferData (GL_PIXEL_PACK_BUFFER, 4*size_x*size_y, nullptr, GL_STREAM_READ);                // Allocating PBO...
+      fence[i] = 0;                                                                                 // Resetting fence...
+    }
+
+    glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);                                                         // Unbinding PBO...
+
+    writer = std::thread (&capture::write, this);                                                   // Starting writer thread...
+    std::cout << "Capturing every " << every << " steps into \"" << directory << "\"" << std::endl; // Printing message...
+  }
+
+  start = std::chrono::steady_clock::now ();                                                        // Getting start time...
+}
+
+inline void capture::bind ()
+{
+  if(enabled)
+  {
+    glBindFramebuffer (GL_FRAMEBUFFER, fbo);                                                        // Binding offscreen framebuffer...
+    glViewport (0, 0, size_x, size_y);                                                              // Setting viewport...
+    glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);                                            // Clearing framebuffer...
+  }
+}
+
+inline void capture::unbind ()
+{
+  if(enabled)
+  {
+    collect (false);                                                                                // Collecting completed PBOs...
+
+    if((step%every == 0) && (pending == CAPTURE_RING))
+    {
+      dropped++;                                                                                    // Dropping frame (ring full)...
+    }
+    else if(step%every == 0)
+    {
+      // STARTING ASYNCHRONOUS READBACK:
+      glBindFramebuffer (GL_READ_FRAMEBUFFER, fbo);                                                 // Binding offscreen framebuffer...
+      glReadBuffer (GL_COLOR_ATTACHMENT0);                                                          // Selecting color attachment...
+      glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo[head]);                                               // Binding PBO...
+      glReadPixels (0, 0, size_x, size_y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);                      // Reading pixels into PBO...
+      glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);                                                       // Unbinding PBO...
+      fence[head]    = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);                              // Setting readback fence...
+      pbo_step[head] = step;                                                                        // Setting readback step...
+      head           = (head + 1)%CAPTURE_RING;                                                     // Advancing ring head...
+      pending++;                                                                                    // Counting pending PBOs...
+    }
+
+    if(!headless)
+    {
+      glBindFramebuffer (GL_READ_FRAMEBUFFER, fbo);                                                 // Binding offscreen framebuffer...
+      glBindFramebuffer (GL_DRAW_FRAMEBUFFER, 0);                                                   // Binding window framebuffer...
+      glBlitFramebuffer (0, 0, size_x, size_y, 0, 0, size_x, size_y, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+
+    glBindFramebuffer (GL_FRAMEBUFFER, 0);                                                          // Restoring window framebuffer...
+  }
+
+  step++;                                                                                           // Counting steps...
+}
+
+inline void capture::collect (
+                              bool loc_wait
+                             )
+{
+  size_t         tail;                                                                              // Oldest pending PBO.
+  GLenum         status;                                                                            // Fence status.
+  bool           ready;                                                                             // Readback completion flag.
+  unsigned char* pixel;                                                                             // Mapped pixels.
+  frame          f;                                                                                 // Frame.
+
+  while(pending > 0)
+  {
+    tail   = (head + CAPTURE_RING - pending)%CAPTURE_RING;                                          // Getting oldest PBO...
+    status = glClientWaitSync (fence[tail], GL_SYNC_FLUSH_COMMANDS_BIT,
+                               loc_wait ? CAPTURE_DRAIN : 0);                                       // Polling fence...
+    ready  = (status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED);                 // Checking readback...
+
+    if(!ready && !loc_wait)
+    {
+      break;                                                                                        // Not ready yet: trying next step...
+    }
+
+    glDeleteSync (fence[tail]);                                                                     // Deleting fence...
+
+    if(!ready)
+    {
+      dropped++;                                                                                    // Dropping frame (readback timed out)...
+      pending--;                                                                                    // Releasing PBO...
+      continue;
+    }
+
+    glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo[tail]);                                                 // Binding PBO...
+    pixel = (unsigned char*)glMapBufferRange (GL_PIXEL_PACK_BUFFER, 0, 4*size_x*size_y, GL_MAP_READ_BIT);
+
+    if(pixel != nullptr)
+    {
+      std::unique_lock<std::mutex> lock (queue_mutex);                                              // Locking writer queue...
+
+      if(queue.size () < CAPTURE_QUEUE)
+      {
+        f.step = pbo_step[tail];                                                                    // Setting frame step...
+        f.pixel.assign (pixel, pixel + 4*size_x*size_y);                                            // Copying frame pixels...
+        queue.push_back (std::move (f));                                                            // Queueing frame...
+        queue_cv.notify_one ();                                                                     // Waking up writer...
+      }
+      else
+      {
+        dropped++;                                                                                  // Dropping frame (writer too slow)...
+      }
+
+      glUnmapBuffer (GL_PIXEL_PACK_BUFFER);                                                         // Unmapping PBO...
+    }
+
+    glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);                                                         // Unbinding PBO...
+    pending--;                                                                                      // Releasing PBO...
+  }
+}
+
+inline void capture::write ()
+{
+  frame                      f;                                                                     // Frame.
+  std::vector<unsigned char> rgb (3*size_x*size_y);                                                 // Top-down RGB pixels.
+  char                       name[32];                                                              // File name.
+  FILE*                      file;                                                                  // File.
+  GLsizei                    x;                                                                     // Pixel x-index.
+  GLsizei                    y;                                                                     // Pixel y-index.
+  size_t                     src;                                                                   // Source pixel index.
+  size_t                     dst;                                                                   // Destination pixel index.
+
+  while(true)
+  {
+    {
+      std::unique_lock<std::mutex> lock (queue_mutex);                                              // Locking writer queue...
+      queue_cv.wait (lock, [this] {return stop || !queue.empty ();});                               // Waiting for frames...
+
+      if(queue.empty ())
+      {
+        return;                                                                                     // Stopping writer...
+      }
+
+      f = std::move (queue.front ());                                                               // Getting frame...
+      queue.pop_front ();                                                                           // Dequeueing frame...
+    }
+
+    for(y = 0; y < size_y; y++)
+    {
+      for(x = 0; x < size_x; x++)
+      {
+        src          = 4*((size_t)(size_y - 1 - y)*size_x + x);                                     // Flipping vertically...
+        dst          = 3*((size_t)y*size_x + x);                                                    // Setting destination...
+        rgb[dst + 0] = f.pixel[src + 0];                                                            // Copying "r"...
+        rgb[dst + 1] = f.pixel[src + 1];                                                            // Copying "g"...
+        rgb[dst + 2] = f.pixel[src + 2];                                                            // Copying "b"...
+      }
+    }
+
+    snprintf (name, sizeof (name), "/frame_%08zu.ppm", f.step);                                     // Building file name...
+    file = fopen ((directory + name).c_str (), "wb");                                               // Opening file...
+
+    if(file == nullptr)
+    {
+      std::cout << "Error: unable to write " << directory + name << std::endl;                      // Printing message...
+      continue;
+    }
+
+    fprintf (file, "P6\n%d %d\n255\n", size_x, size_y);                                             // Writing PPM header...
+    fwrite (rgb.data (), 1, rgb.size (), file);                                                     // Writing PPM pixels...
+    fclose (file);                                                                                  // Closing file...
+    written++;                                                                                      // Counting frames...
+  }
+}
+
+inline capture::~capture ()
+{
+  double seconds;                                                                                   // Loop time [s].
+
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now () - start).count ();      // Getting loop time...
+
+  if(enabled)
+  {
+    while(pending > 0)
+    {
+      collect (true);                                                                               // Draining PBO ring...
+    }
+
+    {
+      std::unique_lock<std::mutex> lock (queue_mutex);                                              // Locking writer queue...
+      stop = true;                                                                                  // Stopping writer...
+      queue_cv.notify_one ();                                                                       // Waking up writer...
+    }
+
+    writer.join ();                                                                                 // Joining writer thread...
+    glDeleteBuffers (CAPTURE_RING, pbo);                                                            // Deleting PBOs...
+    glDeleteRenderbuffers (1, &color_rbo);                                                          // Deleting color renderbuffer...
+    glDeleteRenderbuffers (1, &depth_rbo);                                                          // Deleting depth renderbuffer...
+    glDeleteFramebuffers (1, &fbo);                                                                 // Deleting framebuffer...
+    std::cout << "Captured frames = " << written << ", dropped frames = " << dropped << std::endl;  // Printing message...
+  }
+
+  if(seconds > 0.0)
+  {
+    std::cout << "frames/s = " << step/seconds << " (capture " << (enabled ? "on" : "off") << ")"
+              << std::endl;                                                                         // Printing message...
+  }
+}
+}
+
+#endif
@@ -0,0 +1,226 @@
+/// @file     clhost.hpp
+/// @brief    Minimal raw OpenCL host context for the headless benchmark.
+///
+/// @details  The examples run their kernels through Neutrino, which owns the OpenCL context and
+/// builds the programs internally. The headless benchmark needs control over the platform, the
+/// device, the program builds and the NDRange, so it drives the same kernels through this small
+/// wrapper instead: platform/device selection, context, profiling queue and error checking. The
+/// examples use it too, on the context of a Neutrino kernel, to enqueue their step kernels with a
+/// tuned local size (see dispatch.hpp).
+
+#ifndef clhost_hpp
+#define clhost_hpp
+
+// INCLUDES:
+#ifndef CL_TARGET_OPENCL_VERSION
+  #define CL_TARGET_OPENCL_VERSION 120                                                              // Targeting OpenCL 1.2 API.
+#endif
+
+#ifdef __APPLE__
+  #include <OpenCL/cl.h>
+#else
+  #include <CL/cl.h>
+#endif
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ex
+{
+/// @brief **OpenCL error check.**
+/// @details Prints the failing call and its error code, then exits.
+inline void check (
+                   cl_int      loc_error,                                                           ///< OpenCL error code.
+                   std::string loc_call                                                             ///< Failing call description.
+                  )
+{
+  if(loc_error != CL_SUCCESS)
+  {
+    std::cout << "Error: " << loc_call << " failed (OpenCL error " << loc_error << ")." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+}
+
+/// @brief **Text file loader.**
+inline std::string load (
+                         std::string loc_path                                                       ///< File path.
+                        )
+{
+  std::ifstream     file (loc_path);                                                                // Input file.
+  std::stringstream text;                                                                           // File text.
+
+  if(!file)
+  {
+    std::cout << "Error: cannot open " << loc_path << "." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  text << file.rdbuf ();                                                                            // Reading file...
+
+  return text.str ();
+}
+
+/// @class clhost
+/// @brief OpenCL platform, device, context and queue.
+class clhost
+{
+private:
+  std::string platform_info (
+                             cl_platform_info loc_info                                              ///< Platform parameter.
+                            );
+
+public:
+  cl_platform_id   platform;                                                                        ///< Platform.
+  cl_device_id     device;                                                                          ///< Device.
+  cl_context       context;                                                                         ///< Context.
+  cl_command_queue queue;                                                                           ///< Profiling command queue.
+
+  /// @brief **Class constructor.**
+  /// @details Selects the first platform whose name contains loc_platform ("" = any, e.g.
+  /// "Portable" for pocl) and its loc_device-th device of type loc_type ("gpu", "cpu" or "all").
+  clhost (
+          std::string loc_platform,                                                                 ///< Platform name filter.
+          size_t      loc_device,                                                                   ///< Device index.
+          std::string loc_type                                                                      ///< Device type.
+         );
+
+  /// @brief **Class constructor.**
+  /// @details Adopts the context and (first) device of a kernel built elsewhere, e.g. by Neutrino,
+  /// and creates its own profiling queue on them.
+  clhost (
+          cl_kernel loc_kernel                                                                      ///< Built kernel.
+         );
+
+  /// @brief **Device parameter (string).**
+  std::string device_info (
+                           cl_device_info loc_info                                                  ///< Device parameter.
+                          );
+
+  /// @brief **Device description.**
+  /// @details "platform / device (driver version)", as printed in the reports.
+  std::string name ();
+
+  /// @brief **Class destructor.**
+  ~clhost ();
+};
+
+inline std::string clhost::platform_info (
+                                          cl_platform_info loc_info
+                                         )
+{
+  size_t            size;                                                                           // Parameter size.
+  std::vector<char> value;                                                                          // Parameter value.
+
+  check (clGetPlatformInfo (platform, loc_info, 0, nullptr, &size), "clGetPlatformInfo");           // Getting size...
+  value.resize (size);                                                                              // Sizing value...
+  check (clGetPlatformInfo (platform, loc_info, size, value.data (), nullptr), "clGetPlatformInfo"); // Getting value...
+
+  return std::string (value.data ());
+}
+
+inline std::string clhost::device_info (
+                                        cl_device_info loc_info
+                                       )
+{
+  size_t            size;                                                                           // Parameter size.
+  std::vector<char> value;                                                                          // Parameter value.
+
+  check (clGetDeviceInfo (device, loc_info, 0, nullptr, &size), "clGetDeviceInfo");                 // Getting size...
+  value.resize (size);                                                                              // Sizing value...
+  check (clGetDeviceInfo (device, loc_info, size, value.data (), nullptr), "clGetDeviceInfo");       // Getting value...
+
+  return std::string (value.data ());
+}
+
+inline clhost::clhost (
+                       std::string loc_platform,
+                       size_t      loc_device,
+                       std::string loc_type
+                      )
+{
+  cl_uint                     platforms;                                                            // Number of platforms.
+  cl_uint                     devices;                                                              // Number of devices.
+  std::vector<cl_platform_id> platform_list;                                                        // Platforms.
+  std::vector<cl_device_id>   device_list;                                                          // Devices.
+  cl_device_type              type = CL_DEVICE_TYPE_ALL;                                            // Device type.
+  cl_int                      error;                                                                // Error code.
+
+  if(loc_type == "gpu")
+  {
+    type = CL_DEVICE_TYPE_GPU;                                                                      // Selecting GPUs...
+  }
+
+  if(loc_type == "cpu")
+  {
+    type = CL_DEVICE_TYPE_CPU;                                                                      // Selecting CPUs...
+  }
+
+  check (clGetPlatformIDs (0, nullptr, &platforms), "clGetPlatformIDs");                            // Getting number of platforms...
+  platform_list.resize (platforms);                                                                 // Sizing platforms...
+  check (clGetPlatformIDs (platforms, platform_list.data (), nullptr), "clGetPlatformIDs");         // Getting platforms...
+  device = nullptr;                                                                                 // Resetting device...
+
+  for(cl_platform_id p : platform_list)
+  {
+    platform = p;                                                                                   // Setting platform...
+
+    if((platform_info (CL_PLATFORM_NAME).find (loc_platform) == std::string::npos) ||
+       (clGetDeviceIDs (platform, type, 0, nullptr, &devices) != CL_SUCCESS) ||
+       (loc_device >= devices))
+    {
+      continue;                                                                                     // Skipping platform...
+    }
+
+    device_list.resize (devices);                                                                   // Sizing devices...
+    check (clGetDeviceIDs (platform, type, devices, device_list.data (), nullptr), "clGetDeviceIDs"); // Getting devices...
+    device = device_list[loc_device];                                                               // Setting device...
+    break;
+  }
+
+  if(device == nullptr)
+  {
+    std::cout << "Error: no OpenCL device #" << loc_device << " of type \"" << loc_type
+              << "\" on a platform matching \"" << loc_platform << "\"." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  context = clCreateContext (nullptr, 1, &device, nullptr, nullptr, &error);                        // Creating context...
+  check (error, "clCreateContext");
+  queue   = clCreateCommandQueue (context, device, CL_QUEUE_PROFILING_ENABLE, &error);              // Creating queue...
+  check (error, "clCreateCommandQueue");
+}
+
+inline clhost::clhost (
+                       cl_kernel loc_kernel
+                      )
+{
+  cl_int error;                                                                                     // Error code.
+
+  check (clGetKernelInfo (loc_kernel, CL_KERNEL_CONTEXT, sizeof (context), &context, nullptr),
+         "clGetKernelInfo");                                                                        // Getting context...
+  check (clRetainContext (context), "clRetainContext");                                             // Retaining context...
+  check (clGetContextInfo (context, CL_CONTEXT_DEVICES, sizeof (device), &device, nullptr),
+         "clGetContextInfo");                                                                       // Getting (first) device...
+  check (clGetDeviceInfo (device, CL_DEVICE_PLATFORM, sizeof (platform), &platform, nullptr),
+         "clGetDeviceInfo");                                                                        // Getting platform...
+  queue = clCreateCommandQueue (context, device, CL_QUEUE_PROFILING_ENABLE, &error);                // Creating queue...
+  check (error, "clCreateCommandQueue");
+}
+
+inline std::string clhost::name ()
+{
+  return platform_info (CL_PLATFORM_NAME) + " / " + device_info (CL_DEVICE_NAME) + " (" +
+         device_info (CL_DRIVER_VERSION) + ")";
+}
+
+inline clhost::~clhost ()
+{
+  clReleaseCommandQueue (queue);                                                                    // Releasing queue...
+  clReleaseContext (context);                                                                       // Releasing context...
+}
+}
+
+#endif
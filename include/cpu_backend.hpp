@@ -0,0 +1,607 @@
+/// @file     cpu_backend.hpp
+/// @brief    Native multithreaded CPU backend for the lattice kernels.
+///
+/// @details  The OpenCL kernels are mirrored in C++ over the same CSR arrays (nearest, offset;
+/// 32-bit indices, implicit central node) and the same Neutrino host vectors. Nodes are split in
+/// contiguous chunks over a pool of persistent threads. Inside a chunk, nodes are processed four
+/// at a time across the SIMD lanes (SSE when available, scalar otherwise): soa4 holds the same
+/// component of four nodes in one register, so that all lanes do useful work (a float4 per
+/// register wastes the "w" lane and needs shuffles for every length). The neighbour loop of the
+/// four nodes runs over the longest of their strides, shorter ones padded with zero-length links.
+/// The remainder of a chunk (fewer than four nodes) runs on vec4, one node per register.
+
+#ifndef cpu_backend_hpp
+#define cpu_backend_hpp
+
+// INCLUDES:
+#include "nu.hpp"                                                                                   // Neutrino header file.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+  #define CPU_BACKEND_SSE                                                                           // SSE float4 arithmetic.
+  #include <xmmintrin.h>
+#endif
+
+#define CPU_BACKEND_LANES 4                                                                         // Nodes per SIMD register.
+
+namespace ex
+{
+/// @struct vec4
+/// @brief Four floats in one SIMD register, with the OpenCL "float4" arithmetic.
+struct vec4
+{
+#ifdef CPU_BACKEND_SSE
+  __m128 v;                                                                                         ///< Components.
+
+  vec4 () : v (_mm_setzero_ps ()) {}
+  vec4 (__m128 loc_v) : v (loc_v) {}
+  vec4 (float loc_x, float loc_y, float loc_z, float loc_w) : v (_mm_setr_ps (loc_x, loc_y, loc_z, loc_w)) {}
+  vec4 (const nu_float4_structure& loc_f) : v (_mm_loadu_ps (&loc_f.x)) {}
+
+  void  store (nu_float4_structure& loc_f) const {_mm_storeu_ps (&loc_f.x, v);}
+
+  vec4  operator + (const vec4& loc_b) const {return vec4 (_mm_add_ps (v, loc_b.v));}
+  vec4  operator - (const vec4& loc_b) const {return vec4 (_mm_sub_ps (v, loc_b.v));}
+  vec4  operator * (float loc_s) const {return vec4 (_mm_mul_ps (v, _mm_set1_ps (loc_s)));}
+  vec4  operator / (float loc_s) const {return vec4 (_mm_div_ps (v, _mm_set1_ps (loc_s)));}
+  vec4& operator += (const vec4& loc_b) {v = _mm_add_ps (v, loc_b.v); return *this;}
+
+  /// @brief Euclidean length of the "xyz" part.
+  float length3 () const
+  {
+    __m128 sq = _mm_mul_ps (v, v);                                                                 // Squaring components...
+
+    return std::sqrt (_mm_cvtss_f32 (sq) +
+                      _mm_cvtss_f32 (_mm_shuffle_ps (sq, sq, _MM_SHUFFLE (1, 1, 1, 1))) +
+                      _mm_cvtss_f32 (_mm_shuffle_ps (sq, sq, _MM_SHUFFLE (2, 2, 2, 2))));
+  }
+#else
+  float v[4];                                                                                       ///< Components.
+
+  vec4 () : v {0.0f, 0.0f, 0.0f, 0.0f} {}
+  vec4 (float loc_x, float loc_y, float loc_z, float loc_w) : v {loc_x, loc_y, loc_z, loc_w} {}
+  vec4 (const nu_float4_structure& loc_f) : v {loc_f.x, loc_f.y, loc_f.z, loc_f.w} {}
+
+  void  store (nu_float4_structure& loc_f) const {loc_f = {v[0], v[1], v[2], v[3]};}
+
+  vec4  operator + (const vec4& loc_b) const {return vec4 (v[0] + loc_b.v[0], v[1] + loc_b.v[1], v[2] + loc_b.v[2], v[3] + loc_b.v[3]);}
+  vec4  operator - (const vec4& loc_b) const {return vec4 (v[0] - loc_b.v[0], v[1] - loc_b.v[1], v[2] - loc_b.v[2], v[3] - loc_b.v[3]);}
+  vec4  operator * (float loc_s) const {return vec4 (v[0]*loc_s, v[1]*loc_s, v[2]*loc_s, v[3]*loc_s);}
+  vec4  operator / (float loc_s) const {return vec4 (v[0]/loc_s, v[1]/loc_s, v[2]/loc_s, v[3]/loc_s);}
+  vec4& operator += (const vec4& loc_b) {*this = *this + loc_b; return *this;}
+
+  /// @brief Euclidean length of the "xyz" part.
+  float length3 () const {return std::sqrt (v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);}
+#endif
+
+  /// @brief Returns a copy with the "w" component set (projective space fix).
+  vec4 with_w (
+               float loc_w                                                                          ///< "w" component.
+              ) const
+  {
+    nu_float4_structure f;                                                                          // Components.
+
+    store (f);                                                                                      // Storing components...
+    f.w = loc_w;                                                                                    // Setting "w"...
+
+    return vec4 (f);
+  }
+};
+
+inline vec4 operator * (
+                        float       loc_s,
+                        const vec4& loc_a
+                       )
+{
+  return loc_a*loc_s;
+}
+
+/// @struct lane4
+/// @brief One float of four consecutive nodes in one SIMD register (structure of arrays).
+struct lane4
+{
+#ifdef CPU_BACKEND_SSE
+  __m128 v;                                                                                         ///< Lanes.
+
+  lane4 () : v (_mm_setzero_ps ()) {}
+  lane4 (__m128 loc_v) : v (loc_v) {}
+  lane4 (float loc_s) : v (_mm_set1_ps (loc_s)) {}
+  lane4 (float loc_a, float loc_b, float loc_c, float loc_d) : v (_mm_setr_ps (loc_a, loc_b, loc_c, loc_d)) {}
+  explicit lane4 (const float* loc_f) : v (_mm_loadu_ps (loc_f)) {}
+
+  void   store (float* loc_f) const {_mm_storeu_ps (loc_f, v);}
+
+  lane4  operator + (const lane4& loc_b) const {return lane4 (_mm_add_ps (v, loc_b.v));}
+  lane4  operator - (const lane4& loc_b) const {return lane4 (_mm_sub_ps (v, loc_b.v));}
+  lane4  operator * (const lane4& loc_b) const {return lane4 (_mm_mul_ps (v, loc_b.v));}
+  lane4  operator / (const lane4& loc_b) const {return lane4 (_mm_div_ps (v, loc_b.v));}
+  lane4  operator - () const {return lane4 (_mm_sub_ps (_mm_setzero_ps (), v));}
+  lane4& operator += (const lane4& loc_b) {v = _mm_add_ps (v, loc_b.v); return *this;}
+
+  /// @brief Square root of each lane.
+  lane4  sqrt () const {return lane4 (_mm_sqrt_ps (v));}
+
+  /// @brief 1 where the lane is not smaller than loc_b, 0 elsewhere.
+  lane4  at_least (const lane4& loc_b) const {return lane4 (_mm_and_ps (_mm_cmpge_ps (v, loc_b.v), _mm_set1_ps (1.0f)));}
+
+  /// @brief Lanes of loc_a where the lane is not zero, lanes of loc_b elsewhere.
+  lane4  select (
+                 const lane4& loc_a,                                                                ///< Lanes if not zero.
+                 const lane4& loc_b                                                                 ///< Lanes if zero.
+                ) const
+  {
+    __m128 mask = _mm_cmpneq_ps (v, _mm_setzero_ps ());                                             // Computing lane mask...
+
+    return lane4 (_mm_or_ps (_mm_and_ps (mask, loc_a.v), _mm_andnot_ps (mask, loc_b.v)));
+  }
+#else
+  float v[4];                                                                                       ///< Lanes.
+
+  lane4 () : v {0.0f, 0.0f, 0.0f, 0.0f} {}
+  lane4 (float loc_s) : v {loc_s, loc_s, loc_s, loc_s} {}
+  lane4 (float loc_a, float loc_b, float loc_c, float loc_d) : v {loc_a, loc_b, loc_c, loc_d} {}
+  explicit lane4 (const float* loc_f) : v {loc_f[0], loc_f[1], loc_f[2], loc_f[3]} {}
+
+  void   store (float* loc_f) const {std::copy (v, v + 4, loc_f);}
+
+  lane4  operator + (const lane4& loc_b) const {return lane4 (v[0] + loc_b.v[0], v[1] + loc_b.v[1], v[2] + loc_b.v[2], v[3] + loc_b.v[3]);}
+  lane4  operator - (const lane4& loc_b) const {return lane4 (v[0] - loc_b.v[0], v[1] - loc_b.v[1], v[2] - loc_b.v[2], v[3] - loc_b.v[3]);}
+  lane4  operator * (const lane4& loc_b) const {return lane4 (v[0]*loc_b.v[0], v[1]*loc_b.v[1], v[2]*loc_b.v[2], v[3]*loc_b.v[3]);}
+  lane4  operator / (const lane4& loc_b) const {return lane4 (v[0]/loc_b.v[0], v[1]/loc_b.v[1], v[2]/loc_b.v[2], v[3]/loc_b.v[3]);}
+  lane4  operator - () const {return lane4 (-v[0], -v[1], -v[2], -v[3]);}
+  lane4& operator += (const lane4& loc_b) {*this = *this + loc_b; return *this;}
+
+  /// @brief Square root of each lane.
+  lane4  sqrt () const {return lane4 (std::sqrt (v[0]), std::sqrt (v[1]), std::sqrt (v[2]), std::sqrt (v[3]));}
+
+  /// @brief 1 where the lane is not smaller than loc_b, 0 elsewhere.
+  lane4  at_least (const lane4& loc_b) const
+  {
+    return lane4 (float (v[0] >= loc_b.v[0]), float (v[1] >= loc_b.v[1]), float (v[2] >= loc_b.v[2]), float (v[3] >= loc_b.v[3]));
+  }
+
+  /// @brief Lanes of loc_a where the lane is not zero, lanes of loc_b elsewhere.
+  lane4  select (
+                 const lane4& loc_a,                                                                ///< Lanes if not zero.
+                 const lane4& loc_b                                                                 ///< Lanes if zero.
+                ) const
+  {
+    return lane4 ((v[0] != 0.0f) ? loc_a.v[0] : loc_b.v[0], (v[1] != 0.0f) ? loc_a.v[1] : loc_b.v[1],
+                  (v[2] != 0.0f) ? loc_a.v[2] : loc_b.v[2], (v[3] != 0.0f) ? loc_a.v[3] : loc_b.v[3]);
+  }
+#endif
+};
+
+/// @struct soa4
+/// @brief The float4 of four consecutive nodes, transposed to one lane4 per component.
+/// @details The host arrays stay float4 per node (they are shared with OpenCL and OpenGL): four
+/// nodes are transposed in registers on load and back on store, so that every arithmetic
+/// instruction works on the same component of four nodes instead of the four components of one.
+struct soa4
+{
+  lane4 x;                                                                                          ///< "x" components.
+  lane4 y;                                                                                          ///< "y" components.
+  lane4 z;                                                                                          ///< "z" components.
+  lane4 w;                                                                                          ///< "w" components.
+
+  soa4 () {}
+  soa4 (const lane4& loc_x, const lane4& loc_y, const lane4& loc_z, const lane4& loc_w) : x (loc_x), y (loc_y), z (loc_z), w (loc_w) {}
+
+  /// @brief Gathers and transposes the float4 of four nodes.
+  soa4 (
+        const nu_float4_structure& loc_a,                                                           ///< Node 0.
+        const nu_float4_structure& loc_b,                                                           ///< Node 1.
+        const nu_float4_structure& loc_c,                                                           ///< Node 2.
+        const nu_float4_structure& loc_d                                                            ///< Node 3.
+       )
+  {
+#ifdef CPU_BACKEND_SSE
+    __m128 r0 = _mm_loadu_ps (&loc_a.x);                                                            // Loading node 0...
+    __m128 r1 = _mm_loadu_ps (&loc_b.x);                                                            // Loading node 1...
+    __m128 r2 = _mm_loadu_ps (&loc_c.x);                                                            // Loading node 2...
+    __m128 r3 = _mm_loadu_ps (&loc_d.x);                                                            // Loading node 3...
+
+    _MM_TRANSPOSE4_PS (r0, r1, r2, r3);                                                             // Transposing...
+    x = lane4 (r0);                                                                                 // Setting "x"...
+    y = lane4 (r1);                                                                                 // Setting "y"...
+    z = lane4 (r2);                                                                                 // Setting "z"...
+    w = lane4 (r3);                                                                                 // Setting "w"...
+#else
+    x = lane4 (loc_a.x, loc_b.x, loc_c.x, loc_d.x);                                                 // Setting "x"...
+    y = lane4 (loc_a.y, loc_b.y, loc_c.y, loc_d.y);                                                 // Setting "y"...
+    z = lane4 (loc_a.z, loc_b.z, loc_c.z, loc_d.z);                                                 // Setting "z"...
+    w = lane4 (loc_a.w, loc_b.w, loc_c.w, loc_d.w);                                                 // Setting "w"...
+#endif
+  }
+
+  /// @brief Transposes back and scatters the float4 of four nodes.
+  void store (
+              nu_float4_structure& loc_a,                                                           ///< Node 0.
+              nu_float4_structure& loc_b,                                                           ///< Node 1.
+              nu_float4_structure& loc_c,                                                           ///< Node 2.
+              nu_float4_structure& loc_d                                                            ///< Node 3.
+             ) const
+  {
+#ifdef CPU_BACKEND_SSE
+    __m128 r0 = x.v;                                                                                // Getting "x"...
+    __m128 r1 = y.v;                                                                                // Getting "y"...
+    __m128 r2 = z.v;                                                                                // Getting "z"...
+    __m128 r3 = w.v;                                                                                // Getting "w"...
+
+    _MM_TRANSPOSE4_PS (r0, r1, r2, r3);                                                             // Transposing...
+    _mm_storeu_ps (&loc_a.x, r0);                                                                   // Storing node 0...
+    _mm_storeu_ps (&loc_b.x, r1);                                                                   // Storing node 1...
+    _mm_storeu_ps (&loc_c.x, r2);                                                                   // Storing node 2...
+    _mm_storeu_ps (&loc_d.x, r3);                                                                   // Storing node 3...
+#else
+    loc_a = {x.v[0], y.v[0], z.v[0], w.v[0]};                                                       // Storing node 0...
+    loc_b = {x.v[1], y.v[1], z.v[1], w.v[1]};                                                       // Storing node 1...
+    loc_c = {x.v[2], y.v[2], z.v[2], w.v[2]};                                                       // Storing node 2...
+    loc_d = {x.v[3], y.v[3], z.v[3], w.v[3]};                                                       // Storing node 3...
+#endif
+  }
+
+  soa4  operator + (const soa4& loc_b) const {return soa4 (x + loc_b.x, y + loc_b.y, z + loc_b.z, w + loc_b.w);}
+  soa4  operator - (const soa4& loc_b) const {return soa4 (x - loc_b.x, y - loc_b.y, z - loc_b.z, w - loc_b.w);}
+  soa4  operator * (const lane4& loc_s) const {return soa4 (x*loc_s, y*loc_s, z*loc_s, w*loc_s);}
+  soa4  operator / (const lane4& loc_s) const {return soa4 (x/loc_s, y/loc_s, z/loc_s, w/loc_s);}
+  soa4& operator += (const soa4& loc_b) {*this = *this + loc_b; return *this;}
+
+  /// @brief Euclidean length of the "xyz" part of each node.
+  lane4 length3 () const {return (x*x + y*y + z*z).sqrt ();}
+
+  /// @brief Returns a copy with the "w" components set (projective space fix).
+  soa4  with_w (
+                const lane4& loc_w                                                                  ///< "w" components.
+               ) const
+  {
+    return soa4 (x, y, z, loc_w);
+  }
+};
+
+inline soa4 operator * (
+                        const lane4& loc_s,
+                        const soa4&  loc_a
+                       )
+{
+  return loc_a*loc_s;
+}
+
+/// @brief **Lane selection.**
+/// @details Nodes of loc_a where loc_flag is not zero, nodes of loc_b elsewhere.
+inline soa4 select (
+                    const lane4& loc_flag,                                                          ///< Lane flags.
+                    const soa4&  loc_a,                                                             ///< Nodes if not zero.
+                    const soa4&  loc_b                                                              ///< Nodes if zero.
+                   )
+{
+  return soa4 (loc_flag.select (loc_a.x, loc_b.x), loc_flag.select (loc_a.y, loc_b.y),
+               loc_flag.select (loc_a.z, loc_b.z), loc_flag.select (loc_a.w, loc_b.w));
+}
+
+/// @brief **Neighbour strides of four consecutive nodes.**
+/// @details CSR with implicit central nodes: sets the stride bounds of nodes loc_i...loc_i + 3
+/// and returns the longest stride, over which the neighbour loop of the four lanes runs (lanes
+/// with a shorter stride are padded with zero-length links).
+inline size_t strides (
+                       const nu::int1* loc_offset,                                                  ///< Offset.
+                       size_t          loc_i,                                                       ///< First node.
+                       size_t*         loc_min,                                                     ///< Stride minimum of each node.
+                       size_t*         loc_max                                                      ///< Stride maximum of each node.
+                      )
+{
+  size_t k;                                                                                         // Lane index.
+  size_t count = 0;                                                                                 // Longest stride.
+
+  for(k = 0; k < CPU_BACKEND_LANES; k++)
+  {
+    loc_min[k] = ((loc_i + k) == 0) ? 0 : loc_offset->data[loc_i + k - 1];                          // Setting stride minimum...
+    loc_max[k] = loc_offset->data[loc_i + k];                                                       // Setting stride maximum...
+    count      = std::max (count, loc_max[k] - loc_min[k]);                                         // Updating longest stride...
+  }
+
+  return count;
+}
+
+/// @class cpu_backend
+/// @brief Pool of persistent worker threads running a range of nodes in parallel.
+/// @details The range [0, n) is split in as many contiguous chunks as threads: the calling thread
+/// runs the first chunk, the workers the others, and run() returns when all of them are done.
+class cpu_backend
+{
+private:
+  std::vector<std::thread>                 worker;                                                  ///< Worker threads.
+  std::function<void (size_t, size_t)>     task;                                                    ///< Current task.
+  size_t                                   size;                                                    ///< Current range size.
+  size_t                                   generation;                                              ///< Task counter.
+  size_t                                   pending;                                                 ///< Workers still running.
+  bool                                     stop;                                                    ///< Stop flag.
+  std::mutex                               task_mutex;                                              ///< Task mutex.
+  std::condition_variable                  start_cv;                                                ///< Task start condition.
+  std::condition_variable                  done_cv;                                                 ///< Task done condition.
+
+  void work (
+             size_t loc_t                                                                           ///< Thread index.
+            );
+  void chunk (
+              size_t loc_t                                                                          ///< Thread index.
+             );
+
+public:
+  /// @brief **Class constructor.**
+  /// @details Starts the worker threads ("0" = one thread per hardware core).
+  cpu_backend (
+               size_t loc_threads                                                                   ///< Number of threads.
+              );
+
+  /// @brief **Parallel range.**
+  /// @details Calls loc_task (begin, end) on disjoint chunks covering [0, loc_size).
+  void   run (
+              size_t                               loc_size,                                        ///< Range size.
+              std::function<void (size_t, size_t)> loc_task                                         ///< Chunk task.
+             );
+
+  /// @brief **Number of threads.**
+  size_t threads ();
+
+  /// @brief **Class destructor.**
+  /// @details Stops and joins the worker threads.
+  ~cpu_backend ();
+};
+
+inline cpu_backend::cpu_backend (
+                                 size_t loc_threads
+                                )
+{
+  size_t t;                                                                                         // Thread index.
+
+  if(loc_threads == 0)
+  {
+    loc_threads = std::max (1u, std::thread::hardware_concurrency ());                              // Using all cores...
+  }
+
+  size       = 0;                                                                                   // Resetting range size...
+  generation = 0;                                                                                   // Resetting task counter...
+  pending    = 0;                                                                                   // Resetting pending workers...
+  stop       = false;                                                                               // Resetting stop flag...
+
+  for(t = 1; t < loc_threads; t++)
+  {
+    worker.emplace_back (&cpu_backend::work, this, t);                                              // Starting worker...
+  }
+}
+
+inline void cpu_backend::chunk (
+                                size_t loc_t
+                               )
+{
+  size_t count = worker.size () + 1;                                                                // Number of chunks.
+  size_t begin = size*loc_t/count;                                                                  // Chunk begin.
+  size_t end   = size*(loc_t + 1)/count;                                                            // Chunk end.
+
+  if(begin < end)
+  {
+    task (begin, end);                                                                              // Running chunk...
+  }
+}
+
+inline void cpu_backend::work (
+                               size_t loc_t
+                              )
+{
+  size_t seen = 0;                                                                                  // Last task run.
+
+  while(true)
+  {
+    std::unique_lock<std::mutex> lock (task_mutex);                                                 // Locking task...
+    start_cv.wait (lock, [&] {return stop || (generation != seen);});                               // Waiting for a new task...
+
+    if(stop)
+    {
+      return;
+    }
+
+    seen = generation;                                                                              // Taking task...
+    lock.unlock ();                                                                                 // Unlocking task...
+
+    chunk (loc_t);                                                                                  // Running chunk...
+
+    lock.lock ();                                                                                   // Locking task...
+
+    if(--pending == 0)
+    {
+      done_cv.notify_one ();                                                                        // Signalling completion...
+    }
+  }
+}
+
+inline void cpu_backend::run (
+                              size_t                               loc_size,
+                              std::function<void (size_t, size_t)> loc_task
+                             )
+{
+  {
+    std::lock_guard<std::mutex> lock (task_mutex);                                                  // Locking task...
+    task    = loc_task;                                                                             // Setting task...
+    size    = loc_size;                                                                             // Setting range size...
+    pending = worker.size ();                                                                       // Setting pending workers...
+    generation++;                                                                                   // Publishing task...
+  }
+
+  start_cv.notify_all ();                                                                           // Waking workers...
+  chunk (0);                                                                                        // Running first chunk...
+
+  std::unique_lock<std::mutex> lock (task_mutex);                                                   // Locking task...
+  done_cv.wait (lock, [&] {return pending == 0;});                                                  // Waiting for workers...
+}
+
+inline size_t cpu_backend::threads ()
+{
+  return worker.size () + 1;
+}
+
+inline cpu_backend::~cpu_backend ()
+{
+  {
+    std::lock_guard<std::mutex> lock (task_mutex);                                                  // Locking task...
+    stop = true;                                                                                    // Setting stop flag...
+  }
+
+  start_cv.notify_all ();                                                                           // Waking workers...
+
+  for(std::thread& w : worker)
+  {
+    w.join ();                                                                                      // Joining worker...
+  }
+}
+
+/// @brief **Relative difference between two float4 arrays.**
+/// @details Maximum "xyz" distance between corresponding entries, divided by the largest "xyz"
+/// length of the reference (or by 1 if smaller).
+inline float difference (
+                         const std::vector<nu_float4_structure>& loc_a,                             ///< Array.
+                         const std::vector<nu_float4_structure>& loc_reference                      ///< Reference array.
+                        )
+{
+  size_t i;                                                                                         // Index.
+  float  error = 0.0f;                                                                              // Maximum distance.
+  float  scale = 1.0f;                                                                              // Reference scale.
+
+  for(i = 0; i < loc_reference.size (); i++)
+  {
+    error = std::max (error, (vec4 (loc_a[i]) - vec4 (loc_reference[i])).length3 ());               // Updating distance...
+    scale = std::max (scale, vec4 (loc_reference[i]).length3 ());                                   // Updating scale...
+  }
+
+  return error/scale;
+}
+
+/// @brief **CPU scaling benchmark.**
+/// @details Runs loc_steps steps of the model with 1, 2, 4, ... threads up to the number of
+/// cores, printing steps/s and the speedup over one thread. The model state is restored after
+/// each run, so the benchmark does not alter the simulation.
+template <class model>
+void scaling (
+              model* loc_model,                                                                     ///< CPU model.
+              size_t loc_steps                                                                      ///< Steps per run.
+             )
+{
+  std::vector<std::vector<nu_float4_structure> > backup;                                            // State backup.
+  size_t                                          cores;                                            // Number of cores.
+  std::vector<size_t>                             count;                                            // Numbers of threads.
+  size_t                                          s;                                                // Index.
+  double                                          rate;                                             // Steps/s.
+  double                                          rate_1 = 0.0;                                     // Steps/s (1 thread).
+
+  for(std::vector<nu_float4_structure>* v : loc_model->state)
+  {
+    backup.push_back (*v);                                                                          // Backing up state...
+  }
+
+  cores = std::max (1u, std::thread::hardware_concurrency ());                                      // Getting number of cores...
+
+  for(s = 1; s <= cores; s *= 2)
+  {
+    count.push_back (s);                                                                            // Adding power of two...
+  }
+
+  if(count.back () != cores)
+  {
+    count.push_back (cores);                                                                        // Adding all cores...
+  }
+
+  for(size_t t : count)
+  {
+    cpu_backend pool (t);                                                                           // Thread pool.
+
+    auto        start = std::chrono::steady_clock::now ();                                          // Run start time.
+
+    for(s = 0; s < loc_steps; s++)
+    {
+      loc_model->step (&pool);                                                                      // Stepping...
+    }
+
+    rate = loc_steps/std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+
+    if(t == 1)
+    {
+      rate_1 = rate;                                                                                // Setting reference rate...
+    }
+
+    std::cout << "threads = " << t << ", steps/s = " << rate << ", speedup = " << rate/rate_1
+              << std::endl;                                                                         // Printing message...
+
+    for(s = 0; s < backup.size (); s++)
+    {
+      *loc_model->state[s] = backup[s];                                                             // Restoring state...
+    }
+  }
+}
+
+/// @brief **Cross-backend validation.**
+/// @details Runs loc_steps steps on the device (loc_device_step), reads the device state back
+/// into the host arrays (loc_device_read) and keeps it as reference; then restores the initial
+/// state and runs the same steps on the CPU backend. Returns "true" if the relative difference
+/// of every kinematic array is within loc_tolerance.
+template <class model>
+bool validate (
+               model*                 loc_model,                                                    ///< CPU model.
+               cpu_backend*           loc_cpu,                                                      ///< CPU backend.
+               size_t                 loc_steps,                                                    ///< Number of steps.
+               float                  loc_tolerance,                                                ///< Relative tolerance.
+               std::function<void ()> loc_device_step,                                              ///< Device step.
+               std::function<void ()> loc_device_read                                               ///< Device state readback.
+              )
+{
+  std::vector<std::vector<nu_float4_structure> > backup;                                            // Initial state.
+  std::vector<std::vector<nu_float4_structure> > reference;                                         // Device state.
+  size_t                                          s;                                                // Index.
+  float                                           error;                                            // Relative difference.
+  bool                                            passed = true;                                    // Validation flag.
+
+  for(std::vector<nu_float4_structure>* v : loc_model->state)
+  {
+    backup.push_back (*v);                                                                          // Backing up state...
+  }
+
+  for(s = 0; s < loc_steps; s++)
+  {
+    loc_device_step ();                                                                             // Stepping on device...
+  }
+
+  loc_device_read ();                                                                               // Reading device state...
+
+  for(s = 0; s < backup.size (); s++)
+  {
+    reference.push_back (*loc_model->state[s]);                                                     // Setting reference...
+    *loc_model->state[s] = backup[s];                                                               // Restoring state...
+  }
+
+  for(s = 0; s < loc_steps; s++)
+  {
+    loc_model->step (loc_cpu);                                                                      // Stepping on CPU...
+  }
+
+  for(s = 0; s < reference.size (); s++)
+  {
+    error  = difference (*loc_model->state[s], reference[s]);                                       // Computing difference...
+    passed = passed && (error <= loc_tolerance);                                                    // Checking tolerance...
+    std::cout << "state " << s << ": relative difference = " << error << std::endl;                 // Printing message...
+  }
+
+  std::cout << "validation (" << loc_steps << " steps, tolerance = " << loc_tolerance << "): "
+            << (passed ? "PASSED" : "FAILED") << std::endl;                                         // Printing message...
+
+  return passed;
+}
+}
+
+#endif
@@ -0,0 +1,130 @@
+/// @file     dispatch.hpp
+/// @brief    Tuned NDRange dispatch of Neutrino kernels.
+///
+/// @details  nu::kernel::build () takes only global sizes, and nu::opencl::execute () leaves the
+/// local size to the driver. The step kernels of the examples are therefore enqueued directly
+/// through their kernel_id, on a profiling queue of Neutrino's own context (see clhost.hpp), with
+/// the local size found by the autotuner (see autotune.hpp) and the global size padded up to a
+/// multiple of it. The kernels must be built with NODES defined as the number of nodes (see
+/// specialization.hpp), so that the padding work-items return at once. The local sizes are stored
+/// per device, program source and number of nodes in the benchmark's cache directory, so each
+/// kernel is tuned once. Like nu::WAIT, every dispatch waits for its kernel.
+
+#ifndef dispatch_hpp
+#define dispatch_hpp
+
+// INCLUDES:
+#include "nu.hpp"                                                                                   // Neutrino header file.
+#include "clhost.hpp"                                                                               // Raw OpenCL host context.
+#include "autotune.hpp"                                                                             // Work-group size autotuner.
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#define DISPATCH_CACHE   "neutrino_cache"                                                           // Tuning directory name (as the benchmark's).
+#define DISPATCH_REPEATS 10                                                                         // Timed runs per local size candidate.
+
+namespace ex
+{
+/// @class dispatch
+/// @brief Step kernel dispatch with tuned local sizes.
+class dispatch
+{
+private:
+  clhost*                       cl;                                                                 ///< OpenCL host context (Neutrino's context).
+  autotune*                     tuner;                                                              ///< Work-group size autotuner (nullptr = no tuning).
+  size_t                        nodes;                                                              ///< Number of nodes (global size before padding).
+  std::map<std::string, size_t> size;                                                               ///< Local size of each kernel (0 = driver default).
+
+public:
+  /// @brief **Class constructor.**
+  /// @details Adopts the OpenCL context of a built kernel. Without loc_tune every kernel keeps the
+  /// driver default local size.
+  dispatch (
+            nu::kernel* loc_kernel,                                                                 ///< Built kernel.
+            size_t      loc_nodes,                                                                  ///< Number of nodes.
+            bool        loc_tune                                                                    ///< Tuning flag.
+           );
+
+  /// @brief **Tuning function.**
+  /// @details Gets the local size of the kernel loc_name, from the tuning directory or by timing
+  /// it. The kernel runs on the current data: the caller must restore it afterwards. To be called
+  /// between cl->acquire () and cl->release (), after the kernel arguments have been set.
+  void tune (
+             nu::kernel* loc_kernel,                                                                ///< Built kernel.
+             std::string loc_name                                                                   ///< Kernel name.
+            );
+
+  /// @brief **Execution function.**
+  /// @details Runs the kernel with the local size tuned for loc_name (the driver default if none)
+  /// and waits for it. A rebuilt kernel keeps the local size of its name. To be called between
+  /// cl->acquire () and cl->release ().
+  void execute (
+                nu::kernel* loc_kernel,                                                             ///< Built kernel.
+                std::string loc_name                                                                ///< Kernel name.
+               );
+
+  /// @brief **Class destructor.**
+  ~dispatch ();
+};
+
+inline dispatch::dispatch (
+                           nu::kernel* loc_kernel,
+                           size_t      loc_nodes,
+                           bool        loc_tune
+                          )
+{
+  cl    = new clhost (loc_kernel->kernel_id);                                                       // Adopting Neutrino's context...
+  tuner = loc_tune ? new autotune ((std::filesystem::temp_directory_path ()/DISPATCH_CACHE).string (),
+                                   false, DISPATCH_REPEATS) : nullptr;                              // Creating autotuner...
+  nodes = loc_nodes;                                                                                // Setting number of nodes...
+}
+
+inline void dispatch::tune (
+                            nu::kernel* loc_kernel,
+                            std::string loc_name
+                           )
+{
+  cl_program        program;                                                                        // Kernel program.
+  size_t            length;                                                                         // Program source size.
+  std::vector<char> text;                                                                           // Program source.
+
+  if(tuner == nullptr)
+  {
+    size[loc_name] = 0;                                                                             // Keeping driver default...
+    return;
+  }
+
+  check (clGetKernelInfo (loc_kernel->kernel_id, CL_KERNEL_PROGRAM, sizeof (program), &program, nullptr),
+         "clGetKernelInfo");                                                                        // Getting program...
+  check (clGetProgramInfo (program, CL_PROGRAM_SOURCE, 0, nullptr, &length), "clGetProgramInfo");   // Getting source size...
+  text.resize (length + 1, '\0');                                                                   // Sizing source...
+  check (clGetProgramInfo (program, CL_PROGRAM_SOURCE, length, text.data (), nullptr),
+         "clGetProgramInfo");                                                                       // Getting source...
+  size[loc_name] = tuner->local (cl, loc_kernel->kernel_id, loc_name, std::string (text.data ()),
+                                 nodes);                                                            // Getting local size...
+}
+
+inline void dispatch::execute (
+                               nu::kernel* loc_kernel,
+                               std::string loc_name
+                              )
+{
+  size_t local  = size.count (loc_name) ? size[loc_name] : 0;                                       // Local size (0 = driver default).
+  size_t global = autotune::global (nodes, local);                                                  // Global size (padded).
+
+  check (clEnqueueNDRangeKernel (cl->queue, loc_kernel->kernel_id, 1, nullptr, &global,
+                                 (local == 0) ? nullptr : &local, 0, nullptr, nullptr),
+         "clEnqueueNDRangeKernel");                                                                 // Running kernel...
+  check (clFinish (cl->queue), "clFinish");                                                         // Waiting for kernel...
+}
+
+inline dispatch::~dispatch ()
+{
+  delete tuner;                                                                                     // Deleting autotuner...
+  delete cl;                                                                                        // Releasing queue and context...
+}
+}
+
+#endif
@@ -0,0 +1,201 @@
+/// @file     materials.hpp
+/// @brief    Per-group material table with compact material ids.
+///
+/// @details  Instead of a stiffness per link and a mass per node, the step kernels can read both
+/// from a small material table in constant memory (one float4 per material: node mass, link
+/// stiffness, damping), indexed by an 8-bit material id per link and per node. The ids are packed
+/// four to an int on the host and read as uchar by the kernels, which are built with
+/// "-DMATERIALS=<number of materials>". Materials are bound to Gmsh physical groups by a text file
+/// with one material per line: the group dimension and tag, followed by the material values of the
+/// example (see its README); empty lines and lines starting with "#" are skipped. Material 0 is the
+/// example's own material, given to the nodes outside every listed group. A node in several groups
+/// takes the material listed last, and a link the larger material id of its two nodes, so that both
+/// directions of a link have the same stiffness.
+
+#ifndef materials_hpp
+#define materials_hpp
+
+// INCLUDES:
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ex
+{
+/// @class materials
+/// @brief Material groups and material ids.
+class materials
+{
+public:
+  std::vector<int>                 dim;                                                             ///< Physical group dimension of each material.
+  std::vector<int>                 tag;                                                             ///< Physical group tag of each material.
+  std::vector<std::vector<float> > value;                                                           ///< Values of each material (as listed).
+  std::vector<unsigned char>       node;                                                            ///< Material id of each node.
+  std::vector<unsigned char>       link;                                                            ///< Material id of each link.
+
+  /// @brief **Class constructor.**
+  /// @details Reads the material file: each line must hold the group dimension, the group tag and
+  /// loc_values values. Exits with an error if the file cannot be read or is malformed, or if it
+  /// lists more than 255 materials. All nodes start with material 0.
+  materials (
+             std::string loc_file,                                                                  ///< Material file.
+             size_t      loc_values,                                                                ///< Number of values per material.
+             size_t      loc_nodes                                                                  ///< Number of nodes.
+            );
+
+  /// @brief **Number of materials.**
+  /// @details Returns the number of table rows (the listed materials and material 0).
+  size_t              size ();
+
+  /// @brief **Node marker.**
+  /// @details Gives material loc_id (1 = first listed material) to the nodes of loc_point (the
+  /// nodes of its physical group).
+  void                mark (
+                            const std::vector<int>& loc_point,                                      ///< Group nodes.
+                            size_t                  loc_id                                          ///< Material id.
+                           );
+
+  /// @brief **Link material.**
+  /// @details Sets the material of each link from the materials of its two nodes. The neighbour
+  /// lists must not be encoded yet (see topology.hpp).
+  void                connect (
+                               const std::vector<int>& loc_nearest,                                 ///< Neighbour indices.
+                               const std::vector<int>& loc_offset                                   ///< Neighbour offsets.
+                              );
+
+  /// @brief **Id packing.**
+  /// @details Returns the ids packed four to an int (in memory order, so that the kernels can read
+  /// the array as uchar), the last int padded with material 0.
+  static std::vector<int> pack (
+                                const std::vector<unsigned char>& loc_id                            ///< Material ids.
+                               );
+
+  /// @brief **Report function.**
+  /// @details Prints the number of materials and the memory of the ids, compared with a float per
+  /// link and per node.
+  void                report ();
+};
+
+inline materials::materials (
+                             std::string loc_file,
+                             size_t      loc_values,
+                             size_t      loc_nodes
+                            )
+{
+  std::ifstream      file (loc_file);                                                               // Material file.
+  std::string        line;                                                                          // File line.
+  std::vector<float> row;                                                                           // Material values.
+  int                group_dim;                                                                     // Group dimension.
+  int                group_tag;                                                                     // Group tag.
+  float              x;                                                                             // Material value.
+
+  if(!file)
+  {
+    std::cout << "Error: cannot read material file \"" << loc_file << "\"." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  while(std::getline (file, line))
+  {
+    std::istringstream fields (line);                                                               // Line fields.
+    size_t             first = line.find_first_not_of (" \t\r");                                    // First character [#].
+
+    if((first == std::string::npos) || (line[first] == '#'))
+    {
+      continue;                                                                                     // Skipping empty line or comment...
+    }
+
+    row.clear ();                                                                                   // Resetting values...
+
+    if(!(fields >> group_dim >> group_tag))
+    {
+      std::cout << "Error: bad material line \"" << line << "\" (dimension and tag expected)." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                     // Exiting...
+    }
+
+    while(fields >> x)
+    {
+      row.push_back (x);                                                                            // Reading value...
+    }
+
+    if(row.size () != loc_values)
+    {
+      std::cout << "Error: bad material line \"" << line << "\" (" << loc_values << " values expected)." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                     // Exiting...
+    }
+
+    dim.push_back (group_dim);                                                                      // Adding group dimension...
+    tag.push_back (group_tag);                                                                      // Adding group tag...
+    value.push_back (row);                                                                          // Adding material values...
+  }
+
+  if(value.empty () || (value.size () > 255))
+  {
+    std::cout << "Error: the material file must list 1 to 255 materials." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  node.assign (loc_nodes, 0);                                                                       // Setting material 0 to all nodes...
+}
+
+inline size_t materials::size ()
+{
+  return value.size () + 1;
+}
+
+inline void materials::mark (
+                             const std::vector<int>& loc_point,
+                             size_t                  loc_id
+                            )
+{
+  size_t i;                                                                                         // Index [#].
+
+  for(i = 0; i < loc_point.size (); i++)
+  {
+    node[loc_point[i]] = (unsigned char)(loc_id);                                                   // Setting node material...
+  }
+}
+
+inline void materials::connect (
+                                const std::vector<int>& loc_nearest,
+                                const std::vector<int>& loc_offset
+                               )
+{
+  size_t i;                                                                                         // Node index [#].
+  size_t j = 0;                                                                                     // Link index [#].
+
+  link.resize (loc_nearest.size ());                                                                // Sizing link materials...
+
+  for(i = 0; i < loc_offset.size (); i++)
+  {
+    for(; j < size_t (loc_offset[i]); j++)
+    {
+      link[j] = std::max (node[i], node[loc_nearest[j]]);                                           // Setting link material...
+    }
+  }
+}
+
+inline std::vector<int> materials::pack (
+                                         const std::vector<unsigned char>& loc_id
+                                        )
+{
+  std::vector<int> packed ((loc_id.size () + 3)/4, 0);                                              // Packed ids.
+
+  std::memcpy (packed.data (), loc_id.data (), loc_id.size ());                                     // Packing ids...
+
+  return packed;
+}
+
+inline void materials::report ()
+{
+  std::cout << "materials = " << size () << " (ids: " << (node.size () + link.size ())/1024.0 << " KiB, was "
+            << 4*(node.size () + link.size ())/1024.0 << " KiB)" << std::endl;                      // Printing materials...
+}
+}
+
+#endif
@@ -0,0 +1,254 @@
+/// @file     nodestate.hpp
+/// @brief    Node state arrays stored at the chosen precision, apart from the plotted arrays.
+///
+/// @details  The plotted arrays of the examples (color, position) are FP32 OpenGL buffers shared
+/// with OpenCL. The node state (position, velocity, acceleration and their intermediate values)
+/// is kept in separate arrays, stored as double4 or float4 according to the precision mode (see
+/// precision.hpp); the step kernel writes a float4 copy of each new position into the plotted
+/// array. Neutrino only has FP32 arrays: a state array stored in double is therefore allocated
+/// here, as a double4 OpenCL buffer in Neutrino's context, filled from the host data of its
+/// Neutrino array and set as kernel argument in its place, the same way as zerocopy.hpp replaces
+/// the plotted arrays. FP32 state arrays stay Neutrino's: for them every function is a no-op or
+/// calls Neutrino.
+
+#ifndef nodestate_hpp
+#define nodestate_hpp
+
+// INCLUDES:
+#include "nu.hpp"                                                                                   // Neutrino header file.
+#include "clhost.hpp"                                                                               // OpenCL error check.
+#include "precision.hpp"                                                                            // Compile-time precision.
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ex
+{
+/// @class nodestate
+/// @brief Node state arrays (double4 or float4).
+class nodestate
+{
+private:
+  /// @brief Double state array.
+  struct wide
+  {
+    size_t layout;                                                                                  ///< Layout index.
+    size_t size;                                                                                    ///< Number of vectors.
+    cl_mem buffer;                                                                                  ///< OpenCL buffer (double4).
+  };
+
+  cl_context        context;                                                                        ///< OpenCL context (Neutrino's).
+  cl_device_id      device;                                                                         ///< OpenCL device.
+  cl_command_queue  queue;                                                                          ///< Transfer queue.
+  std::vector<wide> array;                                                                          ///< Double state arrays.
+  size_t            narrow;                                                                         ///< FP32 state arrays [#].
+
+  wide* find (
+              size_t loc_layout                                                                     ///< Layout index.
+             );
+
+public:
+  /// @brief **Class constructor.**
+  /// @details Gets the OpenCL context and device from a built kernel. It must be called after
+  /// cl->write (), which creates the Neutrino arrays.
+  nodestate (
+             nu::kernel* loc_kernel                                                                 ///< Built kernel.
+            );
+
+  /// @brief **State array storage.**
+  /// @details With loc_double, allocates the state array at loc_layout as double4 and fills it
+  /// with loc_data (the host data of its Neutrino array); otherwise the Neutrino array is kept.
+  void store (
+              size_t                                  loc_layout,                                   ///< Layout index.
+              const std::vector<nu_float4_structure>& loc_data,                                     ///< Initial data.
+              bool                                    loc_double                                    ///< Double storage flag.
+             );
+
+  /// @brief **Kernel attachment.**
+  /// @details Sets the double state arrays as arguments of the kernels, replacing the Neutrino
+  /// buffers. To be called for all kernels again after cl->write (), which sets all the arguments.
+  void attach (
+               std::vector<nu::kernel*> loc_kernel                                                  ///< Kernels.
+              );
+
+  /// @brief **Array writer.**
+  /// @details Copies host data into a state array, widened to double if stored so; otherwise it
+  /// calls loc_cl->write (loc_layout).
+  void write (
+              nu::opencl*                             loc_cl,                                       ///< OpenCL context.
+              size_t                                  loc_layout,                                   ///< Layout index.
+              const std::vector<nu_float4_structure>& loc_data                                      ///< Host data.
+             );
+
+  /// @brief **Array reader.**
+  /// @details Copies a state array into host data, rounded to float if stored in double;
+  /// otherwise it calls loc_cl->read (loc_layout).
+  void read (
+             nu::opencl*                       loc_cl,                                              ///< OpenCL context.
+             size_t                            loc_layout,                                          ///< Layout index.
+             std::vector<nu_float4_structure>& loc_data                                             ///< Host data.
+            );
+
+  /// @brief **Storage report.**
+  /// @details Prints the number of state arrays stored in double and in float.
+  void report ();
+
+  /// @brief **Class destructor.**
+  /// @details Releases the double state arrays. It must be called before the OpenCL context is
+  /// deleted.
+  ~nodestate ();
+};
+
+inline nodestate::nodestate (
+                             nu::kernel* loc_kernel
+                            )
+{
+  cl_int error;                                                                                     // OpenCL error code.
+
+  narrow = 0;                                                                                       // Resetting FP32 arrays...
+  check (clGetKernelInfo (loc_kernel->kernel_id, CL_KERNEL_CONTEXT, sizeof (cl_context), &context, nullptr),
+         "clGetKernelInfo");                                                                        // Getting context...
+  check (clGetContextInfo (context, CL_CONTEXT_DEVICES, sizeof (cl_device_id), &device, nullptr),
+         "clGetContextInfo");                                                                       // Getting (first) device...
+  queue = clCreateCommandQueue (context, device, 0, &error);                                        // Creating transfer queue...
+  check (error, "clCreateCommandQueue");
+}
+
+inline nodestate::wide* nodestate::find (
+                                         size_t loc_layout
+                                        )
+{
+  for(wide& a : array)
+  {
+    if(a.layout == loc_layout)
+    {
+      return &a;
+    }
+  }
+
+  return nullptr;
+}
+
+inline void nodestate::store (
+                              size_t                                  loc_layout,
+                              const std::vector<nu_float4_structure>& loc_data,
+                              bool                                    loc_double
+                             )
+{
+  wide                        a;                                                                    // Double state array.
+  cl_int                      error;                                                                // OpenCL error code.
+  std::vector<real4<double> > data (loc_data.size ());                                              // Widened data.
+  size_t                      i;                                                                    // Node index [#].
+
+  if(!loc_double)
+  {
+    narrow++;                                                                                       // Keeping Neutrino array...
+    return;
+  }
+
+  for(i = 0; i < loc_data.size (); i++)
+  {
+    data[i] = {{loc_data[i].x, loc_data[i].y, loc_data[i].z, loc_data[i].w}};                       // Widening vector...
+  }
+
+  a.layout = loc_layout;                                                                            // Setting layout index...
+  a.size   = data.size ();                                                                          // Setting size...
+  a.buffer = clCreateBuffer (context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                             data.size ()*sizeof (real4<double>), data.data (), &error);            // Creating double buffer...
+  check (error, "clCreateBuffer");
+  array.push_back (a);                                                                              // Adding double state array...
+}
+
+inline void nodestate::attach (
+                               std::vector<nu::kernel*> loc_kernel
+                              )
+{
+  for(nu::kernel* K : loc_kernel)
+  {
+    for(wide& a : array)
+    {
+      check (clSetKernelArg (K->kernel_id, cl_uint (a.layout), sizeof (cl_mem), &a.buffer),
+             "clSetKernelArg");                                                                     // Replacing kernel argument...
+    }
+  }
+}
+
+inline void nodestate::write (
+                              nu::opencl*                             loc_cl,
+                              size_t                                  loc_layout,
+                              const std::vector<nu_float4_structure>& loc_data
+                             )
+{
+  wide*                       a = find (loc_layout);                                                // Double state array.
+  std::vector<real4<double> > data;                                                                 // Widened data.
+  size_t                      i;                                                                    // Node index [#].
+
+  if(a == nullptr)
+  {
+    loc_cl->write (loc_layout);                                                                     // Writing OpenCL data...
+    return;
+  }
+
+  data.resize (a->size);                                                                            // Sizing widened data...
+
+  for(i = 0; i < a->size; i++)
+  {
+    data[i] = {{loc_data[i].x, loc_data[i].y, loc_data[i].z, loc_data[i].w}};                       // Widening vector...
+  }
+
+  check (clEnqueueWriteBuffer (queue, a->buffer, CL_TRUE, 0, a->size*sizeof (real4<double>), data.data (), 0,
+                               nullptr, nullptr), "clEnqueueWriteBuffer");                          // Writing double state...
+}
+
+inline void nodestate::read (
+                             nu::opencl*                       loc_cl,
+                             size_t                            loc_layout,
+                             std::vector<nu_float4_structure>& loc_data
+                            )
+{
+  wide*                       a = find (loc_layout);                                                // Double state array.
+  std::vector<real4<double> > data;                                                                 // Double data.
+  size_t                      i;                                                                    // Node index [#].
+
+  if(a == nullptr)
+  {
+    loc_cl->read (loc_layout);                                                                      // Reading OpenCL data...
+    return;
+  }
+
+  data.resize (a->size);                                                                            // Sizing double data...
+  check (clEnqueueReadBuffer (queue, a->buffer, CL_TRUE, 0, a->size*sizeof (real4<double>), data.data (), 0,
+                              nullptr, nullptr), "clEnqueueReadBuffer");                            // Reading double state...
+
+  for(i = 0; i < a->size; i++)
+  {
+    loc_data[i] = {float (data[i].s[0]), float (data[i].s[1]), float (data[i].s[2]), float (data[i].s[3])}; // Rounding vector...
+  }
+}
+
+inline void nodestate::report ()
+{
+  size_t bytes = 0;                                                                                 // Double state size [B].
+
+  for(wide& a : array)
+  {
+    bytes += a.size*sizeof (real4<double>);                                                         // Adding array size...
+  }
+
+  std::cout << "node state = " << array.size () << " arrays in double4 (" << 1e-6*bytes << " MB), "
+            << narrow << " in float4" << std::endl;                                                 // Printing message...
+}
+
+inline nodestate::~nodestate ()
+{
+  for(wide& a : array)
+  {
+    clReleaseMemObject (a.buffer);                                                                  // Releasing double state array...
+  }
+
+  clReleaseCommandQueue (queue);                                                                    // Releasing transfer queue...
+}
+}
+
+#endif
@@ -0,0 +1,121 @@
+/// @file     options.hpp
+/// @brief    Command line options shared by the examples.
+///
+/// @details  Options are given as "--name value" pairs or as "--name" flags, e.g.:
+/// `cloth --capture frames --every 10 --headless --steps 5000`
+
+#ifndef options_hpp
+#define options_hpp
+
+// INCLUDES:
+#include <cstdlib>
+#include <map>
+#include <string>
+
+namespace ex
+{
+/// @class options
+/// @brief Command line options.
+/// @details A token starting with "--" is an option name: if the following token does not start
+/// with "--" it is taken as its value, otherwise the option is a flag.
+class options
+{
+private:
+  std::map<std::string, std::string> value;                                                         ///< Option values.
+
+public:
+  /// @brief **Class constructor.**
+  /// @details Parses the command line arguments.
+  options (
+           int    loc_argc,                                                                         ///< Number of arguments.
+           char** loc_argv                                                                          ///< Arguments.
+          );
+
+  /// @brief **Flag query.**
+  /// @details Returns "true" if the option has been given on the command line.
+  bool        flag (
+                    std::string loc_name                                                            ///< Option name.
+                   );
+
+  /// @brief **Integer option getter.**
+  size_t      get (
+                   std::string loc_name,                                                            ///< Option name.
+                   size_t      loc_default                                                          ///< Default value.
+                  );
+
+  /// @brief **Float option getter.**
+  float       get (
+                   std::string loc_name,                                                            ///< Option name.
+                   float       loc_default                                                          ///< Default value.
+                  );
+
+  /// @brief **String option getter.**
+  std::string get (
+                   std::string loc_name,                                                            ///< Option name.
+                   std::string loc_default                                                          ///< Default value.
+                  );
+};
+
+inline options::options (
+                         int    loc_argc,
+                         char** loc_argv
+                        )
+{
+  int         i;                                                                                    // Argument index.
+  std::string name;                                                                                 // Option name.
+
+  for(i = 1; i < loc_argc; i++)
+  {
+    name = loc_argv[i];                                                                             // Getting token...
+
+    if(name.rfind ("--", 0) != 0)
+    {
+      continue;                                                                                     // Skipping stray values...
+    }
+
+    name = name.substr (2);                                                                         // Stripping "--"...
+
+    if((i + 1 < loc_argc) && (std::string (loc_argv[i + 1]).rfind ("--", 0) != 0))
+    {
+      value[name] = loc_argv[++i];                                                                  // Setting option value...
+    }
+    else
+    {
+      value[name] = "1";                                                                            // Setting flag...
+    }
+  }
+}
+
+inline bool options::flag (
+                           std::string loc_name
+                          )
+{
+  return value.count (loc_name) > 0;
+}
+
+inline size_t options::get (
+                            std::string loc_name,
+                            size_t      loc_default
+                           )
+{
+  return flag (loc_name) ? std::strtoull (value[loc_name].c_str (), nullptr, 10) : loc_default;
+}
+
+inline float options::get (
+                           std::string loc_name,
+                           float       loc_default
+                          )
+{
+  return flag (loc_name) ? std::strtof (value[loc_name].c_str (), nullptr) : loc_default;
+}
+
+inline std::string options::get (
+                                 std::string loc_name,
+                                 std::string loc_default
+                                )
+{
+  return flag (loc_name) ? value[loc_name] : loc_default;
+}
+}
+
+#endif
@@ -0,0 +1,189 @@
+/// @file     precision.hpp
+/// @brief    Compile-time precision of the node state and of the force accumulation.
+///
+/// @details  The step kernels are built with "-DPRECISION=<mode>" (see precision.cl): in single
+/// mode (default) everything is FP32, in mixed mode positions and accumulated forces are computed
+/// in double and everything else in float, in double mode everything is computed in double. The
+/// storage of the node state follows the mode as well: positions are stored as double4 in mixed
+/// and double modes, the other kinematic arrays in double mode only, through containers of real4<T>
+/// with the layout of cl_float4 (T = float) or cl_double4 (T = double). The interactive examples
+/// store it the same way (see nodestate.hpp) and plot a float4 copy of the positions, written by
+/// the step kernel, as OpenGL only shares FP32 arrays. Any mode but single needs "cl_khr_fp64".
+
+#ifndef precision_hpp
+#define precision_hpp
+
+// INCLUDES:
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ex
+{
+/// @brief Precision modes (value of PRECISION in the kernels).
+enum precision_mode
+{
+  SINGLE_PRECISION = 0,                                                                             ///< FP32 arithmetic and storage.
+  MIXED_PRECISION  = 1,                                                                             ///< FP64 positions and forces, FP32 otherwise.
+  DOUBLE_PRECISION = 2                                                                              ///< FP64 arithmetic and storage.
+};
+
+/// @brief Real 4-vector with the layout of cl_float4 (T = float) or cl_double4 (T = double).
+template <class T>
+struct real4
+{
+  T s[4];                                                                                           ///< Components.
+};
+
+/// @class precision
+/// @brief Precision mode and node array storage.
+class precision
+{
+public:
+  precision_mode mode;                                                                              ///< Precision mode.
+  bool           position;                                                                          ///< Double position storage flag.
+  bool           state;                                                                             ///< Double kinematic storage flag.
+
+  /// @brief **Class constructor.**
+  /// @details The mode is "single" (default), "mixed" or "double". loc_widen tells whether the
+  /// node state may be stored in double (false keeps every array FP32, whatever the mode).
+  precision (
+             std::string loc_mode,                                                                  ///< Precision mode.
+             bool        loc_widen                                                                  ///< Double storage flag.
+            );
+
+  /// @brief **Mode name.**
+  /// @details Returns "single", "mixed" or "double".
+  std::string name ();
+
+  /// @brief **Build options.**
+  /// @details Returns " -DPRECISION=<mode>" and the storage defines (POSITION_DOUBLE,
+  /// STATE_DOUBLE) to be appended to the build options of every kernel reading the node state.
+  std::string defines ();
+
+  /// @brief **Device check.**
+  /// @details Exits with an error if the mode needs double precision and loc_extensions (the
+  /// device extension string) lacks "cl_khr_fp64".
+  void        check (
+                     std::string loc_extensions                                                     ///< Device extensions.
+                    );
+
+  /// @brief **Node array conversion.**
+  /// @details Returns a copy of loc_data (any array of 4-vectors with an "s" member) with scalar T.
+  template <class T, class V>
+  static std::vector<real4<T> > convert (
+                                         const std::vector<V>& loc_data                             ///< Node array.
+                                        );
+
+  /// @brief **Position unpacking.**
+  /// @details Returns the raw bytes of a position array, stored in float4 or double4 according to
+  /// the position storage flag, as x, y, z triplets in double.
+  std::vector<double> unpack (
+                              const std::vector<unsigned char>& loc_bytes                           ///< Position array bytes.
+                             );
+};
+
+inline precision::precision (
+                             std::string loc_mode,
+                             bool        loc_widen
+                            )
+{
+  if(loc_mode == "single")
+  {
+    mode = SINGLE_PRECISION;                                                                        // Setting single precision...
+  }
+  else if(loc_mode == "mixed")
+  {
+    mode = MIXED_PRECISION;                                                                         // Setting mixed precision...
+  }
+  else if(loc_mode == "double")
+  {
+    mode = DOUBLE_PRECISION;                                                                        // Setting double precision...
+  }
+  else
+  {
+    std::cout << "Error: unknown precision \"" << loc_mode << "\" (single, mixed or double)." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  position = loc_widen && (mode != SINGLE_PRECISION);                                               // Setting position storage...
+  state    = loc_widen && (mode == DOUBLE_PRECISION);                                               // Setting kinematic storage...
+}
+
+inline std::string precision::name ()
+{
+  return (mode == SINGLE_PRECISION) ? "single" : (mode == MIXED_PRECISION) ? "mixed" : "double";
+}
+
+inline std::string precision::defines ()
+{
+  return " -DPRECISION=" + std::to_string (int (mode)) + (position ? " -DPOSITION_DOUBLE" : "") +
+         (state ? " -DSTATE_DOUBLE" : "");
+}
+
+inline void precision::check (
+                              std::string loc_extensions
+                             )
+{
+  if((mode != SINGLE_PRECISION) && (loc_extensions.find ("cl_khr_fp64") == std::string::npos))
+  {
+    std::cout << "Error: " << name () << " precision needs a device with cl_khr_fp64." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+}
+
+template <class T, class V>
+inline std::vector<real4<T> > precision::convert (
+                                                  const std::vector<V>& loc_data
+                                                 )
+{
+  std::vector<real4<T> > data (loc_data.size ());                                                   // Converted array.
+  size_t                 i;                                                                         // Node index [#].
+  size_t                 k;                                                                         // Component index [#].
+
+  for(i = 0; i < loc_data.size (); i++)
+  {
+    for(k = 0; k < 4; k++)
+    {
+      data[i].s[k] = T (loc_data[i].s[k]);                                                          // Converting component...
+    }
+  }
+
+  return data;
+}
+
+inline std::vector<double> precision::unpack (
+                                              const std::vector<unsigned char>& loc_bytes
+                                             )
+{
+  size_t              size = position ? sizeof (real4<double>) : sizeof (real4<float>);             // Vector size [B].
+  std::vector<double> xyz (3*(loc_bytes.size ()/size));                                             // Positions.
+  real4<double>       p_double;                                                                     // Double position.
+  real4<float>        p_float;                                                                      // Float position.
+  size_t              i;                                                                            // Node index [#].
+  size_t              k;                                                                            // Component index [#].
+
+  for(i = 0; i < xyz.size ()/3; i++)
+  {
+    if(position)
+    {
+      std::memcpy (&p_double, loc_bytes.data () + i*size, size);                                    // Getting double position...
+    }
+    else
+    {
+      std::memcpy (&p_float, loc_bytes.data () + i*size, size);                                     // Getting float position...
+    }
+
+    for(k = 0; k < 3; k++)
+    {
+      xyz[3*i + k] = position ? p_double.s[k] : double (p_float.s[k]);                              // Widening component...
+    }
+  }
+
+  return xyz;
+}
+}
+
+#endif
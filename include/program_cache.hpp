@@ -0,0 +1,219 @@
+/// @file     program_cache.hpp
+/// @brief    Persistent on-disk cache of OpenCL program binaries.
+///
+/// @details  A program is identified by a 64-bit FNV-1a hash of its sources, its build options,
+/// the platform, the device name and version and the driver version. On a hit the binary is
+/// loaded with clCreateProgramWithBinary and only linked; on a miss (or if the binary is rejected,
+/// e.g. after a driver update) the program is built from source and its binary is stored as
+/// `<directory>/<key>.bin` for the next run. Only the benchmark builds through it: the examples'
+/// programs are built from source by Neutrino at every start.
+
+#ifndef program_cache_hpp
+#define program_cache_hpp
+
+// INCLUDES:
+#include "clhost.hpp"                                                                               // Raw OpenCL host context.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace ex
+{
+/// @brief **Text hash.**
+/// @details 64-bit FNV-1a hash of loc_text, as 16 hexadecimal digits.
+inline std::string hash (
+                         std::string loc_text                                                       ///< Text.
+                        )
+{
+  std::uint64_t h = 14695981039346656037ull;                                                        // FNV-1a offset basis.
+  char          hex[17];                                                                            // Hexadecimal hash.
+
+  for(unsigned char c : loc_text)
+  {
+    h ^= c;                                                                                         // Mixing byte...
+    h *= 1099511628211ull;                                                                          // Multiplying by FNV prime...
+  }
+
+  std::snprintf (hex, sizeof (hex), "%016llx", (unsigned long long)h);                              // Printing hash...
+
+  return std::string (hex);
+}
+
+/// @brief **Program source.**
+/// @details Concatenates the source files, in order, as Neutrino's addsource does.
+inline std::string source (
+                           std::vector<std::string> loc_files                                       ///< Source files.
+                          )
+{
+  std::string text;                                                                                 // Program source.
+
+  for(std::string f : loc_files)
+  {
+    text += load (f) + "\n";                                                                        // Appending source file...
+  }
+
+  return text;
+}
+
+/// @class program_cache
+/// @brief OpenCL program builder with an on-disk binary cache.
+class program_cache
+{
+private:
+  std::string directory;                                                                            ///< Cache directory ("" = disabled).
+
+  std::string key (
+                   clhost*     loc_cl,                                                              ///< OpenCL host context.
+                   std::string loc_source,                                                          ///< Program source.
+                   std::string loc_options                                                          ///< Build options.
+                  );
+
+public:
+  size_t hits;                                                                                      ///< Programs loaded from the cache.
+  size_t misses;                                                                                    ///< Programs built from source.
+  double time;                                                                                      ///< Total build time [ms].
+
+  /// @brief **Class constructor.**
+  /// @details Creates the cache directory if needed ("" = cache disabled).
+  program_cache (
+                 std::string loc_directory                                                          ///< Cache directory.
+                );
+
+  /// @brief **Program builder.**
+  /// @details Returns the program built from the source files, from the cache when possible.
+  cl_program build (
+                    clhost*                  loc_cl,                                                ///< OpenCL host context.
+                    std::vector<std::string> loc_files,                                             ///< Source files.
+                    std::string              loc_options                                            ///< Build options.
+                   );
+
+  /// @brief **Cache state.**
+  /// @details "warm" if every program came from the cache, "cold" otherwise.
+  std::string state ();
+};
+
+inline program_cache::program_cache (
+                                     std::string loc_directory
+                                    )
+{
+  directory = loc_directory;                                                                        // Setting cache directory...
+  hits      = 0;                                                                                    // Resetting hits...
+  misses    = 0;                                                                                    // Resetting misses...
+  time      = 0.0;                                                                                  // Resetting build time...
+
+  if(directory != "")
+  {
+    std::filesystem::create_directories (directory);                                                // Creating cache directory...
+  }
+}
+
+inline std::string program_cache::key (
+                                       clhost*     loc_cl,
+                                       std::string loc_source,
+                                       std::string loc_options
+                                      )
+{
+  return hash (loc_source + '\0' + loc_options + '\0' + loc_cl->name () + '\0' +
+               loc_cl->device_info (CL_DEVICE_VERSION));
+}
+
+inline cl_program program_cache::build (
+                                        clhost*                  loc_cl,
+                                        std::vector<std::string> loc_files,
+                                        std::string              loc_options
+                                       )
+{
+  auto                       start = std::chrono::steady_clock::now ();                             // Build start time.
+  std::string                source;                                                                // Program source.
+  std::string                path;                                                                  // Cache file path.
+  std::vector<unsigned char> binary;                                                                // Program binary.
+  const unsigned char*       binary_pointer;                                                        // Program binary pointer.
+  const char*                source_pointer;                                                        // Program source pointer.
+  size_t                     size;                                                                  // Program binary size.
+  cl_program                 program = nullptr;                                                     // Program.
+  cl_int                     status;                                                                // Binary status.
+  cl_int                     error;                                                                 // Error code.
+  std::vector<char>          log;                                                                   // Build log.
+
+  source = ex::source (loc_files);                                                                  // Loading program source...
+
+  if(directory != "")
+  {
+    path = (std::filesystem::path (directory)/(key (loc_cl, source, loc_options) + ".bin")).string ();
+    std::ifstream file (path, std::ios::binary);                                                    // Cache file.
+
+    if(file)
+    {
+      binary.assign (std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> ());     // Reading binary...
+      binary_pointer = binary.data ();                                                              // Setting binary pointer...
+      size           = binary.size ();                                                              // Setting binary size...
+      program        = clCreateProgramWithBinary (loc_cl->context, 1, &loc_cl->device, &size,
+                                                  &binary_pointer, &status, &error);                // Loading binary...
+
+      if((error != CL_SUCCESS) || (status != CL_SUCCESS) ||
+         (clBuildProgram (program, 1, &loc_cl->device, loc_options.c_str (), nullptr, nullptr) != CL_SUCCESS))
+      {
+        if(program != nullptr)
+        {
+          clReleaseProgram (program);                                                               // Releasing rejected binary...
+        }
+
+        program = nullptr;                                                                          // Falling back to source...
+      }
+    }
+  }
+
+  if(program != nullptr)
+  {
+    hits++;                                                                                         // Counting hit...
+  }
+  else
+  {
+    source_pointer = source.c_str ();                                                               // Setting source pointer...
+    program        = clCreateProgramWithSource (loc_cl->context, 1, &source_pointer, nullptr, &error);
+    check (error, "clCreateProgramWithSource");
+
+    if(clBuildProgram (program, 1, &loc_cl->device, loc_options.c_str (), nullptr, nullptr) != CL_SUCCESS)
+    {
+      clGetProgramBuildInfo (program, loc_cl->device, CL_PROGRAM_BUILD_LOG, 0, nullptr, &size);     // Getting log size...
+      log.resize (size);                                                                            // Sizing log...
+      clGetProgramBuildInfo (program, loc_cl->device, CL_PROGRAM_BUILD_LOG, size, log.data (), nullptr);
+      std::cout << "Error: program build failed:" << std::endl << log.data () << std::endl;
+      std::exit (EXIT_FAILURE);                                                                     // Exiting...
+    }
+
+    misses++;                                                                                       // Counting miss...
+
+    if(directory != "")
+    {
+      check (clGetProgramInfo (program, CL_PROGRAM_BINARY_SIZES, sizeof (size), &size, nullptr),
+             "clGetProgramInfo");                                                                   // Getting binary size...
+      binary.resize (size);                                                                         // Sizing binary...
+      binary_pointer = binary.data ();                                                              // Setting binary pointer...
+      check (clGetProgramInfo (program, CL_PROGRAM_BINARIES, sizeof (binary_pointer), &binary_pointer,
+                               nullptr), "clGetProgramInfo");                                       // Getting binary...
+
+      std::ofstream file (path + ".tmp", std::ios::binary);                                         // Cache file (temporary).
+      file.write ((const char*)binary.data (), binary.size ());                                     // Writing binary...
+      file.close ();                                                                                // Closing file...
+      std::filesystem::rename (path + ".tmp", path);                                                // Publishing binary...
+    }
+  }
+
+  time += std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start).count ();
+
+  return program;
+}
+
+inline std::string program_cache::state ()
+{
+  return (misses == 0) ? "warm" : "cold";
+}
+}
+
+#endif
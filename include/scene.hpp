@@ -0,0 +1,273 @@
+/// @file     scene.hpp
+/// @brief    Scene of mesh instances batched into one set of neighbour lists.
+///
+/// @details  A scene is a list of instances, each one a Gmsh mesh (.msh, or .stl through Gmsh)
+/// with its own transform: uniform scale, rotation about "x", "y" then "z" and translation. Each
+/// distinct mesh file is loaded and processed once; its nodes are transformed for every instance
+/// and appended to the scene, and its neighbour lists are appended with their node indices and
+/// offsets shifted by the nodes and links of the instances before it. The concatenation is again
+/// a Neutrino CSR neighbour list (implicit central nodes), so the whole scene is processed by one
+/// kernel dispatch over all the nodes and drawn by one draw call over all the links. The first
+/// node and the first link of each instance are kept as offset tables. Scene file: one instance
+/// per line, "FILE X Y Z [SCALE [AX AY AZ]]" (angles in degrees), FILE relative to the scene
+/// file; empty lines and lines starting with "#" are skipped.
+
+#ifndef scene_hpp
+#define scene_hpp
+
+// INCLUDES:
+#include "nu.hpp"                                                                                   // Neutrino header file.
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define SCENE_DEGREE 0.017453292519943295f                                                          // Degree [rad].
+
+namespace ex
+{
+/// @class scene
+/// @brief Mesh instances and their concatenated node positions and neighbour lists.
+class scene
+{
+public:
+  std::vector<std::string>          file;                                                           ///< Mesh file of each instance.
+  std::vector<std::vector<float> >  transform;                                                      ///< Transform of each instance (x, y, z, scale, ax, ay, az).
+  std::vector<nu_float4_structure>  position;                                                       ///< Node positions [m].
+  std::vector<GLint>                neighbour;                                                      ///< Neighbour indices.
+  std::vector<GLint>                offset;                                                         ///< Neighbour offsets.
+  std::vector<GLint>                node_start;                                                     ///< First node of each instance (and total).
+  std::vector<GLint>                link_start;                                                     ///< First link of each instance (and total).
+  size_t                            meshes;                                                         ///< Number of distinct meshes.
+  size_t                            elements;                                                       ///< Number of elements (all instances).
+  size_t                            groups;                                                         ///< Number of groups (all instances).
+
+  /// @brief **Class constructor.**
+  /// @details Creates an empty scene.
+  scene ();
+
+  /// @brief **Instance adder.**
+  /// @details Adds an instance of the mesh loc_file with the transform loc_transform (x, y, z,
+  /// scale, ax, ay, az).
+  void   add (
+              std::string        loc_file,                                                          ///< Mesh file.
+              std::vector<float> loc_transform                                                      ///< Instance transform.
+             );
+
+  /// @brief **Scene reader.**
+  /// @details Adds the instances listed in the scene file loc_file. Exits with an error if the
+  /// file cannot be read or is malformed.
+  void   read (
+               std::string loc_file                                                                 ///< Scene file.
+              );
+
+  /// @brief **Scene loader.**
+  /// @details Loads and processes each distinct mesh once (loc_tag, loc_dim, loc_type, as for a
+  /// single nu::mesh), then concatenates the transformed instances. Exits with an error if the
+  /// nodes of a mesh are not numbered 0...N-1.
+  void   load (
+               int           loc_tag,                                                               ///< Surface tag.
+               int           loc_dim,                                                               ///< Surface dimension.
+               nu::mesh_type loc_type                                                               ///< Element type.
+              );
+
+  /// @brief **Number of instances.**
+  size_t instances ();
+
+  /// @brief **Report function.**
+  /// @details Prints the number of instances and distinct meshes, and the batched sizes.
+  void   report ();
+};
+
+inline scene::scene ()
+{
+  meshes   = 0;                                                                                     // Resetting number of meshes...
+  elements = 0;                                                                                     // Resetting number of elements...
+  groups   = 0;                                                                                     // Resetting number of groups...
+}
+
+inline void scene::add (
+                        std::string        loc_file,
+                        std::vector<float> loc_transform
+                       )
+{
+  file.push_back (loc_file);                                                                        // Adding mesh file...
+  transform.push_back (loc_transform);                                                              // Adding transform...
+}
+
+inline void scene::read (
+                         std::string loc_file
+                        )
+{
+  std::ifstream         input (loc_file);                                                           // Scene file.
+  std::filesystem::path home = std::filesystem::path (loc_file).parent_path ();                     // Scene directory.
+  std::string           line;                                                                       // File line.
+  std::string           name;                                                                       // Mesh file.
+  std::vector<float>    row;                                                                        // Transform values (as listed).
+  std::vector<float>    t;                                                                          // Instance transform.
+  float                 x;                                                                          // Transform value.
+
+  if(!input)
+  {
+    std::cout << "Error: cannot read scene file \"" << loc_file << "\"." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  while(std::getline (input, line))
+  {
+    std::istringstream fields (line);                                                               // Line fields.
+    size_t             first = line.find_first_not_of (" \t\r");                                    // First character [#].
+
+    if((first == std::string::npos) || (line[first] == '#'))
+    {
+      continue;                                                                                     // Skipping empty line or comment...
+    }
+
+    row.clear ();                                                                                   // Resetting values...
+    fields >> name;                                                                                 // Reading mesh file...
+
+    while(fields >> x)
+    {
+      row.push_back (x);                                                                            // Reading value...
+    }
+
+    if(!fields.eof () || ((row.size () != 3) && (row.size () != 4) && (row.size () != 7)))
+    {
+      std::cout << "Error: bad scene line \"" << line << "\" (FILE X Y Z [SCALE [AX AY AZ]])." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                     // Exiting...
+    }
+
+    t = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f};                                                 // Setting identity transform...
+    std::copy (row.begin (), row.end (), t.begin ());                                               // Setting listed values...
+    add ((home/name).string (), t);                                                                 // Adding instance...
+  }
+
+  if(file.empty ())
+  {
+    std::cout << "Error: the scene file lists no instance." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+}
+
+inline void scene::load (
+                         int           loc_tag,
+                         int           loc_dim,
+                         nu::mesh_type loc_type
+                        )
+{
+  std::vector<std::string>                       name;                                              // Distinct mesh files.
+  std::vector<std::vector<nu_float4_structure> > mesh_position;                                     // Node positions of each mesh.
+  std::vector<std::vector<GLint> >               mesh_neighbour;                                    // Neighbour indices of each mesh.
+  std::vector<std::vector<GLint> >               mesh_offset;                                       // Neighbour offsets of each mesh.
+  std::vector<size_t>                            mesh_elements;                                     // Number of elements of each mesh.
+  std::vector<size_t>                            mesh_groups;                                       // Number of groups of each mesh.
+  nu::mesh*                                      obj;                                               // Mesh.
+  size_t                                         i;                                                 // Instance index [#].
+  size_t                                         m;                                                 // Mesh index [#].
+  size_t                                         n;                                                 // Node index [#].
+  size_t                                         j;                                                 // Link index [#].
+  float                                          c[3];                                              // Rotation cosines.
+  float                                          s[3];                                              // Rotation sines.
+  float                                          p[3];                                              // Transformed position [m].
+  float                                          q;                                                 // Rotated coordinate [m].
+
+  for(i = 0; i < file.size (); i++)
+  {
+    // LOADING MESH (once per distinct file):
+    m = std::find (name.begin (), name.end (), file[i]) - name.begin ();                            // Finding mesh...
+
+    if(m == name.size ())
+    {
+      obj = new nu::mesh (file[i]);                                                                 // Loading mesh...
+      obj->process (loc_tag, loc_dim, loc_type);                                                    // Processing mesh...
+
+      if((obj->node_coordinates.size () != obj->node.size ()) || (obj->neighbour_offset.size () != obj->node.size ()))
+      {
+        std::cout << "Error: one position and one neighbour offset per node expected in \"" << file[i] << "\"."
+                  << std::endl;
+        std::exit (EXIT_FAILURE);                                                                   // Exiting...
+      }
+
+      for(n = 0; n < obj->node.size (); n++)
+      {
+        if(obj->node[n] != GLint (n))
+        {
+          std::cout << "Error: mesh nodes must be numbered 0...N-1 (implicit central nodes) in \""
+                    << file[i] << "\"." << std::endl;
+          std::exit (EXIT_FAILURE);                                                                 // Exiting...
+        }
+      }
+
+      name.push_back (file[i]);                                                                     // Adding mesh file...
+      mesh_position.push_back (obj->node_coordinates);                                              // Adding node positions...
+      mesh_neighbour.push_back (obj->neighbour);                                                    // Adding neighbour indices...
+      mesh_offset.push_back (obj->neighbour_offset);                                                // Adding neighbour offsets...
+      mesh_elements.push_back (obj->element.size ());                                               // Adding number of elements...
+      mesh_groups.push_back (obj->group.size ());                                                   // Adding number of groups...
+      delete obj;                                                                                   // Deleting mesh...
+    }
+
+    // APPENDING INSTANCE (transformed nodes, shifted neighbour lists):
+    node_start.push_back (GLint (position.size ()));                                                // Setting first node...
+    link_start.push_back (GLint (neighbour.size ()));                                               // Setting first link...
+    elements += mesh_elements[m];                                                                   // Counting elements...
+    groups   += mesh_groups[m];                                                                     // Counting groups...
+
+    for(size_t d = 0; d < 3; d++)
+    {
+      c[d] = std::cos (transform[i][4 + d]*SCENE_DEGREE);                                           // Computing rotation cosine...
+      s[d] = std::sin (transform[i][4 + d]*SCENE_DEGREE);                                           // Computing rotation sine...
+    }
+
+    for(n = 0; n < mesh_position[m].size (); n++)
+    {
+      p[0] = transform[i][3]*mesh_position[m][n].x;                                                 // Scaling "x"...
+      p[1] = transform[i][3]*mesh_position[m][n].y;                                                 // Scaling "y"...
+      p[2] = transform[i][3]*mesh_position[m][n].z;                                                 // Scaling "z"...
+      q    = c[0]*p[1] - s[0]*p[2];                                                                 // Rotating about "x"...
+      p[2] = s[0]*p[1] + c[0]*p[2];                                                                 // Rotating about "x"...
+      p[1] = q;                                                                                     // Rotating about "x"...
+      q    = c[1]*p[0] + s[1]*p[2];                                                                 // Rotating about "y"...
+      p[2] = c[1]*p[2] - s[1]*p[0];                                                                 // Rotating about "y"...
+      p[0] = q;                                                                                     // Rotating about "y"...
+      q    = c[2]*p[0] - s[2]*p[1];                                                                 // Rotating about "z"...
+      p[1] = s[2]*p[0] + c[2]*p[1];                                                                 // Rotating about "z"...
+      p[0] = q;                                                                                     // Rotating about "z"...
+      position.push_back ({p[0] + transform[i][0], p[1] + transform[i][1], p[2] + transform[i][2],
+                           mesh_position[m][n].w});                                                 // Adding node position...
+    }
+
+    for(j = 0; j < mesh_neighbour[m].size (); j++)
+    {
+      neighbour.push_back (mesh_neighbour[m][j] + node_start[i]);                                   // Adding neighbour index...
+    }
+
+    for(n = 0; n < mesh_offset[m].size (); n++)
+    {
+      offset.push_back (mesh_offset[m][n] + link_start[i]);                                         // Adding neighbour offset...
+    }
+  }
+
+  node_start.push_back (GLint (position.size ()));                                                  // Setting total nodes...
+  link_start.push_back (GLint (neighbour.size ()));                                                 // Setting total links...
+  meshes = name.size ();                                                                            // Setting number of meshes...
+}
+
+inline size_t scene::instances ()
+{
+  return file.size ();
+}
+
+inline void scene::report ()
+{
+  std::cout << "scene = " << instances () << " instances of " << meshes << " meshes (" << position.size ()
+            << " nodes, " << neighbour.size () << " links)" << std::endl;                           // Printing scene...
+}
+}
+
+#endif
@@ -0,0 +1,216 @@
+/// @file     sell.hpp
+/// @brief    Sliced ELLPACK (SELL-C-sigma) neighbour layout.
+///
+/// @details  In the CSR layout the links of a node are contiguous, so that neighbouring work-items
+/// read the link arrays at unrelated strides and loop over different numbers of links. In the
+/// SELL-C-sigma layout the nodes are grouped in slices of C consecutive nodes, and the links of a
+/// slice are stored column-major: the c-th link of the lane-th node of a slice is at slot
+/// start + c*C + lane, so that the C work-items of a slice read C consecutive slots at each step of
+/// their loop. Each slice is padded to its longest stride: to keep the padding low, the nodes are
+/// sorted by decreasing degree within windows of sigma nodes (sigma = C: no sorting across slices).
+/// Sorting renumbers the nodes, hence node arrays are permuted and neighbour indices relabelled.
+/// The offset array holds, for each slice, its first slot followed by the degrees of its C nodes
+/// (C + 1 integers per slice): kernels built with "-DSELL=C" walk the links of node "i" from
+/// offset[(i/C)*(C + 1)] + i%C in steps of C. Neighbour indices are 32-bit (see topology.hpp).
+
+#ifndef sell_hpp
+#define sell_hpp
+
+// INCLUDES:
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace ex
+{
+/// @class sell
+/// @brief Sliced ELLPACK neighbour layout.
+class sell
+{
+public:
+  size_t           height;                                                                          ///< Slice height "C" [#].
+  size_t           window;                                                                          ///< Sorting window "sigma" [#].
+  size_t           links;                                                                           ///< Number of links [#].
+  std::vector<int> order;                                                                           ///< Former index of each node.
+  std::vector<int> rank;                                                                            ///< New index of each former node.
+  std::vector<int> slot;                                                                            ///< Former link of each slot (-1 = padding).
+  std::vector<int> offset;                                                                          ///< First slot and node degrees of each slice.
+
+  /// @brief **Class constructor.**
+  /// @details Sorts the nodes and lays out the slices of a CSR neighbour list.
+  sell (
+        size_t                  loc_height,                                                         ///< Slice height "C" [#].
+        size_t                  loc_window,                                                         ///< Sorting window "sigma" [#].
+        const std::vector<int>& loc_offset                                                          ///< Neighbour offsets (CSR).
+       );
+
+  /// @brief **Node array permutation.**
+  template <class T>
+  void        nodes (
+                     std::vector<T>& loc_data                                                       ///< Node array.
+                    );
+
+  /// @brief **Link array permutation.**
+  /// @details Moves each link to its slot; padding slots are zeroed (they are never read).
+  template <class T>
+  void        edges (
+                     std::vector<T>& loc_data                                                       ///< Link array.
+                    );
+
+  /// @brief **Neighbour relabelling.**
+  /// @details Moves each neighbour index to its slot and renumbers it.
+  void        relabel (
+                       std::vector<int>& loc_nearest                                                ///< Neighbour indices.
+                      );
+
+  /// @brief **Layout name.**
+  /// @details Returns "sell-C-sigma".
+  std::string name ();
+
+  /// @brief **Layout report.**
+  /// @details Prints the layout and its padding (slots per link).
+  void        report ();
+};
+
+inline sell::sell (
+                  size_t                  loc_height,
+                  size_t                  loc_window,
+                  const std::vector<int>& loc_offset
+                 )
+{
+  size_t           nodes  = loc_offset.size ();                                                     // Number of nodes.
+  size_t           slices;                                                                          // Number of slices.
+  size_t           start  = 0;                                                                      // First slot of slice.
+  size_t           width;                                                                           // Slice width (longest stride) [#].
+  size_t           n;                                                                               // Former node index.
+  size_t           j_min;                                                                           // Former stride minimum index.
+  std::vector<int> degree (nodes);                                                                  // Former node degrees.
+
+  if((loc_height == 0) || (loc_window%loc_height != 0))
+  {
+    std::cout << "Error: the SELL window must be a multiple of the slice height." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  height = loc_height;                                                                              // Setting slice height...
+  window = loc_window;                                                                              // Setting sorting window...
+  links  = (nodes == 0) ? 0 : size_t (loc_offset[nodes - 1]);                                       // Getting number of links...
+  slices = (nodes + height - 1)/height;                                                             // Getting number of slices...
+
+  for(size_t i = 0; i < nodes; i++)
+  {
+    degree[i] = loc_offset[i] - ((i == 0) ? 0 : loc_offset[i - 1]);                                 // Getting node degree...
+  }
+
+  // SORTING NODES BY DECREASING DEGREE (within windows):
+  order.resize (nodes);                                                                             // Sizing node order...
+  std::iota (order.begin (), order.end (), 0);                                                      // Setting identity order...
+
+  for(size_t i = 0; i < nodes; i += window)
+  {
+    std::stable_sort (order.begin () + i, order.begin () + std::min (i + window, nodes),
+                      [&degree] (int a, int b) {return degree[a] > degree[b];});                    // Sorting window...
+  }
+
+  rank.resize (nodes);                                                                              // Sizing node rank...
+
+  for(size_t i = 0; i < nodes; i++)
+  {
+    rank[order[i]] = int (i);                                                                       // Setting new node index...
+  }
+
+  // LAYING OUT SLICES (column-major):
+  offset.assign (slices*(height + 1), 0);                                                           // Sizing slice table...
+
+  for(size_t s = 0; s < slices; s++)
+  {
+    width = 0;                                                                                      // Resetting slice width...
+
+    for(size_t l = 0; (l < height) && (s*height + l < nodes); l++)
+    {
+      width                           = std::max (width, size_t (degree[order[s*height + l]]));     // Getting slice width...
+      offset[s*(height + 1) + 1 + l] = degree[order[s*height + l]];                                 // Setting node degree...
+    }
+
+    offset[s*(height + 1)] = int (start);                                                           // Setting first slot of slice...
+    slot.resize (start + width*height, -1);                                                         // Sizing slots (padding)...
+
+    for(size_t l = 0; (l < height) && (s*height + l < nodes); l++)
+    {
+      n     = size_t (order[s*height + l]);                                                         // Getting former node...
+      j_min = (n == 0) ? 0 : size_t (loc_offset[n - 1]);                                            // Getting former stride minimum...
+
+      for(size_t c = 0; c < size_t (degree[n]); c++)
+      {
+        slot[start + c*height + l] = int (j_min + c);                                               // Setting link slot...
+      }
+    }
+
+    start += width*height;                                                                          // Moving to next slice...
+  }
+}
+
+template <class T>
+inline void sell::nodes (
+                         std::vector<T>& loc_data
+                        )
+{
+  std::vector<T> permuted (loc_data.size ());                                                       // Permuted array.
+
+  for(size_t i = 0; i < order.size (); i++)
+  {
+    permuted[i] = loc_data[order[i]];                                                               // Moving node...
+  }
+
+  loc_data = permuted;                                                                              // Setting permuted array...
+}
+
+template <class T>
+inline void sell::edges (
+                         std::vector<T>& loc_data
+                        )
+{
+  std::vector<T> permuted (slot.size (), T ());                                                     // Permuted array (zeroed padding).
+
+  for(size_t j = 0; j < slot.size (); j++)
+  {
+    if(slot[j] >= 0)
+    {
+      permuted[j] = loc_data[slot[j]];                                                              // Moving link...
+    }
+  }
+
+  loc_data = permuted;                                                                              // Setting permuted array...
+}
+
+inline void sell::relabel (
+                          std::vector<int>& loc_nearest
+                         )
+{
+  edges (loc_nearest);                                                                              // Moving neighbour indices...
+
+  for(size_t j = 0; j < slot.size (); j++)
+  {
+    if(slot[j] >= 0)
+    {
+      loc_nearest[j] = rank[loc_nearest[j]];                                                        // Renumbering neighbour...
+    }
+  }
+}
+
+inline std::string sell::name ()
+{
+  return "sell-" + std::to_string (height) + "-" + std::to_string (window);
+}
+
+inline void sell::report ()
+{
+  std::cout << "layout = " << name () << ", " << slot.size () << " slots for " << links << " links ("
+            << 100.0*double (slot.size () - links)/double (std::max (links, size_t (1))) << "% padding)" << std::endl; // Printing padding...
+}
+}
+
+#endif
@@ -0,0 +1,392 @@
+/// @file     snapshot.hpp
+/// @brief    Lock-free shared-memory ring of simulation snapshots (server/viewer).
+///
+/// @details  A server process publishes the node positions and the link colors into a named
+/// shared-memory ring of slots; any number of viewer processes attach to it, copy the latest
+/// complete frame and detach, without ever blocking the server. Each slot is guarded by a sequence
+/// number (seqlock): the server makes it odd before writing the slot and even again afterwards,
+/// then advances the latest frame counter. A viewer copies the slot of the latest frame and keeps
+/// the copy only if the sequence was the same even value before and after it; otherwise the slot
+/// was overwritten meanwhile and it simply tries the new latest frame. Shared memory layout:
+/// - header: magic (0 once the server has stopped), nodes, links, slots, slot size [B] and the
+///   number of published frames;
+/// - slots: sequence, step, positions (float4 per node) and colors (float4 per link).
+
+#ifndef snapshot_hpp
+#define snapshot_hpp
+
+// INCLUDES:
+#include "nu.hpp"                                                                                   // Neutrino header file.
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef WIN32
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#define SNAPSHOT_SLOTS 4                                                                            // Number of slots in the ring.
+#define SNAPSHOT_MAGIC 0x3130504E53554EULL                                                          // Ring magic ("NUSNP01").
+#define SNAPSHOT_ALIGN 64                                                                           // Slot alignment [B].
+
+namespace ex
+{
+/// @class snapshot
+/// @brief Shared-memory snapshot ring.
+class snapshot
+{
+private:
+  /// @brief Ring header.
+  struct header
+  {
+    std::atomic<uint64_t> magic;                                                                    ///< Ring magic (0 = server stopped).
+    uint64_t              nodes;                                                                    ///< Number of nodes.
+    uint64_t              links;                                                                    ///< Number of links.
+    uint64_t              slots;                                                                    ///< Number of slots.
+    uint64_t              slot_bytes;                                                               ///< Slot size [B].
+    std::atomic<uint64_t> frames;                                                                   ///< Published frames.
+  };
+
+  /// @brief Slot header (followed by positions and colors).
+  struct slot
+  {
+    std::atomic<uint64_t> sequence;                                                                 ///< Seqlock sequence (odd = being written).
+    uint64_t              step;                                                                     ///< Simulation step.
+  };
+
+  std::string                           name;                                                       ///< Shared memory name.
+  bool                                  server;                                                     ///< Server flag.
+  size_t                                bytes;                                                      ///< Shared memory size [B].
+  unsigned char*                        base;                                                       ///< Shared memory mapping.
+  header*                               head;                                                       ///< Ring header.
+  uint64_t                              seen;                                                       ///< Last frame copied (viewer).
+  size_t                                copied;                                                     ///< Frames published or shown.
+  size_t                                skipped;                                                    ///< Frames skipped or retried.
+  std::chrono::steady_clock::time_point start;                                                      ///< Start time.
+#ifdef WIN32
+  HANDLE                                mapping;                                                    ///< File mapping.
+#endif
+
+  inline static volatile std::sig_atomic_t interrupted = 0;                                         ///< Server interrupt flag.
+
+  static void   on_signal (
+                           int loc_signal                                                           ///< Signal.
+                          );
+  static size_t header_bytes ();
+  slot*         at (
+                    uint64_t loc_frame                                                              ///< Frame.
+                   );
+  void          map (
+                     size_t loc_bytes                                                               ///< Shared memory size [B].
+                    );
+
+public:
+  /// @brief **Class constructor.**
+  /// @details The server (loc_server = "true") creates the ring for loc_nodes nodes and loc_links
+  /// links, replacing a stale one with the same name. A viewer attaches to an existing ring and
+  /// checks that it was published for the same numbers of nodes and links.
+  snapshot (
+            std::string loc_name,                                                                   ///< Ring name.
+            bool        loc_server,                                                                 ///< Server flag.
+            size_t      loc_nodes,                                                                  ///< Number of nodes.
+            size_t      loc_links                                                                   ///< Number of links.
+           );
+
+  /// @brief **Snapshot publisher (server).**
+  /// @details Writes one frame into the next slot; it never waits for the viewers.
+  void publish (
+                size_t                                  loc_step,                                   ///< Simulation step.
+                const std::vector<nu_float4_structure>& loc_position,                               ///< Positions [m].
+                const std::vector<nu_float4_structure>& loc_color                                   ///< Colors [].
+               );
+
+  /// @brief **Snapshot fetcher (viewer).**
+  /// @details Copies the latest complete frame; returns "false" if there is no new frame.
+  bool fetch (
+              std::vector<nu_float4_structure>& loc_position,                                       ///< Positions [m].
+              std::vector<nu_float4_structure>& loc_color                                           ///< Colors [].
+             );
+
+  /// @brief **Server state.**
+  /// @details Returns "false" once the server has stopped.
+  bool alive ();
+
+  /// @brief **Server interrupt.**
+  /// @details Returns "true" once the server has got SIGINT or SIGTERM, so that it can leave its
+  /// loop and remove the ring.
+  bool interrupt ();
+
+  /// @brief **Ring report.**
+  /// @details Prints the frames published (server) or shown and skipped (viewer) per second.
+  void report ();
+
+  /// @brief **Class destructor.**
+  /// @details Detaches from the ring; the server also marks it as stopped and removes it.
+  ~snapshot ();
+};
+
+inline void snapshot::on_signal (
+                                 int loc_signal
+                                )
+{
+  interrupted = loc_signal;                                                                         // Flagging interrupt...
+}
+
+inline size_t snapshot::header_bytes ()
+{
+  return (sizeof (header) + SNAPSHOT_ALIGN - 1)/SNAPSHOT_ALIGN*SNAPSHOT_ALIGN;
+}
+
+inline snapshot::slot* snapshot::at (
+                                     uint64_t loc_frame
+                                    )
+{
+  return (slot*)(base + header_bytes () + (loc_frame%head->slots)*head->slot_bytes);
+}
+
+inline void snapshot::map (
+                           size_t loc_bytes
+                          )
+{
+#ifdef WIN32
+  std::string path = "Local\\nu_" + name;                                                           // Mapping name.
+
+  if(server)
+  {
+    mapping = CreateFileMappingA (INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, DWORD (uint64_t (loc_bytes) >> 32),
+                                  DWORD (loc_bytes), path.c_str ());                                // Creating mapping...
+  }
+  else
+  {
+    mapping = OpenFileMappingA (FILE_MAP_READ, FALSE, path.c_str ());                               // Opening mapping...
+  }
+
+  base = (mapping == nullptr) ? nullptr : (unsigned char*)MapViewOfFile (mapping, server ? FILE_MAP_ALL_ACCESS :
+                                                                         FILE_MAP_READ, 0, 0, loc_bytes); // Mapping view...
+#else
+  std::string path = "/nu_" + name;                                                                 // Shared memory name.
+  int         fd;                                                                                   // Shared memory descriptor.
+  struct stat info;                                                                                 // Shared memory size.
+  void*       view;                                                                                 // Mapping.
+
+  if(server)
+  {
+    shm_unlink (path.c_str ());                                                                     // Removing stale ring...
+    fd = shm_open (path.c_str (), O_CREAT | O_EXCL | O_RDWR, 0600);                                 // Creating shared memory...
+
+    if((fd >= 0) && (ftruncate (fd, off_t (loc_bytes)) != 0))
+    {
+      close (fd);                                                                                   // Closing descriptor...
+      fd = -1;                                                                                      // Flagging failure...
+    }
+  }
+  else
+  {
+    fd = shm_open (path.c_str (), O_RDONLY, 0);                                                     // Opening shared memory...
+
+    if((fd >= 0) && (fstat (fd, &info) == 0))
+    {
+      loc_bytes = size_t (info.st_size);                                                            // Getting shared memory size...
+    }
+  }
+
+  view = (fd < 0) ? MAP_FAILED : mmap (nullptr, loc_bytes, server ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                                       MAP_SHARED, fd, 0);                                          // Mapping shared memory...
+  base = (view == MAP_FAILED) ? nullptr : (unsigned char*)view;                                     // Setting mapping...
+
+  if(fd >= 0)
+  {
+    close (fd);                                                                                     // Closing descriptor (mapping kept)...
+  }
+#endif
+
+  bytes = loc_bytes;                                                                                // Setting size...
+
+  if(base == nullptr)
+  {
+    std::cout << "Error: cannot " << (server ? "create" : "open") << " snapshot ring \"" << name << "\""
+              << (server ? "." : " (is the server running?).") << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+}
+
+inline snapshot::snapshot (
+                           std::string loc_name,
+                           bool        loc_server,
+                           size_t      loc_nodes,
+                           size_t      loc_links
+                          )
+{
+  size_t slot_bytes;                                                                                // Slot size [B].
+
+  name       = loc_name;                                                                            // Setting name...
+  server     = loc_server;                                                                          // Setting server flag...
+  seen       = 0;                                                                                   // Resetting last frame...
+  copied     = 0;                                                                                   // Resetting frame counter...
+  skipped    = 0;                                                                                   // Resetting frame counter...
+  slot_bytes = (sizeof (slot) + (loc_nodes + loc_links)*sizeof (nu_float4_structure) + SNAPSHOT_ALIGN - 1)/
+               SNAPSHOT_ALIGN*SNAPSHOT_ALIGN;                                                       // Computing slot size...
+  map (header_bytes () + SNAPSHOT_SLOTS*slot_bytes);                                                // Mapping shared memory...
+  head       = (header*)base;                                                                       // Setting header...
+
+  if(server)
+  {
+    new (head) header;                                                                              // Constructing header...
+    head->nodes      = loc_nodes;                                                                   // Setting number of nodes...
+    head->links      = loc_links;                                                                   // Setting number of links...
+    head->slots      = SNAPSHOT_SLOTS;                                                              // Setting number of slots...
+    head->slot_bytes = slot_bytes;                                                                  // Setting slot size...
+    head->frames.store (0, std::memory_order_relaxed);                                              // Resetting frames...
+
+    for(uint64_t k = 0; k < SNAPSHOT_SLOTS; k++)
+    {
+      new (at (k)) slot;                                                                            // Constructing slot...
+      at (k)->sequence.store (0, std::memory_order_relaxed);                                        // Resetting sequence...
+    }
+
+    head->magic.store (SNAPSHOT_MAGIC, std::memory_order_release);                                  // Opening ring...
+    std::signal (SIGINT, on_signal);                                                                // Catching interrupt...
+    std::signal (SIGTERM, on_signal);                                                               // Catching termination...
+    std::cout << "snapshot = serving \"" << name << "\" (" << SNAPSHOT_SLOTS << " slots, " << bytes << " B)"
+              << std::endl;                                                                         // Printing message...
+  }
+  else
+  {
+    if((bytes < header_bytes ()) || (head->magic.load (std::memory_order_acquire) != SNAPSHOT_MAGIC))
+    {
+      std::cout << "Error: snapshot ring \"" << name << "\" is not being served." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                     // Exiting...
+    }
+
+    if((head->nodes != loc_nodes) || (head->links != loc_links))
+    {
+      std::cout << "Error: snapshot ring \"" << name << "\" has " << head->nodes << " nodes and " << head->links
+                << " links, the viewer mesh has " << loc_nodes << " and " << loc_links << "." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                     // Exiting...
+    }
+
+    std::cout << "snapshot = viewing \"" << name << "\"" << std::endl;                              // Printing message...
+  }
+
+  start = std::chrono::steady_clock::now ();                                                        // Getting start time...
+}
+
+inline void snapshot::publish (
+                               size_t                                  loc_step,
+                               const std::vector<nu_float4_structure>& loc_position,
+                               const std::vector<nu_float4_structure>& loc_color
+                              )
+{
+  uint64_t             frame = head->frames.load (std::memory_order_relaxed);                       // Frame to publish.
+  slot*                s     = at (frame);                                                          // Slot.
+  nu_float4_structure* data  = (nu_float4_structure*)(s + 1);                                       // Slot data.
+
+  s->sequence.store (2*frame + 1, std::memory_order_relaxed);                                       // Opening slot...
+  std::atomic_thread_fence (std::memory_order_release);                                             // Ordering before data...
+  s->step = loc_step;                                                                               // Writing step...
+  std::memcpy (data, loc_position.data (), head->nodes*sizeof (nu_float4_structure));               // Writing positions...
+  std::memcpy (data + head->nodes, loc_color.data (), head->links*sizeof (nu_float4_structure));    // Writing colors...
+  s->sequence.store (2*frame + 2, std::memory_order_release);                                       // Closing slot...
+  head->frames.store (frame + 1, std::memory_order_release);                                        // Publishing frame...
+  copied++;                                                                                         // Counting frame...
+}
+
+inline bool snapshot::fetch (
+                             std::vector<nu_float4_structure>& loc_position,
+                             std::vector<nu_float4_structure>& loc_color
+                            )
+{
+  uint64_t             frames;                                                                      // Published frames.
+  uint64_t             sequence;                                                                    // Sequence before copy.
+  slot*                s;                                                                           // Slot.
+  nu_float4_structure* data;                                                                        // Slot data.
+
+  while((frames = head->frames.load (std::memory_order_acquire)) > seen)
+  {
+    s        = at (frames - 1);                                                                     // Getting latest slot...
+    data     = (nu_float4_structure*)(s + 1);                                                       // Getting slot data...
+    sequence = s->sequence.load (std::memory_order_acquire);                                        // Getting sequence...
+
+    if(sequence == 2*frames)
+    {
+      std::memcpy (loc_position.data (), data, head->nodes*sizeof (nu_float4_structure));           // Reading positions...
+      std::memcpy (loc_color.data (), data + head->nodes, head->links*sizeof (nu_float4_structure)); // Reading colors...
+      std::atomic_thread_fence (std::memory_order_acquire);                                         // Ordering after data...
+
+      if(s->sequence.load (std::memory_order_relaxed) == sequence)
+      {
+        skipped += frames - seen - 1;                                                               // Counting frames never shown...
+        seen     = frames;                                                                          // Setting last frame...
+        copied++;                                                                                   // Counting frame...
+
+        return true;
+      }
+    }
+
+    skipped++;                                                                                      // Counting retry (slot overwritten)...
+  }
+
+  return false;
+}
+
+inline bool snapshot::alive ()
+{
+  return head->magic.load (std::memory_order_acquire) == SNAPSHOT_MAGIC;
+}
+
+inline bool snapshot::interrupt ()
+{
+  return interrupted != 0;
+}
+
+inline void snapshot::report ()
+{
+  double t = std::chrono::duration<double>(std::chrono::steady_clock::now () - start).count ();     // Elapsed time [s].
+
+  if(server)
+  {
+    std::cout << "snapshot = " << copied << " frames published (" << copied/t << " frames/s)" << std::endl;
+  }
+  else
+  {
+    std::cout << "snapshot = " << copied << " frames shown (" << copied/t << " frames/s), " << skipped
+              << " skipped" << std::endl;
+  }
+}
+
+inline snapshot::~snapshot ()
+{
+  report ();                                                                                        // Printing report...
+
+  if(server)
+  {
+    head->magic.store (0, std::memory_order_release);                                               // Closing ring...
+  }
+
+#ifdef WIN32
+  UnmapViewOfFile (base);                                                                           // Unmapping view...
+  CloseHandle (mapping);                                                                            // Closing mapping...
+#else
+  munmap (base, bytes);                                                                             // Unmapping shared memory...
+
+  if(server)
+  {
+    shm_unlink (("/nu_" + name).c_str ());                                                          // Removing ring (viewers keep their mapping)...
+  }
+#endif
+}
+}
+
+#endif
@@ -0,0 +1,177 @@
+/// @file     specialization.hpp
+/// @brief    Compile-time specialization of OpenCL kernels.
+///
+/// @details  Neutrino kernels are built from a list of source files, without build options. The
+/// values to be specialized are therefore written as "#define" lines into a small generated
+/// source file, added as the first source of each specialized kernel: the effect is the same as
+/// passing them as "-D" build options. Floats are written as hexadecimal literals, so the
+/// compiled constants are bit-exact copies of the host values. The file name carries the process
+/// id, so that concurrent runs of the same example never overwrite each other's defines; the file
+/// is removed when the specialization is deleted.
+
+#ifndef specialization_hpp
+#define specialization_hpp
+
+// INCLUDES:
+#include "nu.hpp"                                                                                   // Neutrino header file.
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <system_error>
+
+#ifdef WIN32
+  #include <process.h>
+  #define SPECIALIZATION_PID _getpid ()                                                             // Process id.
+#else
+  #include <unistd.h>
+  #define SPECIALIZATION_PID getpid ()                                                              // Process id.
+#endif
+
+namespace ex
+{
+/// @class specialization
+/// @brief Set of "#define" values injected into kernel builds.
+class specialization
+{
+private:
+  std::string                        path;                                                          ///< Generated source file.
+  std::map<std::string, std::string> value;                                                         ///< Current defines.
+  std::map<std::string, std::string> built;                                                         ///< Defines of the last write.
+  bool                               written;                                                       ///< Source file written flag.
+
+  std::string literal (
+                       float loc_value                                                              ///< Value.
+                      );
+
+public:
+  /// @brief **Class constructor.**
+  /// @details The generated source file is placed in the system temporary directory, as
+  /// "<stem>_<pid><extension>" for the loc_name "<stem><extension>".
+  specialization (
+                  std::string loc_name                                                              ///< Generated source file name.
+                 );
+
+  /// @brief **Integer define.**
+  void        define (
+                      std::string loc_name,                                                         ///< Macro name.
+                      size_t      loc_value                                                         ///< Value.
+                     );
+
+  /// @brief **Float define.**
+  void        define (
+                      std::string loc_name,                                                         ///< Macro name.
+                      float       loc_value                                                         ///< Value.
+                     );
+
+  /// @brief **Float4 define.**
+  void        define (
+                      std::string         loc_name,                                                 ///< Macro name.
+                      nu_float4_structure loc_value                                                 ///< Value.
+                     );
+
+  /// @brief **Change query.**
+  /// @details Returns "true" if the defines differ from the ones of the last write (i.e. if the
+  /// specialized kernels must be rebuilt).
+  bool        changed ();
+
+  /// @brief **Source writer.**
+  /// @details Writes the generated source file and returns its path, to be added as the first
+  /// source of each specialized kernel. The file is not rewritten while the defines are unchanged.
+  /// The examples write all their files before the first build starts, as the builds run
+  /// concurrently (see startup.hpp); the later calls then only return the path.
+  std::string write ();
+
+  /// @brief **Class destructor.**
+  /// @details Removes the generated source file.
+  ~specialization ();
+};
+
+inline specialization::specialization (
+                                       std::string loc_name
+                                      )
+{
+  std::filesystem::path name (loc_name);                                                            // Generated source file name.
+
+  path = (std::filesystem::temp_directory_path ()/(name.stem ().string () + "_" +
+          std::to_string (SPECIALIZATION_PID) + name.extension ().string ())).string ();            // Setting source file path (per process)...
+  written = false;                                                                                  // Resetting written flag...
+}
+
+inline std::string specialization::literal (
+                                            float loc_value
+                                           )
+{
+  char buffer[64];                                                                                  // Literal buffer.
+
+  std::snprintf (buffer, sizeof (buffer), "%af", loc_value);                                        // Printing hexadecimal float...
+
+  return std::string ("(") + buffer + ")";
+}
+
+inline void specialization::define (
+                                    std::string loc_name,
+                                    size_t      loc_value
+                                   )
+{
+  value[loc_name] = std::to_string (loc_value);                                                     // Setting define...
+}
+
+inline void specialization::define (
+                                    std::string loc_name,
+                                    float       loc_value
+                                   )
+{
+  value[loc_name] = literal (loc_value);                                                            // Setting define...
+}
+
+inline void specialization::define (
+                                    std::string         loc_name,
+                                    nu_float4_structure loc_value
+                                   )
+{
+  value[loc_name] = "((float4)(" + literal (loc_value.x) + ", " + literal (loc_value.y) + ", " +
+                    literal (loc_value.z) + ", " + literal (loc_value.w) + "))";                    // Setting define...
+}
+
+inline bool specialization::changed ()
+{
+  return value != built;
+}
+
+inline std::string specialization::write ()
+{
+  std::ofstream file;                                                                               // Generated source file.
+
+  if(written && (value == built))
+  {
+    return path;                                                                                    // Keeping unchanged source file...
+  }
+
+  file.open (path);                                                                                 // Opening source file...
+  file << "/// @file     Generated kernel specialization: do not edit." << std::endl;
+
+  for(const auto& v : value)
+  {
+    file << "#define " << v.first << " " << v.second << std::endl;                                  // Writing define...
+  }
+
+  built   = value;                                                                                  // Setting built defines...
+  written = true;                                                                                   // Setting written flag...
+
+  return path;
+}
+
+inline specialization::~specialization ()
+{
+  std::error_code error;                                                                            // Removal error (ignored).
+
+  if(written)
+  {
+    std::filesystem::remove (path, error);                                                          // Removing source file...
+  }
+}
+}
+
+#endif
@@ -0,0 +1,270 @@
+/// @file     startup.hpp
+/// @brief    Concurrent startup pipeline with per-phase timing.
+///
+/// @details  The startup of an example is split into phases: mesh loading (gmsh parsing and
+/// neighbour list build), OpenCL program builds and the OpenGL shader build. Phases which do not
+/// depend on each other run at the same time: the mesh is loaded on a worker thread while the
+/// OpenGL and OpenCL contexts are created, and every OpenCL program is built on its own worker
+/// thread while the shader, which needs the OpenGL context, is built on the main thread. Each
+/// phase is joined only where its data is needed. The builds read the generated definition files
+/// (see specialization.hpp), so all of them are written before the first build starts, and no
+/// file is rewritten while a build runs. The start and end of each phase, the time it overlapped
+/// other phases, the marks set in between and the time to the first frame are printed, all
+/// measured from the construction. In "serial" mode every phase runs on the calling thread when
+/// started, which gives the timing of the plain sequential startup.
+
+#ifndef startup_hpp
+#define startup_hpp
+
+// INCLUDES:
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex
+{
+/// @class startup
+/// @brief Startup pipeline.
+/// @details Phases are identified by the index returned by run() and now().
+class startup
+{
+private:
+  /// @brief Startup phase.
+  struct phase
+  {
+    std::string         name;                                                                       ///< Phase name.
+    bool                worker;                                                                     ///< Worker thread flag.
+    double              begin;                                                                      ///< Phase start [s].
+    double              end;                                                                        ///< Phase end [s] (< 0 = running).
+    std::future<double> job;                                                                        ///< Worker job.
+  };
+
+  bool                                  serial;                                                     ///< Serial mode flag.
+  std::chrono::steady_clock::time_point origin;                                                     ///< Startup origin.
+  std::vector<phase>                    list;                                                       ///< Phases (and marks).
+  double                                first;                                                      ///< Time to first frame [s] (< 0 = none).
+
+  double clock ();
+  double overlap (
+                  size_t loc_phase                                                                  ///< Phase index.
+                 );
+
+public:
+  /// @brief **Class constructor.**
+  /// @details Starts the startup clock. The mode is "parallel" (default) or "serial".
+  startup (
+           std::string loc_mode                                                                     ///< Startup mode.
+          );
+
+  /// @brief **Worker phase.**
+  /// @details Starts the phase on a worker thread (on the calling thread in serial mode) and
+  /// returns its index. The phase must not use the OpenGL context.
+  size_t run (
+              std::string           loc_name,                                                       ///< Phase name.
+              std::function<void()> loc_phase                                                       ///< Phase function.
+             );
+
+  /// @brief **Main thread phase.**
+  /// @details Runs the phase on the calling thread (e.g. the shader build, which needs the
+  /// OpenGL context) and returns its index.
+  size_t now (
+              std::string           loc_name,                                                       ///< Phase name.
+              std::function<void()> loc_phase                                                       ///< Phase function.
+             );
+
+  /// @brief **Mark function.**
+  /// @details Records an instant (e.g. the end of the context creation).
+  void   mark (
+               std::string loc_name                                                                 ///< Mark name.
+              );
+
+  /// @brief **Join function.**
+  /// @details Waits for the end of a worker phase. Exceptions thrown by the phase are rethrown.
+  void   join (
+               size_t loc_phase                                                                     ///< Phase index.
+              );
+
+  /// @brief **Join function.**
+  /// @details Waits for the end of all worker phases.
+  void   join ();
+
+  /// @brief **Frame function.**
+  /// @details To be called at the end of each frame: the first call records the time to first
+  /// frame and prints the report, the later ones do nothing.
+  void   frame ();
+
+  /// @brief **Report function.**
+  /// @details Prints the phases in start order, with their thread, their duration and the time
+  /// during which at least one other phase was running, then the total phase time and the wall
+  /// time from the first phase start to the last phase end.
+  void   report ();
+};
+
+inline startup::startup (
+                         std::string loc_mode
+                        )
+{
+  if((loc_mode != "parallel") && (loc_mode != "serial"))
+  {
+    std::cout << "Error: unknown startup mode \"" << loc_mode << "\" (parallel or serial)." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  serial = (loc_mode == "serial");                                                                  // Setting serial mode flag...
+  origin = std::chrono::steady_clock::now ();                                                       // Setting startup origin...
+  first  = -1.0;                                                                                    // Resetting time to first frame...
+}
+
+inline double startup::clock ()
+{
+  return std::chrono::duration<double> (std::chrono::steady_clock::now () - origin).count ();
+}
+
+inline double startup::overlap (
+                                size_t loc_phase
+                               )
+{
+  std::vector<std::pair<double, double> > other;                                                    // Other phases (clipped).
+  double                                  b     = list[loc_phase].begin;                            // Phase start [s].
+  double                                  e     = list[loc_phase].end;                              // Phase end [s].
+  double                                  t     = 0.0;                                              // Overlap time [s].
+  double                                  reach = b;                                                // End of the covered time [s].
+  size_t                                  i;                                                        // Index [#].
+
+  for(i = 0; i < list.size (); i++)
+  {
+    if((i != loc_phase) && (list[i].begin < e) && (list[i].end > b))
+    {
+      other.push_back ({std::max (list[i].begin, b), std::min (list[i].end, e)});                   // Clipping other phase...
+    }
+  }
+
+  std::sort (other.begin (), other.end ());                                                         // Sorting by start...
+
+  for(i = 0; i < other.size (); i++)
+  {
+    if(other[i].second > reach)
+    {
+      t    += other[i].second - std::max (other[i].first, reach);                                   // Adding uncovered time...
+      reach = other[i].second;                                                                      // Extending covered time...
+    }
+  }
+
+  return t;
+}
+
+inline size_t startup::run (
+                            std::string           loc_name,
+                            std::function<void()> loc_phase
+                           )
+{
+  size_t index = list.size ();                                                                      // Phase index [#].
+
+  if(serial)
+  {
+    return now (loc_name, loc_phase);                                                               // Running phase on calling thread...
+  }
+
+  list.push_back ({loc_name, true, clock (), -1.0, std::future<double> ()});                        // Adding phase...
+  list[index].job = std::async (std::launch::async, [this, loc_phase] ()
+  {
+    loc_phase ();                                                                                   // Running phase...
+
+    return clock ();                                                                                // Returning phase end...
+  });
+
+  return index;
+}
+
+inline size_t startup::now (
+                            std::string           loc_name,
+                            std::function<void()> loc_phase
+                           )
+{
+  size_t index = list.size ();                                                                      // Phase index [#].
+  double begin = clock ();                                                                          // Phase start [s].
+
+  loc_phase ();                                                                                     // Running phase...
+  list.push_back ({loc_name, false, begin, clock (), std::future<double> ()});                      // Adding phase...
+
+  return index;
+}
+
+inline void startup::mark (
+                           std::string loc_name
+                          )
+{
+  double t = clock ();                                                                              // Mark time [s].
+
+  list.push_back ({loc_name, false, t, t, std::future<double> ()});                                 // Adding mark...
+}
+
+inline void startup::join (
+                           size_t loc_phase
+                          )
+{
+  if(list[loc_phase].job.valid ())
+  {
+    list[loc_phase].end = list[loc_phase].job.get ();                                               // Waiting for phase end...
+  }
+}
+
+inline void startup::join ()
+{
+  size_t i;                                                                                         // Index [#].
+
+  for(i = 0; i < list.size (); i++)
+  {
+    join (i);                                                                                       // Waiting for phase end...
+  }
+}
+
+inline void startup::frame ()
+{
+  if(first < 0.0)
+  {
+    first = clock ();                                                                               // Setting time to first frame...
+    report ();                                                                                      // Printing phases...
+  }
+}
+
+inline void startup::report ()
+{
+  size_t i;                                                                                         // Index [#].
+  double total = 0.0;                                                                               // Total phase time [s].
+  double b     = 0.0;                                                                               // First phase start [s].
+  double e     = 0.0;                                                                               // Last phase end [s].
+
+  join ();                                                                                          // Waiting for all phases...
+  std::cout << "startup (" << (serial ? "serial" : "parallel") << "):" << std::endl;                // Printing message...
+
+  for(i = 0; i < list.size (); i++)
+  {
+    std::printf ("  %-16s %8.3f -> %8.3f s (%.3f s, %s, overlap %.3f s)\n", list[i].name.c_str (),
+                 list[i].begin, list[i].end, list[i].end - list[i].begin,
+                 list[i].worker ? "worker" : "main", overlap (i));                                  // Printing phase...
+
+    if(list[i].end > list[i].begin)
+    {
+      b      = (total > 0.0) ? std::min (b, list[i].begin) : list[i].begin;                         // Getting first phase start...
+      e      = std::max (e, list[i].end);                                                           // Getting last phase end...
+      total += list[i].end - list[i].begin;                                                         // Adding phase time...
+    }
+  }
+
+  std::printf ("  %-16s %8.3f s in %.3f s wall\n", "phases", total, e - b);                         // Printing total and wall time...
+
+  if(first >= 0.0)
+  {
+    std::printf ("  %-16s %8.3f s\n", "first frame", first);                                        // Printing time to first frame...
+  }
+}
+}
+#endif
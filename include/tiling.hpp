@@ -0,0 +1,221 @@
+/// @file     tiling.hpp
+/// @brief    Regular grid detection for the work-group tiled force kernels.
+///
+/// @details  On a structured lattice the neighbours of each node are its grid neighbours, so the
+/// force kernel can run one work-item per grid cell, in grid order (x fastest): a work-group then
+/// covers a run of consecutive cells, and all the neighbours of its nodes lie within TILE_HALO
+/// cells of that run (one plane, one row and one cell, the 3x3x3 stencil). The work-group loads
+/// this tile of positions into local memory once, and each link reads its neighbour there through
+/// a stencil code (dx + 1) + 3*(dy + 1) + 9*(dz + 1) instead of a neighbour index and a global
+/// position. A mesh is tiled when its nodes form a full tensor grid (any spacing along each axis)
+/// and every link joins two cells of the same 3x3x3 stencil; the tile must fit in the local memory
+/// every device has (32 KiB) for the largest local size it is built for (TILE_LOCAL). Work-groups
+/// larger than TILE_LOCAL fall back to global reads.
+
+#ifndef tiling_hpp
+#define tiling_hpp
+
+// INCLUDES:
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ex
+{
+/// @class tiling
+/// @brief Regular grid of a mesh, with the cell of each node and the stencil code of each link.
+class tiling
+{
+public:
+  bool                       regular;                                                               ///< Regular grid flag.
+  size_t                     nx;                                                                    ///< Grid cells along "x" [#].
+  size_t                     ny;                                                                    ///< Grid cells along "y" [#].
+  size_t                     nz;                                                                    ///< Grid cells along "z" [#].
+  size_t                     halo;                                                                  ///< Tile halo on each side [cells].
+  std::vector<int>           node;                                                                  ///< Node of each grid cell (grid order).
+  std::vector<unsigned char> link;                                                                  ///< Stencil code of each link.
+  std::string                reason;                                                                ///< Why the mesh is not tiled ("" = tiled).
+
+  /// @brief **Class constructor.**
+  /// @details Detects the grid from the node positions (any array of 4 floats x, y, z, w) and the
+  /// neighbour lists, which must not be encoded yet (see topology.hpp).
+  template <class V>
+  tiling (
+          const std::vector<V>&   loc_position,                                                     ///< Node positions.
+          const std::vector<int>& loc_nearest,                                                      ///< Neighbour indices.
+          const std::vector<int>& loc_offset                                                        ///< Neighbour offsets.
+         );
+
+  /// @brief **Tile size.**
+  /// @details Returns the number of positions of a tile for a local size loc_local.
+  size_t                  span (
+                                size_t loc_local                                                    ///< Local size [#].
+                               );
+
+  /// @brief **Tile check.**
+  /// @details Tells whether the grid is regular and its tile, with loc_bytes per position, fits
+  /// in 32 KiB of local memory for a local size loc_local.
+  bool                    fits (
+                                size_t loc_local,                                                   ///< Local size [#].
+                                size_t loc_bytes                                                    ///< Position size [B].
+                               );
+
+  /// @brief **Code packing.**
+  /// @details Returns the stencil codes packed four to an int (in memory order, so that the
+  /// kernels can read the array as uchar).
+  std::vector<int>        pack ();
+
+  /// @brief **Report function.**
+  /// @details Prints the grid and tile size, or why the mesh is not tiled.
+  void                    report (
+                                  size_t loc_local                                                  ///< Local size [#].
+                                 );
+};
+
+template <class V>
+inline tiling::tiling (
+                       const std::vector<V>&   loc_position,
+                       const std::vector<int>& loc_nearest,
+                       const std::vector<int>& loc_offset
+                      )
+{
+  std::vector<float>  axis[3];                                                                      // Grid coordinates along each axis.
+  std::vector<size_t> index (3*loc_position.size ());                                               // Grid indices of each node.
+  std::vector<int>    cell (loc_position.size ());                                                  // Grid cell of each node.
+  const float*        p;                                                                            // Node coordinates (x, y, z, w).
+  float               tolerance;                                                                    // Coordinate tolerance [m].
+  size_t              i;                                                                            // Node index [#].
+  size_t              j = 0;                                                                        // Link index [#].
+  size_t              d;                                                                            // Axis index [#].
+  size_t              k;                                                                            // Coordinate index [#].
+  long                delta[3];                                                                     // Cell offset along each axis.
+
+  regular = false;                                                                                  // Resetting regular grid flag...
+  nx      = ny = nz = 1;                                                                            // Resetting grid size...
+  halo    = 0;                                                                                      // Resetting halo...
+
+  // FINDING GRID COORDINATES (distinct node coordinates along each axis):
+  for(d = 0; d < 3; d++)
+  {
+    for(i = 0; i < loc_position.size (); i++)
+    {
+      p = reinterpret_cast<const float*> (&loc_position[i]);                                        // Getting node coordinates...
+      axis[d].push_back (p[d]);                                                                     // Collecting coordinate...
+    }
+
+    std::sort (axis[d].begin (), axis[d].end ());                                                   // Sorting coordinates...
+    tolerance = axis[d].empty () ? 0.0f : 1e-5f*std::max (axis[d].back () - axis[d].front (), 1e-30f);
+    axis[d].erase (std::unique (axis[d].begin (), axis[d].end (), [tolerance] (float a, float b)
+    {
+      return std::fabs (b - a) <= tolerance;
+    }), axis[d].end ());                                                                            // Merging equal coordinates...
+
+    for(i = 0; i < loc_position.size (); i++)
+    {
+      p                = reinterpret_cast<const float*> (&loc_position[i]);                         // Getting node coordinates...
+      k                = std::lower_bound (axis[d].begin (), axis[d].end (), p[d] - tolerance) - axis[d].begin ();
+      index[3*i + d]   = std::min (k, axis[d].size () - 1);                                         // Setting grid index...
+    }
+  }
+
+  nx = axis[0].size ();                                                                             // Getting cells along "x"...
+  ny = axis[1].size ();                                                                             // Getting cells along "y"...
+  nz = axis[2].size ();                                                                             // Getting cells along "z"...
+
+  if(loc_position.empty () || (nx*ny*nz != loc_position.size ()))
+  {
+    reason = "nodes do not form a full tensor grid";                                                // Setting reason...
+    return;
+  }
+
+  // SETTING GRID CELLS (one node per cell):
+  node.assign (loc_position.size (), -1);                                                           // Resetting cells...
+
+  for(i = 0; i < loc_position.size (); i++)
+  {
+    cell[i] = int (index[3*i + 0] + nx*(index[3*i + 1] + ny*index[3*i + 2]));                       // Computing cell...
+
+    if(node[cell[i]] != -1)
+    {
+      reason = "two nodes share a grid cell";                                                       // Setting reason...
+      return;
+    }
+
+    node[cell[i]] = int (i);                                                                        // Setting node of cell...
+  }
+
+  // SETTING STENCIL CODES (neighbours within the 3x3x3 stencil):
+  link.resize (loc_nearest.size ());                                                                // Sizing stencil codes...
+
+  for(i = 0; i < loc_offset.size (); i++)
+  {
+    for(; j < size_t (loc_offset[i]); j++)
+    {
+      for(d = 0; d < 3; d++)
+      {
+        delta[d] = long (index[3*size_t (loc_nearest[j]) + d]) - long (index[3*i + d]);             // Computing cell offset...
+
+        if(std::labs (delta[d]) > 1)
+        {
+          reason = "links reach beyond the 3x3x3 stencil";                                          // Setting reason...
+          return;
+        }
+      }
+
+      link[j] = (unsigned char)((delta[0] + 1) + 3*(delta[1] + 1) + 9*(delta[2] + 1));              // Setting stencil code...
+    }
+  }
+
+  halo    = ((nz > 1) ? nx*ny : 0) + ((ny > 1) ? nx : 0) + 1;                                       // Setting halo (one plane, one row, one cell)...
+  regular = true;                                                                                   // Setting regular grid flag...
+}
+
+inline size_t tiling::span (
+                            size_t loc_local
+                           )
+{
+  return loc_local + 2*halo;
+}
+
+inline bool tiling::fits (
+                          size_t loc_local,
+                          size_t loc_bytes
+                         )
+{
+  if(regular && (span (loc_local)*loc_bytes > 32768))
+  {
+    reason = "tile exceeds 32 KiB of local memory";                                                 // Setting reason...
+  }
+
+  return regular && (span (loc_local)*loc_bytes <= 32768);
+}
+
+inline std::vector<int> tiling::pack ()
+{
+  std::vector<int> packed ((link.size () + 3)/4, 0);                                                // Packed codes.
+
+  std::memcpy (packed.data (), link.data (), link.size ());                                         // Packing codes...
+
+  return packed;
+}
+
+inline void tiling::report (
+                            size_t loc_local
+                           )
+{
+  if(reason == "")
+  {
+    std::cout << "tiling = " << nx << "x" << ny << "x" << nz << " grid (halo " << halo << " cells, tile "
+              << span (loc_local) << " positions)" << std::endl;                                    // Printing tiling...
+  }
+  else
+  {
+    std::cout << "tiling = off (" << reason << ")" << std::endl;                                    // Printing reason...
+  }
+}
+}
+
+#endif
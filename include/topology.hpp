@@ -0,0 +1,146 @@
+/// @file     topology.hpp
+/// @brief    Compact encoding of the neighbour lists.
+///
+/// @details  The links of the i-th node are [offset[i - 1], offset[i]) in the neighbour array:
+/// the central node of a link is implicit (it is "i"), so no per-link central array is needed.
+/// Neighbour indices are packed two per 32-bit word when they fit in 16 bits, either as they are
+/// (meshes with up to 65536 nodes) or, on request, as signed deltas from the central node (any
+/// mesh numbered so that linked nodes are close). The encoding is stored as the first and only
+/// element of the former "central" array, so that kernels and shaders decode the neighbour array
+/// accordingly (see "neighbour_index" in the examples' utilities.cl). Words are packed low half
+/// first, i.e. as an array of 16-bit values on little-endian devices.
+
+#ifndef topology_hpp
+#define topology_hpp
+
+// INCLUDES:
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ex
+{
+/// @brief Neighbour index encodings.
+enum encoding
+{
+  WIDE   = 0,                                                                                       ///< 32-bit indices.
+  NARROW = 1,                                                                                       ///< 16-bit indices.
+  DELTA  = 2                                                                                        ///< 16-bit signed deltas from the central node.
+};
+
+/// @class topology
+/// @brief Neighbour list encoding.
+class topology
+{
+public:
+  encoding mode;                                                                                    ///< Encoding.
+
+  /// @brief **Class constructor.**
+  /// @details Chooses the most compact encoding allowed by loc_request: "wide" (32-bit indices),
+  /// "delta" (16-bit deltas if they all fit, as "auto" otherwise) or "auto" (16-bit indices if
+  /// they all fit, 32-bit otherwise).
+  topology (
+            const std::vector<int>& loc_nearest,                                                    ///< Neighbour indices.
+            const std::vector<int>& loc_offset,                                                     ///< Neighbour offsets.
+            std::string             loc_request                                                     ///< Requested encoding.
+           );
+
+  /// @brief **Neighbour encoder.**
+  /// @details Packs the neighbour indices in place (no change for 32-bit indices).
+  void        encode (
+                      std::vector<int>&       loc_nearest,                                          ///< Neighbour indices.
+                      const std::vector<int>& loc_offset                                            ///< Neighbour offsets.
+                     );
+
+  /// @brief **Encoding name.**
+  /// @details Returns "wide", "narrow" or "delta".
+  std::string name ();
+
+  /// @brief **Encoding report.**
+  /// @details Prints the encoding and the edge topology memory (neighbour and encoding arrays),
+  /// compared with the former 32-bit neighbour and central arrays.
+  void        report (
+                      size_t loc_links                                                              ///< Number of links.
+                     );
+};
+
+inline topology::topology (
+                           const std::vector<int>& loc_nearest,
+                           const std::vector<int>& loc_offset,
+                           std::string             loc_request
+                          )
+{
+  bool   narrow = true;                                                                             // 16-bit indices flag.
+  bool   delta  = true;                                                                             // 16-bit deltas flag.
+  size_t j      = 0;                                                                                // Link index.
+  int    d;                                                                                         // Neighbour delta.
+
+  for(size_t i = 0; i < loc_offset.size (); i++)
+  {
+    for(; j < size_t (loc_offset[i]); j++)
+    {
+      d      = loc_nearest[j] - int (i);                                                            // Computing neighbour delta...
+      narrow = narrow && (loc_nearest[j] >= 0) && (loc_nearest[j] <= UINT16_MAX);                   // Checking 16-bit index...
+      delta  = delta && (d >= INT16_MIN) && (d <= INT16_MAX);                                       // Checking 16-bit delta...
+    }
+  }
+
+  mode = narrow ? NARROW : WIDE;                                                                    // Setting encoding...
+
+  if((loc_request == "delta") && delta)
+  {
+    mode = DELTA;                                                                                   // Setting delta encoding...
+  }
+
+  if(loc_request == "wide")
+  {
+    mode = WIDE;                                                                                    // Setting 32-bit encoding...
+  }
+}
+
+inline void topology::encode (
+                              std::vector<int>&       loc_nearest,
+                              const std::vector<int>& loc_offset
+                             )
+{
+  std::vector<int> packed ((loc_nearest.size () + 1)/2, 0);                                         // Packed indices.
+  size_t           j = 0;                                                                           // Link index.
+  uint32_t         half;                                                                            // 16-bit value.
+
+  if(mode == WIDE)
+  {
+    return;
+  }
+
+  for(size_t i = 0; i < loc_offset.size (); i++)
+  {
+    for(; j < size_t (loc_offset[i]); j++)
+    {
+      half         = uint16_t ((mode == DELTA) ? loc_nearest[j] - int (i) : loc_nearest[j]);        // Getting 16-bit value...
+      packed[j/2] |= int (half << (16*(j%2)));                                                      // Packing value...
+    }
+  }
+
+  loc_nearest = packed;                                                                             // Setting packed indices...
+}
+
+inline std::string topology::name ()
+{
+  const char* names[] = {"wide", "narrow", "delta"};
+
+  return names[mode];
+}
+
+inline void topology::report (
+                              size_t loc_links
+                             )
+{
+  size_t bytes = ((mode == WIDE) ? 4*loc_links : 4*((loc_links + 1)/2)) + 4;                        // Edge topology memory [B].
+
+  std::cout << "topology = " << name () << ", " << bytes << " B (was " << 8*loc_links << " B)"
+            << std::endl;                                                                           // Printing encoding...
+}
+}
+
+#endif
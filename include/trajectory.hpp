@@ -0,0 +1,561 @@
+/// @file     trajectory.hpp
+/// @brief    Asynchronous trajectory output to chunked, indexed and compressed files.
+///
+/// @details  Every k-th step the selected node arrays (e.g. position and velocity, float4 per node)
+/// are copied on the device into one pinned staging buffer of a double-buffered ring, which is then
+/// mapped without blocking: an event marks the completion of the map, so the application loop never
+/// waits for the device unless both staging buffers are still in flight. Mapped frames are handed to
+/// a background writer thread, which quantizes each component to a multiple of the array quantum,
+/// delta-encodes it against the previous frame of the same chunk and stores the deltas as zigzag
+/// varints. The first frame of each chunk is a keyframe (deltas against zero), so any frame is
+/// decoded from its chunk alone. File layout (little-endian):
+/// - header: "NUTRAJ01", nodes, arrays, frames per chunk (uint32) and one quantum per array (float);
+/// - chunks: frames (uint32), their steps (uint64), payload size (uint64) and payload;
+/// - index: one (file offset, first frame, frames) triple per chunk (uint64);
+/// - footer: index offset, number of chunks (uint64) and "NUTRJIDX".
+
+#ifndef trajectory_hpp
+#define trajectory_hpp
+
+// INCLUDES:
+#include "clhost.hpp"                                                                               // Raw OpenCL host context.
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define TRAJECTORY_RING   2                                                                         // Number of staging buffers in the readback ring.
+#define TRAJECTORY_QUEUE  16                                                                        // Maximum number of frames waiting for the writer.
+#define TRAJECTORY_CHUNK  32                                                                        // Number of frames per chunk.
+#define TRAJECTORY_MAGIC  "NUTRAJ01"                                                                // File magic.
+#define TRAJECTORY_FOOTER "NUTRJIDX"                                                                // Index magic.
+
+namespace ex
+{
+/// @class trajectory
+/// @brief Trajectory writer.
+/// @details When constructed with an empty path the writer is disabled and step () does nothing,
+/// so the same loop measures steps/s either way.
+class trajectory
+{
+private:
+  /// @brief Frame waiting to be written.
+  struct frame
+  {
+    uint64_t           step;                                                                        ///< Simulation step.
+    std::vector<float> value;                                                                       ///< Array values (array after array).
+  };
+
+  /// @brief Chunk index entry.
+  struct entry
+  {
+    uint64_t offset;                                                                                ///< Chunk file offset [B].
+    uint64_t first;                                                                                 ///< First frame of the chunk.
+    uint64_t frames;                                                                                ///< Frames in the chunk.
+  };
+
+  clhost*                 cl;                                                                       ///< OpenCL host context.
+  std::vector<cl_mem>     source;                                                                   ///< Device arrays.
+  std::vector<float>      quantum;                                                                  ///< Quantum of each array.
+  size_t                  nodes;                                                                    ///< Number of nodes.
+  size_t                  every;                                                                    ///< Output period [steps].
+  bool                    enabled;                                                                  ///< Output flag.
+  cl_mem                  staging[TRAJECTORY_RING];                                                 ///< Pinned staging ring (all arrays).
+  float*                  mapped[TRAJECTORY_RING];                                                  ///< Mapped staging pointers.
+  cl_event                ready[TRAJECTORY_RING];                                                   ///< Map events.
+  size_t                  ring_step[TRAJECTORY_RING];                                               ///< Readback steps.
+  size_t                  head;                                                                     ///< Next staging buffer to be filled.
+  size_t                  pending;                                                                  ///< Staging buffers being read back.
+  std::ofstream           file;                                                                     ///< Trajectory file.
+  std::vector<entry>      index;                                                                    ///< Chunk index.
+  std::deque<frame>       queue;                                                                    ///< Writer queue.
+  std::mutex              queue_mutex;                                                              ///< Writer queue mutex.
+  std::condition_variable queue_cv;                                                                 ///< Writer queue condition.
+  bool                    stop;                                                                     ///< Writer stop flag.
+  std::thread             writer;                                                                   ///< Writer thread.
+
+  void collect (
+                bool loc_wait                                                                       ///< Wait for the oldest staging buffer.
+               );
+  void write ();
+  void flush (
+              std::vector<uint64_t>&      loc_step,                                                 ///< Chunk steps.
+              std::vector<unsigned char>& loc_payload                                               ///< Chunk payload.
+             );
+
+public:
+  size_t frames;                                                                                    ///< Frames read back.
+  size_t stalls;                                                                                    ///< Steps that waited for the device or the writer.
+  size_t raw;                                                                                       ///< Uncompressed bytes (float).
+  size_t bytes;                                                                                     ///< Compressed bytes (chunks).
+
+  /// @brief **Class constructor.**
+  /// @details Creates the pinned staging ring, writes the file header and starts the writer
+  /// thread. Each source array holds one float4 per node.
+  trajectory (
+              clhost*             loc_cl,                                                           ///< OpenCL host context.
+              std::string         loc_path,                                                         ///< Trajectory file ("" = disabled).
+              std::vector<cl_mem> loc_source,                                                       ///< Device arrays (float4 per node).
+              std::vector<float>  loc_quantum,                                                      ///< Quantum of each array.
+              size_t              loc_nodes,                                                        ///< Number of nodes.
+              size_t              loc_every                                                         ///< Output period [steps].
+             );
+
+  /// @brief **Step function.**
+  /// @details To be called after enqueueing the kernels of each step: on output steps it
+  /// enqueues the copy and the map of the source arrays, then it collects the completed maps.
+  void step (
+             size_t loc_step                                                                        ///< Simulation step.
+            );
+
+  /// @brief **Closing function.**
+  /// @details Drains the staging ring, joins the writer thread, writes the last chunk, the index
+  /// and the footer. The counters are final afterwards.
+  void close ();
+
+  /// @brief **Class destructor.**
+  /// @details Closes the trajectory, if still open.
+  ~trajectory ();
+};
+
+/// @class trajectory_reader
+/// @brief Trajectory reader with random access to frames.
+class trajectory_reader
+{
+private:
+  /// @brief Chunk index entry.
+  struct entry
+  {
+    uint64_t offset;                                                                                ///< Chunk file offset [B].
+    uint64_t first;                                                                                 ///< First frame of the chunk.
+    uint64_t frames;                                                                                ///< Frames in the chunk.
+  };
+
+  std::ifstream         file;                                                                       ///< Trajectory file.
+  std::vector<entry>    index;                                                                      ///< Chunk index.
+  std::vector<uint64_t> steps;                                                                      ///< Frame steps.
+
+public:
+  uint32_t           nodes;                                                                         ///< Number of nodes.
+  uint32_t           arrays;                                                                        ///< Number of arrays.
+  std::vector<float> quantum;                                                                       ///< Quantum of each array.
+
+  /// @brief **Class constructor.**
+  /// @details Reads the header, the footer and the chunk index; exits on a malformed file.
+  trajectory_reader (
+                     std::string loc_path                                                           ///< Trajectory file.
+                    );
+
+  /// @brief **Number of frames.**
+  size_t   size ();
+
+  /// @brief **Frame step.**
+  uint64_t step (
+                 size_t loc_frame                                                                   ///< Frame.
+                );
+
+  /// @brief **Frame reader.**
+  /// @details Seeks to the chunk of loc_frame and decodes it up to loc_frame; returns the arrays
+  /// one after the other, 4 floats per node.
+  std::vector<float> read (
+                           size_t loc_frame                                                         ///< Frame.
+                          );
+};
+
+inline trajectory::trajectory (
+                               clhost*             loc_cl,
+                               std::string         loc_path,
+                               std::vector<cl_mem> loc_source,
+                               std::vector<float>  loc_quantum,
+                               size_t              loc_nodes,
+                               size_t              loc_every
+                              )
+{
+  cl_int   error;                                                                                   // OpenCL error code.
+  uint32_t field;                                                                                   // Header field.
+
+  cl      = loc_cl;                                                                                 // Setting OpenCL host context...
+  source  = loc_source;                                                                             // Setting device arrays...
+  quantum = loc_quantum;                                                                            // Setting quanta...
+  nodes   = loc_nodes;                                                                              // Setting number of nodes...
+  every   = (loc_every > 0) ? loc_every : 1;                                                        // Setting output period...
+  enabled = !loc_path.empty ();                                                                     // Setting output flag...
+  head    = 0;                                                                                      // Resetting ring head...
+  pending = 0;                                                                                      // Resetting ring count...
+  stop    = false;                                                                                  // Resetting stop flag...
+  frames  = 0;                                                                                      // Resetting frame counter...
+  stalls  = 0;                                                                                      // Resetting stall counter...
+  raw     = 0;                                                                                      // Resetting uncompressed size...
+  bytes   = 0;                                                                                      // Resetting compressed size...
+
+  if(enabled)
+  {
+    for(size_t r = 0; r < TRAJECTORY_RING; r++)
+    {
+      staging[r] = clCreateBuffer (cl->context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR,
+                                   source.size ()*nodes*sizeof (cl_float4), nullptr, &error);       // Creating pinned staging buffer...
+      check (error, "clCreateBuffer");
+      mapped[r] = nullptr;                                                                          // Resetting mapped pointer...
+    }
+
+    file.open (loc_path, std::ios::binary);                                                         // Opening trajectory file...
+
+    if(!file)
+    {
+      std::cout << "Error: cannot open trajectory file " << loc_path << "." << std::endl;
+      std::exit (EXIT_FAILURE);                                                                     // Exiting...
+    }
+
+    file.write (TRAJECTORY_MAGIC, 8);                                                               // Writing magic...
+    field = uint32_t (nodes);
+    file.write ((char*)&field, sizeof (field));                                                     // Writing number of nodes...
+    field = uint32_t (source.size ());
+    file.write ((char*)&field, sizeof (field));                                                     // Writing number of arrays...
+    field = TRAJECTORY_CHUNK;
+    file.write ((char*)&field, sizeof (field));                                                     // Writing frames per chunk...
+    file.write ((char*)quantum.data (), quantum.size ()*sizeof (float));                            // Writing quanta...
+
+    writer = std::thread (&trajectory::write, this);                                                // Starting writer thread...
+  }
+}
+
+inline void trajectory::step (
+                              size_t loc_step
+                             )
+{
+  cl_int error;                                                                                     // OpenCL error code.
+  size_t size = nodes*sizeof (cl_float4);                                                           // Array size [B].
+
+  if(!enabled)
+  {
+    return;
+  }
+
+  if(loc_step%every == 0)
+  {
+    if(pending == TRAJECTORY_RING)
+    {
+      stalls++;                                                                                     // Counting stall...
+      collect (true);                                                                               // Freeing oldest staging buffer (ring full)...
+    }
+
+    // STARTING ASYNCHRONOUS READBACK:
+    for(size_t a = 0; a < source.size (); a++)
+    {
+      check (clEnqueueCopyBuffer (cl->queue, source[a], staging[head], 0, a*size, size, 0, nullptr,
+                                  nullptr), "clEnqueueCopyBuffer");                                 // Copying array to staging buffer...
+    }
+
+    mapped[head]    = (float*)clEnqueueMapBuffer (cl->queue, staging[head], CL_FALSE, CL_MAP_READ, 0,
+                                                  source.size ()*size, 0, nullptr, &ready[head], &error);
+    check (error, "clEnqueueMapBuffer");
+    ring_step[head] = loc_step;                                                                     // Setting readback step...
+    head            = (head + 1)%TRAJECTORY_RING;                                                   // Advancing ring head...
+    pending++;                                                                                      // Counting pending staging buffers...
+    clFlush (cl->queue);                                                                            // Submitting readback...
+  }
+
+  collect (false);                                                                                  // Collecting completed maps...
+}
+
+inline void trajectory::collect (
+                                 bool loc_wait
+                                )
+{
+  size_t tail;                                                                                      // Oldest pending staging buffer.
+  cl_int status;                                                                                    // Map status.
+  frame  f;                                                                                         // Frame.
+
+  while(pending > 0)
+  {
+    tail = (head + TRAJECTORY_RING - pending)%TRAJECTORY_RING;                                      // Getting oldest staging buffer...
+
+    if(loc_wait)
+    {
+      check (clWaitForEvents (1, &ready[tail]), "clWaitForEvents");                                 // Waiting for map...
+    }
+
+    clGetEventInfo (ready[tail], CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof (status), &status, nullptr);
+
+    if(status != CL_COMPLETE)
+    {
+      break;                                                                                        // Not ready yet: trying next step...
+    }
+
+    clReleaseEvent (ready[tail]);                                                                   // Releasing map event...
+    f.step = ring_step[tail];                                                                       // Setting frame step...
+    f.value.assign (mapped[tail], mapped[tail] + 4*source.size ()*nodes);                           // Copying frame values...
+    check (clEnqueueUnmapMemObject (cl->queue, staging[tail], mapped[tail], 0, nullptr, nullptr),
+           "clEnqueueUnmapMemObject");                                                              // Unmapping staging buffer...
+
+    {
+      std::unique_lock<std::mutex> lock (queue_mutex);                                              // Locking writer queue...
+
+      if(queue.size () >= TRAJECTORY_QUEUE)
+      {
+        stalls++;                                                                                   // Counting stall (writer too slow)...
+        queue_cv.wait (lock, [this] {return queue.size () < TRAJECTORY_QUEUE;});                    // Waiting for writer...
+      }
+
+      queue.push_back (std::move (f));                                                              // Queueing frame...
+      queue_cv.notify_all ();                                                                       // Waking up writer...
+    }
+
+    frames++;                                                                                       // Counting frames...
+    raw += 4*source.size ()*nodes*sizeof (float);                                                   // Counting uncompressed bytes...
+    pending--;                                                                                      // Releasing staging buffer...
+    loc_wait = false;                                                                               // Waiting for one staging buffer at most...
+  }
+}
+
+inline void trajectory::write ()
+{
+  frame                      f;                                                                     // Frame.
+  std::vector<int64_t>       previous;                                                              // Previous quantized frame.
+  std::vector<uint64_t>      chunk_step;                                                            // Chunk steps.
+  std::vector<unsigned char> payload;                                                               // Chunk payload.
+  int64_t                    q;                                                                     // Quantized value.
+  uint64_t                   z;                                                                     // Zigzag delta.
+  size_t                     n;                                                                     // Values per array.
+
+  n = 4*nodes;                                                                                      // Getting values per array...
+
+  while(true)
+  {
+    {
+      std::unique_lock<std::mutex> lock (queue_mutex);                                              // Locking writer queue...
+      queue_cv.wait (lock, [this] {return stop || !queue.empty ();});                               // Waiting for frames...
+
+      if(queue.empty ())
+      {
+        break;                                                                                      // Stopping writer...
+      }
+
+      f = std::move (queue.front ());                                                               // Getting frame...
+      queue.pop_front ();                                                                           // Dequeueing frame...
+      queue_cv.notify_all ();                                                                       // Waking up producer...
+    }
+
+    if(chunk_step.empty ())
+    {
+      previous.assign (f.value.size (), 0);                                                         // Starting keyframe...
+    }
+
+    for(size_t i = 0; i < f.value.size (); i++)
+    {
+      q           = std::llround (f.value[i]/quantum[i/n]);                                         // Quantizing value...
+      z           = (uint64_t (q - previous[i]) << 1) ^ uint64_t ((q - previous[i]) >> 63);        // Zigzag-encoding delta...
+      previous[i] = q;                                                                              // Storing quantized value...
+
+      while(z >= 0x80)
+      {
+        payload.push_back ((unsigned char)(z | 0x80));                                              // Writing varint byte...
+        z >>= 7;
+      }
+
+      payload.push_back ((unsigned char)z);                                                         // Writing last varint byte...
+    }
+
+    chunk_step.push_back (f.step);                                                                  // Adding step...
+
+    if(chunk_step.size () == TRAJECTORY_CHUNK)
+    {
+      flush (chunk_step, payload);                                                                  // Writing chunk...
+    }
+  }
+
+  flush (chunk_step, payload);                                                                      // Writing last chunk...
+}
+
+inline void trajectory::flush (
+                               std::vector<uint64_t>&      loc_step,
+                               std::vector<unsigned char>& loc_payload
+                              )
+{
+  entry    e;                                                                                       // Chunk index entry.
+  uint32_t count = uint32_t (loc_step.size ());                                                     // Frames in the chunk.
+  uint64_t size  = loc_payload.size ();                                                             // Payload size [B].
+
+  if(count == 0)
+  {
+    return;
+  }
+
+  e.offset = uint64_t (file.tellp ());                                                              // Setting chunk offset...
+  e.first  = index.empty () ? 0 : index.back ().first + index.back ().frames;                       // Setting first frame...
+  e.frames = count;                                                                                 // Setting frames...
+  index.push_back (e);                                                                              // Indexing chunk...
+
+  file.write ((char*)&count, sizeof (count));                                                       // Writing frames...
+  file.write ((char*)loc_step.data (), count*sizeof (uint64_t));                                    // Writing steps...
+  file.write ((char*)&size, sizeof (size));                                                         // Writing payload size...
+  file.write ((char*)loc_payload.data (), size);                                                    // Writing payload...
+  bytes += sizeof (count) + count*sizeof (uint64_t) + sizeof (size) + size;                         // Counting compressed bytes...
+
+  loc_step.clear ();                                                                                // Clearing steps...
+  loc_payload.clear ();                                                                             // Clearing payload...
+}
+
+inline void trajectory::close ()
+{
+  uint64_t position;                                                                                // Index offset [B].
+  uint64_t count;                                                                                   // Number of chunks.
+
+  if(enabled)
+  {
+    while(pending > 0)
+    {
+      collect (true);                                                                               // Draining staging ring...
+    }
+
+    {
+      std::unique_lock<std::mutex> lock (queue_mutex);                                              // Locking writer queue...
+      stop = true;                                                                                  // Stopping writer...
+      queue_cv.notify_all ();                                                                       // Waking up writer...
+    }
+
+    writer.join ();                                                                                 // Waiting for writer...
+    clFinish (cl->queue);                                                                           // Waiting for unmaps...
+
+    position = uint64_t (file.tellp ());                                                            // Getting index offset...
+    count    = index.size ();                                                                       // Getting number of chunks...
+    file.write ((char*)index.data (), index.size ()*sizeof (entry));                                // Writing index...
+    file.write ((char*)&position, sizeof (position));                                               // Writing index offset...
+    file.write ((char*)&count, sizeof (count));                                                     // Writing number of chunks...
+    file.write (TRAJECTORY_FOOTER, 8);                                                              // Writing index magic...
+    file.close ();                                                                                  // Closing file...
+
+    for(size_t r = 0; r < TRAJECTORY_RING; r++)
+    {
+      clReleaseMemObject (staging[r]);                                                              // Releasing staging buffer...
+    }
+
+    enabled = false;                                                                                // Disabling output...
+  }
+}
+
+inline trajectory::~trajectory ()
+{
+  close ();                                                                                         // Closing trajectory...
+}
+
+inline trajectory_reader::trajectory_reader (
+                                             std::string loc_path
+                                            )
+{
+  char                  magic[8];                                                                   // Magic.
+  uint32_t              chunk;                                                                      // Frames per chunk.
+  uint64_t              position;                                                                   // Index offset [B].
+  uint64_t              count;                                                                      // Number of chunks.
+  uint32_t              frames;                                                                     // Frames in a chunk.
+  std::vector<uint64_t> chunk_step;                                                                 // Chunk steps.
+
+  file.open (loc_path, std::ios::binary);                                                           // Opening trajectory file...
+  file.read (magic, 8);                                                                             // Reading magic...
+
+  if(!file || (std::memcmp (magic, TRAJECTORY_MAGIC, 8) != 0))
+  {
+    std::cout << "Error: " << loc_path << " is not a trajectory file." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  file.read ((char*)&nodes, sizeof (nodes));                                                        // Reading number of nodes...
+  file.read ((char*)&arrays, sizeof (arrays));                                                      // Reading number of arrays...
+  file.read ((char*)&chunk, sizeof (chunk));                                                        // Reading frames per chunk...
+  quantum.resize (arrays);                                                                          // Sizing quanta...
+  file.read ((char*)quantum.data (), arrays*sizeof (float));                                        // Reading quanta...
+
+  file.seekg (-24, std::ios::end);                                                                  // Seeking footer...
+  file.read ((char*)&position, sizeof (position));                                                  // Reading index offset...
+  file.read ((char*)&count, sizeof (count));                                                        // Reading number of chunks...
+  file.read (magic, 8);                                                                             // Reading index magic...
+
+  if(!file || (std::memcmp (magic, TRAJECTORY_FOOTER, 8) != 0))
+  {
+    std::cout << "Error: " << loc_path << " has no index (unfinished trajectory)." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  index.resize (count);                                                                             // Sizing index...
+  file.seekg (position);                                                                            // Seeking index...
+  file.read ((char*)index.data (), count*sizeof (entry));                                           // Reading index...
+
+  for(const entry& e : index)
+  {
+    file.seekg (e.offset);                                                                          // Seeking chunk...
+    file.read ((char*)&frames, sizeof (frames));                                                    // Reading frames...
+    chunk_step.resize (frames);                                                                     // Sizing steps...
+    file.read ((char*)chunk_step.data (), frames*sizeof (uint64_t));                                // Reading steps...
+    steps.insert (steps.end (), chunk_step.begin (), chunk_step.end ());                            // Storing steps...
+  }
+}
+
+inline size_t trajectory_reader::size ()
+{
+  return steps.size ();
+}
+
+inline uint64_t trajectory_reader::step (
+                                         size_t loc_frame
+                                        )
+{
+  return steps[loc_frame];
+}
+
+inline std::vector<float> trajectory_reader::read (
+                                                   size_t loc_frame
+                                                  )
+{
+  std::vector<float>         value (4*size_t (nodes)*arrays);                                       // Frame values.
+  std::vector<int64_t>       q (value.size (), 0);                                                  // Quantized values.
+  std::vector<unsigned char> payload;                                                               // Chunk payload.
+  uint64_t                   size;                                                                  // Payload size [B].
+  size_t                     c = 0;                                                                 // Chunk.
+  size_t                     b = 0;                                                                 // Payload byte.
+  uint64_t                   z;                                                                     // Zigzag delta.
+  int                        shift;                                                                 // Varint shift.
+
+  while((c + 1 < index.size ()) && (index[c + 1].first <= loc_frame))
+  {
+    c++;                                                                                            // Finding chunk...
+  }
+
+  file.clear ();                                                                                    // Clearing stream state...
+  file.seekg (index[c].offset + sizeof (uint32_t) + index[c].frames*sizeof (uint64_t));             // Seeking payload size...
+  file.read ((char*)&size, sizeof (size));                                                          // Reading payload size...
+  payload.resize (size);                                                                            // Sizing payload...
+  file.read ((char*)payload.data (), size);                                                         // Reading payload...
+
+  for(size_t f = index[c].first; f <= loc_frame; f++)
+  {
+    for(size_t i = 0; i < q.size (); i++)
+    {
+      z     = 0;                                                                                    // Resetting delta...
+      shift = 0;                                                                                    // Resetting shift...
+
+      do
+      {
+        z     |= uint64_t (payload[b] & 0x7F) << shift;                                             // Reading varint byte...
+        shift += 7;
+      }
+      while(payload[b++] & 0x80);
+
+      q[i] += int64_t (z >> 1) ^ -int64_t (z & 1);                                                  // Decoding delta...
+    }
+  }
+
+  for(size_t i = 0; i < value.size (); i++)
+  {
+    value[i] = float (q[i])*quantum[i/(4*size_t (nodes))];                                          // Dequantizing value...
+  }
+
+  return value;
+}
+}
+
+#endif
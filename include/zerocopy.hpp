@@ -0,0 +1,460 @@
+/// @file     zerocopy.hpp
+/// @brief    Zero-copy OpenCL/OpenGL sharing for devices without CL/GL interoperability.
+///
+/// @details  With cl_khr_gl_sharing, Neutrino creates the plotted arrays (color, position) as
+/// OpenGL buffers shared with OpenCL. CPU OpenCL runtimes (e.g. pocl) next to Mesa OpenGL do not
+/// expose it, and every frame would then need a full readback and upload of those arrays. Here,
+/// each plotted array is instead allocated once as an immutable OpenGL buffer, mapped persistently
+/// and coherently (glBufferStorage), and the same host memory is wrapped as an OpenCL buffer
+/// (CL_MEM_USE_HOST_PTR) that replaces the Neutrino one as kernel argument. Nothing is copied:
+/// - before the kernels run, the host waits for the fence of the last draw that read the arrays;
+/// - after the kernels, a blocking map/unmap of each buffer makes the OpenCL results visible in
+///   the host memory, which OpenGL then reads directly through the coherent mapping.
+/// The path is chosen automatically when the device does not support cl_khr_gl_sharing (or when
+/// forced); otherwise every function is a no-op and Neutrino's interop is used as before. The
+/// devices are probed with probe () before Neutrino creates its OpenCL context, and the result is
+/// passed to the constructor as the interop flag. Neutrino itself takes no such flag: nu::opencl
+/// always asks for a context shared with the current OpenGL context.
+
+#ifndef zerocopy_hpp
+#define zerocopy_hpp
+
+// INCLUDES:
+#include "nu.hpp"                                                                                   // Neutrino header file.
+#include "clhost.hpp"                                                                               // OpenCL error check.
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define ZEROCOPY_TIMEOUT 1000000000                                                                 // Fence wait timeout [ns].
+
+namespace ex
+{
+/// @class zerocopy
+/// @brief Zero-copy shared arrays.
+class zerocopy
+{
+private:
+  /// @brief Shared array.
+  struct shared
+  {
+    size_t layout;                                                                                  ///< Layout index.
+    size_t bytes;                                                                                   ///< Size [B].
+    GLuint ssbo;                                                                                    ///< OpenGL buffer.
+    void*  host;                                                                                    ///< Persistent mapping.
+    cl_mem buffer;                                                                                  ///< OpenCL buffer (on the mapping).
+  };
+
+  bool                     enabled;                                                                 ///< Zero-copy flag.
+  cl_context               context;                                                                 ///< OpenCL context (Neutrino's).
+  cl_device_id             device;                                                                  ///< OpenCL device.
+  cl_command_queue         queue;                                                                   ///< Synchronization queue.
+  std::vector<shared>      array;                                                                   ///< Shared arrays.
+  GLsync                   fence;                                                                   ///< Last draw fence.
+
+  shared* find (
+                size_t       loc_layout                                                             ///< Layout index.
+               );
+  void*   map (
+               shared&      loc_array,                                                              ///< Shared array.
+               cl_map_flags loc_flags                                                               ///< Map flags.
+              );
+  void    unmap (
+                 shared&      loc_array,                                                            ///< Shared array.
+                 void*        loc_mapped                                                            ///< Mapped pointer.
+                );
+
+public:
+  /// @brief **Class constructor.**
+  /// @details Gets the OpenCL context and device from a built kernel and enables the zero-copy
+  /// path unless loc_interop is set (see probe ()) and the device of the context confirms
+  /// cl_khr_gl_sharing. It must be called after the OpenGL context has been created and after the
+  /// kernel has been built.
+  zerocopy (
+            nu::kernel* loc_kernel,                                                                 ///< Built kernel.
+            bool        loc_interop                                                                 ///< Interop flag (see probe ()).
+           );
+
+  /// @brief **Interop probe.**
+  /// @details Returns "true" if there is at least one OpenCL device of type loc_type and all of
+  /// them expose CL/GL sharing. To be called before the OpenCL context is created.
+  static bool probe (
+                     cl_device_type loc_type                                                        ///< Device type.
+                    );
+
+  /// @brief **Interop check.**
+  /// @details Returns "true" if the device exposes cl_khr_gl_sharing (or cl_APPLE_gl_sharing).
+  static bool interop (
+                       cl_device_id loc_device                                                      ///< OpenCL device.
+                      );
+
+  /// @brief **Zero-copy flag.**
+  bool active ();
+
+  /// @brief **Array sharing.**
+  /// @details Allocates the persistent mapping of the array at loc_layout, fills it with loc_data
+  /// and binds it as OpenGL shader storage buffer loc_layout.
+  template <class T>
+  void share (
+              size_t                loc_layout,                                                     ///< Layout index.
+              const std::vector<T>& loc_data                                                        ///< Initial data.
+             );
+
+  /// @brief **Kernel attachment.**
+  /// @details Sets the shared arrays as arguments of the kernels, replacing the Neutrino buffers.
+  /// To be called for all kernels again after cl->write (), which sets all the arguments.
+  void attach (
+               std::vector<nu::kernel*> loc_kernel                                                  ///< Kernels.
+              );
+
+  /// @brief **OpenCL handover.**
+  /// @details Waits until the last draw has read the shared arrays. To be called before the
+  /// kernels writing them.
+  void to_cl ();
+
+  /// @brief **OpenGL handover.**
+  /// @details Makes the kernel results visible to OpenGL and binds the shared arrays. To be
+  /// called after the kernels and before gl->plot ().
+  void to_gl ();
+
+  /// @brief **Draw fence.**
+  /// @details Marks the end of the draw reading the shared arrays. To be called after gl->plot ().
+  void drawn ();
+
+  /// @brief **Array writer.**
+  /// @details Copies host data into a shared array; without zero-copy, it calls
+  /// loc_cl->write (loc_layout).
+  template <class T>
+  void write (
+              nu::opencl*           loc_cl,                                                         ///< OpenCL context.
+              size_t                loc_layout,                                                     ///< Layout index.
+              const std::vector<T>& loc_data                                                        ///< Host data.
+             );
+
+  /// @brief **Array reader.**
+  /// @details Copies a shared array into host data; without zero-copy, it calls
+  /// loc_cl->read (loc_layout).
+  template <class T>
+  void read (
+             nu::opencl*     loc_cl,                                                                ///< OpenCL context.
+             size_t          loc_layout,                                                            ///< Layout index.
+             std::vector<T>& loc_data                                                               ///< Host data.
+            );
+
+  /// @brief **Sharing report.**
+  /// @details Prints the sharing path and the size of the shared arrays.
+  void report ();
+
+  /// @brief **Class destructor.**
+  /// @details Releases the OpenCL buffers and the mappings. It must be called before the OpenGL
+  /// and OpenCL contexts are deleted.
+  ~zerocopy ();
+};
+
+inline zerocopy::zerocopy (
+                           nu::kernel* loc_kernel,
+                           bool        loc_interop
+                          )
+{
+  cl_int error;                                                                                     // OpenCL error code.
+
+  fence = 0;                                                                                        // Resetting fence...
+  queue = nullptr;                                                                                  // Resetting queue...
+  check (clGetKernelInfo (loc_kernel->kernel_id, CL_KERNEL_CONTEXT, sizeof (cl_context), &context, nullptr),
+         "clGetKernelInfo");                                                                        // Getting context...
+  check (clGetContextInfo (context, CL_CONTEXT_DEVICES, sizeof (cl_device_id), &device, nullptr),
+         "clGetContextInfo");                                                                       // Getting (first) device...
+  enabled = !loc_interop || !interop (device);                                                      // Choosing sharing path...
+
+  if(enabled)
+  {
+    queue = clCreateCommandQueue (context, device, 0, &error);                                      // Creating synchronization queue...
+    check (error, "clCreateCommandQueue");
+  }
+}
+
+inline bool zerocopy::interop (
+                               cl_device_id loc_device
+                              )
+{
+  size_t            size;                                                                           // Parameter size.
+  std::vector<char> value;                                                                          // Parameter value.
+  std::string       extensions;                                                                     // Device extensions.
+
+  check (clGetDeviceInfo (loc_device, CL_DEVICE_EXTENSIONS, 0, nullptr, &size), "clGetDeviceInfo"); // Getting size...
+  value.resize (size);                                                                              // Sizing value...
+  check (clGetDeviceInfo (loc_device, CL_DEVICE_EXTENSIONS, size, value.data (), nullptr),
+         "clGetDeviceInfo");                                                                        // Getting value...
+  extensions = std::string (value.data ());                                                         // Setting extensions...
+
+  return (extensions.find ("cl_khr_gl_sharing") != std::string::npos) ||
+         (extensions.find ("cl_APPLE_gl_sharing") != std::string::npos);
+}
+
+inline bool zerocopy::probe (
+                             cl_device_type loc_type
+                            )
+{
+  cl_uint                     platforms = 0;                                                        // Number of platforms.
+  cl_uint                     devices;                                                              // Number of devices.
+  std::vector<cl_platform_id> platform;                                                             // Platforms.
+  std::vector<cl_device_id>   candidate;                                                            // Devices of one platform.
+  bool                        found     = false;                                                    // Device found flag.
+  bool                        sharing   = true;                                                     // CL/GL sharing flag.
+
+  if((clGetPlatformIDs (0, nullptr, &platforms) != CL_SUCCESS) || (platforms == 0))
+  {
+    return false;                                                                                   // No platform: no interop...
+  }
+
+  platform.resize (platforms);                                                                      // Sizing platforms...
+  check (clGetPlatformIDs (platforms, platform.data (), nullptr), "clGetPlatformIDs");              // Getting platforms...
+
+  for(cl_platform_id p : platform)
+  {
+    devices = 0;                                                                                    // Resetting number of devices...
+
+    if((clGetDeviceIDs (p, loc_type, 0, nullptr, &devices) != CL_SUCCESS) || (devices == 0))
+    {
+      continue;                                                                                     // Skipping platform without devices of the type...
+    }
+
+    candidate.resize (devices);                                                                     // Sizing devices...
+    check (clGetDeviceIDs (p, loc_type, devices, candidate.data (), nullptr), "clGetDeviceIDs");     // Getting devices...
+
+    for(cl_device_id d : candidate)
+    {
+      found   = true;                                                                               // Setting device found flag...
+      sharing = sharing && interop (d);                                                             // Checking CL/GL sharing...
+    }
+  }
+
+  return found && sharing;
+}
+
+inline bool zerocopy::active ()
+{
+  return enabled;
+}
+
+inline zerocopy::shared* zerocopy::find (
+                                         size_t loc_layout
+                                        )
+{
+  for(shared& a : array)
+  {
+    if(a.layout == loc_layout)
+    {
+      return &a;
+    }
+  }
+
+  std::cout << "Error: layout " << loc_layout << " is not a shared array." << std::endl;
+  std::exit (EXIT_FAILURE);                                                                         // Exiting...
+}
+
+inline void* zerocopy::map (
+                            shared&      loc_array,
+                            cl_map_flags loc_flags
+                           )
+{
+  cl_int error;                                                                                     // OpenCL error code.
+  void*  mapped;                                                                                    // Mapped pointer (the persistent mapping).
+
+  mapped = clEnqueueMapBuffer (queue, loc_array.buffer, CL_TRUE, loc_flags, 0, loc_array.bytes, 0,
+                               nullptr, nullptr, &error);                                           // Mapping buffer (host memory up to date)...
+  check (error, "clEnqueueMapBuffer");
+
+  return mapped;
+}
+
+inline void zerocopy::unmap (
+                             shared& loc_array,
+                             void*   loc_mapped
+                            )
+{
+  check (clEnqueueUnmapMemObject (queue, loc_array.buffer, loc_mapped, 0, nullptr, nullptr),
+         "clEnqueueUnmapMemObject");                                                                // Unmapping buffer (device memory up to date)...
+  check (clFinish (queue), "clFinish");                                                             // Waiting for unmap...
+}
+
+template <class T>
+inline void zerocopy::share (
+                             size_t                loc_layout,
+                             const std::vector<T>& loc_data
+                            )
+{
+  shared     a;                                                                                     // Shared array.
+  cl_int     error;                                                                                 // OpenCL error code.
+  GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+  if(!enabled)
+  {
+    return;
+  }
+
+  a.layout = loc_layout;                                                                            // Setting layout index...
+  a.bytes  = loc_data.size ()*sizeof (T);                                                           // Setting size...
+  glGenBuffers (1, &a.ssbo);                                                                        // Creating OpenGL buffer...
+  glBindBuffer (GL_SHADER_STORAGE_BUFFER, a.ssbo);                                                  // Binding OpenGL buffer...
+  glBufferStorage (GL_SHADER_STORAGE_BUFFER, a.bytes, loc_data.data (), flags);                     // Allocating immutable storage...
+  a.host   = glMapBufferRange (GL_SHADER_STORAGE_BUFFER, 0, a.bytes, flags);                        // Mapping storage persistently...
+  glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);                                                       // Unbinding OpenGL buffer...
+
+  if(a.host == nullptr)
+  {
+    std::cout << "Error: cannot map shared array " << loc_layout << " (OpenGL 4.4 required)." << std::endl;
+    std::exit (EXIT_FAILURE);                                                                       // Exiting...
+  }
+
+  a.buffer = clCreateBuffer (context, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, a.bytes, a.host, &error);
+  check (error, "clCreateBuffer");                                                                  // Wrapping mapping...
+  glBindBufferBase (GL_SHADER_STORAGE_BUFFER, GLuint (loc_layout), a.ssbo);                         // Binding shader storage...
+  array.push_back (a);                                                                              // Adding shared array...
+}
+
+inline void zerocopy::attach (
+                              std::vector<nu::kernel*> loc_kernel
+                             )
+{
+  if(!enabled)
+  {
+    return;
+  }
+
+  for(nu::kernel* K : loc_kernel)
+  {
+    for(shared& a : array)
+    {
+      check (clSetKernelArg (K->kernel_id, cl_uint (a.layout), sizeof (cl_mem), &a.buffer),
+             "clSetKernelArg");                                                                     // Replacing kernel argument...
+    }
+  }
+}
+
+inline void zerocopy::to_cl ()
+{
+  if(!enabled || (fence == 0))
+  {
+    return;
+  }
+
+  while(glClientWaitSync (fence, GL_SYNC_FLUSH_COMMANDS_BIT, ZEROCOPY_TIMEOUT) == GL_TIMEOUT_EXPIRED)
+  {
+    // Waiting for the draw reading the shared arrays...
+  }
+
+  glDeleteSync (fence);                                                                             // Deleting fence...
+  fence = 0;                                                                                        // Resetting fence...
+}
+
+inline void zerocopy::to_gl ()
+{
+  if(!enabled)
+  {
+    return;
+  }
+
+  for(shared& a : array)
+  {
+    unmap (a, map (a, CL_MAP_READ));                                                                // Publishing kernel results...
+    glBindBufferBase (GL_SHADER_STORAGE_BUFFER, GLuint (a.layout), a.ssbo);                         // Binding shader storage...
+  }
+
+  glMemoryBarrier (GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);                                            // Ordering host writes before the draw...
+}
+
+inline void zerocopy::drawn ()
+{
+  if(enabled)
+  {
+    fence = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);                                         // Setting draw fence...
+  }
+}
+
+template <class T>
+inline void zerocopy::write (
+                             nu::opencl*           loc_cl,
+                             size_t                loc_layout,
+                             const std::vector<T>& loc_data
+                            )
+{
+  shared* a;                                                                                        // Shared array.
+  void*   mapped;                                                                                   // Mapped pointer.
+
+  if(!enabled)
+  {
+    loc_cl->write (loc_layout);                                                                     // Writing OpenCL data...
+    return;
+  }
+
+  a = find (loc_layout);                                                                            // Getting shared array...
+  to_cl ();                                                                                         // Waiting for the last draw...
+  mapped = map (*a, CL_MAP_WRITE);                                                                  // Mapping shared array...
+  std::memcpy (mapped, loc_data.data (), a->bytes);                                                 // Writing host data...
+  unmap (*a, mapped);                                                                               // Publishing host data...
+}
+
+template <class T>
+inline void zerocopy::read (
+                            nu::opencl*     loc_cl,
+                            size_t          loc_layout,
+                            std::vector<T>& loc_data
+                           )
+{
+  shared* a;                                                                                        // Shared array.
+  void*   mapped;                                                                                   // Mapped pointer.
+
+  if(!enabled)
+  {
+    loc_cl->read (loc_layout);                                                                      // Reading OpenCL data...
+    return;
+  }
+
+  a = find (loc_layout);                                                                            // Getting shared array...
+  mapped = map (*a, CL_MAP_READ);                                                                   // Mapping shared array...
+  std::memcpy (loc_data.data (), mapped, a->bytes);                                                 // Reading kernel results...
+  unmap (*a, mapped);                                                                               // Unmapping shared array...
+}
+
+inline void zerocopy::report ()
+{
+  size_t bytes = 0;                                                                                 // Shared memory [B].
+
+  for(shared& a : array)
+  {
+    bytes += a.bytes;                                                                               // Summing shared memory...
+  }
+
+  if(enabled)
+  {
+    std::cout << "sharing = zero-copy (persistent mapping, " << bytes << " B)" << std::endl;        // Printing path...
+  }
+  else
+  {
+    std::cout << "sharing = interop (cl_khr_gl_sharing)" << std::endl;                              // Printing path...
+  }
+}
+
+inline zerocopy::~zerocopy ()
+{
+  to_cl ();                                                                                         // Waiting for the last draw...
+
+  for(shared& a : array)
+  {
+    clReleaseMemObject (a.buffer);                                                                  // Releasing OpenCL buffer...
+    glBindBuffer (GL_SHADER_STORAGE_BUFFER, a.ssbo);                                                // Binding OpenGL buffer...
+    glUnmapBuffer (GL_SHADER_STORAGE_BUFFER);                                                       // Unmapping storage...
+    glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);                                                     // Unbinding OpenGL buffer...
+    glDeleteBuffers (1, &a.ssbo);                                                                   // Deleting OpenGL buffer...
+  }
+
+  if(queue != nullptr)
+  {
+    clReleaseCommandQueue (queue);                                                                  // Releasing queue...
+  }
+}
+}
+
+#endif